@@ -0,0 +1,63 @@
+#ifndef BENCH_ALLOC_COUNTER_HPP
+#define BENCH_ALLOC_COUNTER_HPP
+
+#include <cstddef>
+
+namespace Bench {
+
+/**
+ * Heap usage through operator new / delete since the start of the program.
+ * It is only counted in programs linked with bench/alloc-hooks.cc, which replaces
+ *   the global operator new and delete (CMake defines BENCH_ALLOC_HOOKS for them,
+ *   a test gets them by linking benchmark_alloc).
+ * sjtu::deque and sjtu::map count their own nodes when built with SJTU_COUNT_ALLOCATIONS,
+ *   see include/alloc_stats.hpp.
+ */
+struct AllocStats {
+	size_t allocations = 0;
+	size_t deallocations = 0;
+	// requested by all the allocations, freed or not
+	size_t bytes = 0;
+	size_t live = 0;
+	// highest live since the last AllocResetPeak()
+	size_t peak = 0;
+};
+
+AllocStats AllocSnapshot();
+void AllocResetPeak();
+
+/**
+ * Usage of a region of code: allocations and bytes requested in it,
+ *   and the peak of live memory above the level at its start.
+ */
+class AllocScope {
+protected:
+	AllocStats start;
+public:
+	AllocScope()
+	{
+		AllocResetPeak();
+		start = AllocSnapshot();
+	}
+	size_t Allocations() const
+	{
+		return AllocSnapshot().allocations - start.allocations;
+	}
+	size_t Bytes() const
+	{
+		return AllocSnapshot().bytes - start.bytes;
+	}
+	size_t Peak() const
+	{
+		AllocStats now = AllocSnapshot();
+		return now.peak > start.live ? now.peak - start.live : 0;
+	}
+	// live bytes allocated in the scope and not freed yet
+	long Leaked() const
+	{
+		return static_cast<long>(AllocSnapshot().live) - static_cast<long>(start.live);
+	}
+};
+
+}
+#endif
@@ -0,0 +1,171 @@
+#include "alloc-counter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Replacement of the global operator new and delete counting every allocation.
+ * The size of each block is kept in a header in front of it, so the live and
+ *   peak figures do not depend on sized deallocation. With C++17 the over-aligned
+ *   operator new and delete are replaced too, their header is as long as the alignment.
+ */
+
+namespace {
+
+const size_t HEADER = alignof(std::max_align_t) > sizeof(size_t) ? alignof(std::max_align_t) : sizeof(size_t);
+
+std::atomic<size_t> allocations(0);
+std::atomic<size_t> deallocations(0);
+std::atomic<size_t> bytes(0);
+std::atomic<size_t> live(0);
+std::atomic<size_t> peak(0);
+
+void *Allocate(size_t size, size_t align = alignof(std::max_align_t))
+{
+	size_t header = align > HEADER ? align : HEADER;
+	char *base;
+	if (align > alignof(std::max_align_t)) {
+		// aligned_alloc wants a multiple of the alignment
+		base = static_cast<char *>(aligned_alloc(align, (size + header + align - 1) / align * align));
+	} else {
+		base = static_cast<char *>(malloc(size + header));
+	}
+	if (!base) {
+		return nullptr;
+	}
+	*reinterpret_cast<size_t *>(base) = size;
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	bytes.fetch_add(size, std::memory_order_relaxed);
+	size_t now = live.fetch_add(size, std::memory_order_relaxed) + size;
+	size_t high = peak.load(std::memory_order_relaxed);
+	while (now > high && !peak.compare_exchange_weak(high, now, std::memory_order_relaxed)) {}
+	return base + header;
+}
+
+void Release(void *p, size_t align = alignof(std::max_align_t))
+{
+	if (!p) {
+		return;
+	}
+	char *base = static_cast<char *>(p) - (align > HEADER ? align : HEADER);
+	deallocations.fetch_add(1, std::memory_order_relaxed);
+	live.fetch_sub(*reinterpret_cast<size_t *>(base), std::memory_order_relaxed);
+	free(base);
+}
+
+void *AllocateOrThrow(size_t size, size_t align = alignof(std::max_align_t))
+{
+	void *p = Allocate(size, align);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+}
+
+namespace Bench {
+
+AllocStats AllocSnapshot()
+{
+	AllocStats stats;
+	stats.allocations = allocations.load(std::memory_order_relaxed);
+	stats.deallocations = deallocations.load(std::memory_order_relaxed);
+	stats.bytes = bytes.load(std::memory_order_relaxed);
+	stats.live = live.load(std::memory_order_relaxed);
+	stats.peak = peak.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void AllocResetPeak()
+{
+	peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+}
+
+void *operator new(size_t size)
+{
+	return AllocateOrThrow(size);
+}
+void *operator new[](size_t size)
+{
+	return AllocateOrThrow(size);
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	return Allocate(size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return Allocate(size);
+}
+void operator delete(void *p) noexcept
+{
+	Release(p);
+}
+void operator delete[](void *p) noexcept
+{
+	Release(p);
+}
+void operator delete(void *p, size_t) noexcept
+{
+	Release(p);
+}
+void operator delete[](void *p, size_t) noexcept
+{
+	Release(p);
+}
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+	Release(p);
+}
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+	Release(p);
+}
+
+#ifdef __cpp_aligned_new
+void *operator new(size_t size, std::align_val_t align)
+{
+	return AllocateOrThrow(size, static_cast<size_t>(align));
+}
+void *operator new[](size_t size, std::align_val_t align)
+{
+	return AllocateOrThrow(size, static_cast<size_t>(align));
+}
+void *operator new(size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	return Allocate(size, static_cast<size_t>(align));
+}
+void *operator new[](size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	return Allocate(size, static_cast<size_t>(align));
+}
+void operator delete(void *p, std::align_val_t align) noexcept
+{
+	Release(p, static_cast<size_t>(align));
+}
+void operator delete[](void *p, std::align_val_t align) noexcept
+{
+	Release(p, static_cast<size_t>(align));
+}
+void operator delete(void *p, size_t, std::align_val_t align) noexcept
+{
+	Release(p, static_cast<size_t>(align));
+}
+void operator delete[](void *p, size_t, std::align_val_t align) noexcept
+{
+	Release(p, static_cast<size_t>(align));
+}
+void operator delete(void *p, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	Release(p, static_cast<size_t>(align));
+}
+void operator delete[](void *p, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	Release(p, static_cast<size_t>(align));
+}
+#endif
@@ -0,0 +1,139 @@
+#include "benchmark.hpp"
+#include "class-bint.hpp"
+
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const size_t N_SMALL = 10000;
+static const size_t N_ADD = 1000;
+static const size_t N_MUL = 10;
+
+/**
+ * The baseline: non-negative decimal numbers, one digit per int, least significant first.
+ */
+typedef std::vector<int> Decimal;
+
+Decimal ToDecimal(const std::string &s)
+{
+	return Decimal(s.rbegin(), s.rend());
+}
+
+Decimal Add(const Decimal &a, const Decimal &b)
+{
+	Decimal c(std::max(a.size(), b.size()) + 1);
+	int carry = 0;
+	for (size_t i = 0; i < c.size(); ++i) {
+		int x = carry + (i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+		c[i] = x % 10;
+		carry = x / 10;
+	}
+	return c;
+}
+
+Decimal Multiply(const Decimal &a, const Decimal &b)
+{
+	Decimal c(a.size() + b.size());
+	for (size_t i = 0; i < a.size(); ++i) {
+		int carry = 0;
+		for (size_t j = 0; j < b.size(); ++j) {
+			int x = c[i + j] + a[i] * b[j] + carry;
+			c[i + j] = x % 10;
+			carry = x / 10;
+		}
+		c[i + b.size()] += carry;
+	}
+	return c;
+}
+
+std::string RandomDigits(std::mt19937 &rng, size_t n)
+{
+	std::string s(n, '0');
+	for (char &c : s) {
+		c = '0' + rng() % 10;
+	}
+	s[0] = '1' + rng() % 9;
+	return s;
+}
+
+int main(int argc, char **argv)
+{
+	try {
+		Bench::Runner runner(argc, argv);
+		std::mt19937 rng(2017);
+
+		std::vector<long long> small(N_SMALL);
+		std::vector<Util::Bint> smallBint;
+		for (size_t i = 0; i < N_SMALL; ++i) {
+			small[i] = static_cast<long long>(rng() % 1000000000) * 1000000000 + rng() % 1000000000;
+			smallBint.push_back(Util::Bint(small[i]));
+		}
+		runner.Run("add, 18 digits", "long long", N_SMALL, [&] {
+			long long sum = 0;
+			for (long long x : small) {
+				sum += x;
+			}
+			Bench::DoNotOptimize(sum);
+		});
+		runner.Run("add, 18 digits", "Util::Bint", N_SMALL, [&] {
+			Util::Bint sum(0);
+			for (const Util::Bint &x : smallBint) {
+				sum = sum + x;
+			}
+			Bench::DoNotOptimize(sum);
+		});
+
+		for (size_t digits : {100, 1000}) {
+			std::string sa = RandomDigits(rng, digits), sb = RandomDigits(rng, digits);
+			Decimal da = ToDecimal(sa), db = ToDecimal(sb);
+			for (int &d : da) d -= '0';
+			for (int &d : db) d -= '0';
+			Util::Bint ba(sa), bb(sb);
+			std::string add = "add, " + std::to_string(digits) + " digits";
+			std::string mul = "multiply, " + std::to_string(digits) + " digits";
+			std::string print = "print, " + std::to_string(digits) + " digits";
+			runner.Run(add, "decimal baseline", N_ADD, [&] {
+				for (size_t i = 0; i < N_ADD; ++i) {
+					Bench::DoNotOptimize(Add(da, db));
+				}
+			});
+			runner.Run(add, "Util::Bint", N_ADD, [&] {
+				for (size_t i = 0; i < N_ADD; ++i) {
+					Bench::DoNotOptimize(ba + bb);
+				}
+			});
+			runner.Run(mul, "decimal baseline", N_MUL, [&] {
+				for (size_t i = 0; i < N_MUL; ++i) {
+					Bench::DoNotOptimize(Multiply(da, db));
+				}
+			});
+			runner.Run(mul, "Util::Bint", N_MUL, [&] {
+				for (size_t i = 0; i < N_MUL; ++i) {
+					Bench::DoNotOptimize(ba * bb);
+				}
+			});
+			runner.Run(print, "std::string copy", N_ADD, [&] {
+				for (size_t i = 0; i < N_ADD; ++i) {
+					std::ostringstream os;
+					os << sa;
+					Bench::DoNotOptimize(os.str());
+				}
+			});
+			runner.Run(print, "Util::Bint", N_ADD, [&] {
+				for (size_t i = 0; i < N_ADD; ++i) {
+					std::ostringstream os;
+					os << ba;
+					Bench::DoNotOptimize(os.str());
+				}
+			});
+		}
+		runner.Report(std::cout);
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
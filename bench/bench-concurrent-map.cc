@@ -0,0 +1,136 @@
+#include "benchmark.hpp"
+#include "concurrent_map.hpp"
+#include "map.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Throughput of a map shared by 1, 2, 4, ... --max-threads threads, for several shares of lookups:
+ *   sjtu::map behind one std::mutex, the baseline, against sjtu::concurrent_map.
+ * The OPS operations of a run are split between the threads, the time per operation
+ *   is the wall time of the run over OPS, so it should halve whenever the threads double
+ *   until they outnumber the cores of the machine.
+ * The writes alternate inserting and erasing random keys, so the map keeps about KEYS elements.
+ */
+
+static const size_t KEYS = 100000;
+static const size_t OPS = 400000;
+static int MaxThreads = 64;
+
+/**
+ * sjtu::map with every operation done under one lock, what a program would do without concurrent_map.
+ */
+class LockedMap {
+protected:
+	sjtu::map<int, int> m;
+	mutable std::mutex lock;
+public:
+	bool insert(int key, int value)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return m.insert(sjtu::pair<const int, int>(key, value)).second;
+	}
+	bool erase(int key)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		sjtu::map<int, int>::iterator it = m.find(key);
+		if (it == m.end()) {
+			return false;
+		}
+		m.erase(it);
+		return true;
+	}
+	bool find(int key, int &value) const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		const int *p = m.find_ptr(key);
+		if (!p) {
+			return false;
+		}
+		value = *p;
+		return true;
+	}
+};
+
+// one thread's share of a run, reads out of every 100 operations are lookups
+template<class Map>
+void Work(Map &m, size_t ops, int reads, uint32_t seed)
+{
+	uint32_t state = seed * 2654435761u + 1;
+	long sum = 0;
+	for (size_t i = 0; i < ops; ++i) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		int key = state % (2 * KEYS);
+		if (static_cast<int>(state >> 25) % 100 < reads) {
+			int value = 0;
+			sum += m.find(key, value) ? value : 0;
+		} else if (i % 2) {
+			m.insert(key, key);
+		} else {
+			m.erase(key);
+		}
+	}
+	Bench::DoNotOptimize(sum);
+}
+
+template<class Map>
+void Benchmarks(Bench::Runner &runner, const char *name, int reads)
+{
+	Map m;
+	for (size_t i = 0; i < KEYS; ++i) {
+		m.insert(2 * i, 2 * i);
+	}
+	for (int threads = 1; threads <= MaxThreads; threads *= 2) {
+		char group[64];
+		snprintf(group, sizeof(group), "read %d%% threads=%d", reads, threads);
+		runner.Run(group, name, OPS, [&] {
+			std::vector<std::thread> pool;
+			for (int t = 0; t < threads; ++t) {
+				pool.push_back(std::thread([&m, threads, reads, t] {
+					Work(m, OPS / threads, reads, t + 1);
+				}));
+			}
+			for (std::thread &t : pool) {
+				t.join();
+			}
+		});
+	}
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<char *> args = {argv[0]};
+	for (int i = 1; i < argc; ++i) {
+		std::string arg(argv[i]);
+		if (arg.compare(0, 14, "--max-threads=") == 0) {
+			// concurrent_map tells the threads apart in at most MAX_THREADS slots
+			MaxThreads = std::max(1, std::min(sjtu::concurrent_detail::MAX_THREADS, std::atoi(arg.c_str() + 14)));
+		} else {
+			args.push_back(argv[i]);
+		}
+	}
+	try {
+		Bench::Runner runner(args.size(), args.data());
+		if (runner.GetOptions().format == Bench::Format::TEXT) {
+			std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+		}
+		for (int reads : {100, 90, 50}) {
+			Benchmarks<LockedMap>(runner, "sjtu::map+mutex", reads);
+			Benchmarks<sjtu::concurrent_map<int, int>>(runner, "concurrent_map", reads);
+		}
+		runner.Report(std::cout);
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--max-threads=N] [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,88 @@
+#include "benchmark.hpp"
+#include "deque.hpp"
+
+#include <deque>
+#include <iostream>
+#include <random>
+
+static const size_t N = 100000;
+static const size_t N_INDEX = 1000;
+
+template<class Deque>
+void Benchmarks(Bench::Runner &runner, const char *name)
+{
+	Deque d;
+	runner.Run("push_back", name, N, [&] { d.clear(); }, [&] {
+		for (size_t i = 0; i < N; ++i) {
+			d.push_back(i);
+		}
+	});
+	runner.Run("push_front", name, N, [&] { d.clear(); }, [&] {
+		for (size_t i = 0; i < N; ++i) {
+			d.push_front(i);
+		}
+	});
+	runner.Run("iterate", name, N, [&] {
+		d.clear();
+		for (size_t i = 0; i < N; ++i) {
+			d.push_back(i);
+		}
+	}, [&] {
+		size_t sum = 0;
+		for (typename Deque::iterator it = d.begin(); it != d.end(); ++it) {
+			sum += *it;
+		}
+		Bench::DoNotOptimize(sum);
+	});
+	runner.Run("pop_front", name, N, [&] {
+		d.clear();
+		for (size_t i = 0; i < N; ++i) {
+			d.push_back(i);
+		}
+	}, [&] {
+		for (size_t i = 0; i < N; ++i) {
+			d.pop_front();
+		}
+	});
+	runner.Run("copy", name, N, [&] {
+		d.clear();
+		for (size_t i = 0; i < N; ++i) {
+			d.push_back(i);
+		}
+	}, [&] {
+		Deque copy(d);
+		Bench::DoNotOptimize(copy.size());
+	});
+	std::mt19937 rng(2017);
+	std::vector<size_t> positions(N_INDEX);
+	for (size_t &pos : positions) {
+		pos = rng() % N_INDEX;
+	}
+	runner.Run("random index, 1000 elements", name, N_INDEX, [&] {
+		d.clear();
+		for (size_t i = 0; i < N_INDEX; ++i) {
+			d.push_back(i);
+		}
+	}, [&] {
+		size_t sum = 0;
+		for (size_t pos : positions) {
+			sum += d[pos];
+		}
+		Bench::DoNotOptimize(sum);
+	});
+}
+
+int main(int argc, char **argv)
+{
+	try {
+		Bench::Runner runner(argc, argv);
+		Benchmarks<std::deque<size_t>>(runner, "std::deque");
+		Benchmarks<sjtu::deque<size_t>>(runner, "sjtu::deque");
+		runner.Report(std::cout);
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,99 @@
+#include "benchmark.hpp"
+#include "bplus_map.hpp"
+#include "flat_map.hpp"
+#include "map.hpp"
+
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+/**
+ * A table built once and then only queried, the case flat_map is meant for.
+ * The build of the node based maps inserts the elements one by one,
+ *   flat_map gets them as one batch. bench_flat_map_alloc reports the bytes per element of the build.
+ */
+
+static const size_t N = 500000;
+
+template<class Map>
+void Build(Map &m, const std::vector<std::pair<int, int>> &batch)
+{
+	for (const std::pair<int, int> &p : batch) {
+		m.insert(typename Map::value_type(p.first, p.second));
+	}
+}
+
+template<>
+void Build(sjtu::flat_map<int, int> &m, const std::vector<std::pair<int, int>> &batch)
+{
+	m.insert(batch.begin(), batch.end());
+}
+
+template<class Map>
+void Benchmarks(Bench::Runner &runner, const char *name, const std::vector<std::pair<int, int>> &batch,
+                const std::vector<int> &keys, const std::vector<int> &misses)
+{
+	Map m;
+	auto fill = [&] {
+		if (m.size() != N) {
+			m.clear();
+			Build(m, batch);
+		}
+	};
+	runner.Run("build", name, N, [&] { m.clear(); }, [&] {
+		Build(m, batch);
+	});
+	runner.Run("find hit", name, N, fill, [&] {
+		long sum = 0;
+		for (int key : keys) {
+			sum += m.find(key)->second;
+		}
+		Bench::DoNotOptimize(sum);
+	});
+	runner.Run("find miss", name, N, fill, [&] {
+		size_t found = 0;
+		for (int key : misses) {
+			found += m.count(key);
+		}
+		Bench::DoNotOptimize(found);
+	});
+	runner.Run("iterate", name, N, fill, [&] {
+		long sum = 0;
+		for (typename Map::iterator it = m.begin(); it != m.end(); ++it) {
+			sum += it->second;
+		}
+		Bench::DoNotOptimize(sum);
+	});
+}
+
+int main(int argc, char **argv)
+{
+	try {
+		Bench::Runner runner(argc, argv);
+		// distinct even keys in random order, and odd keys for the misses
+		std::vector<int> keys(N), misses(N);
+		for (size_t i = 0; i < N; ++i) {
+			keys[i] = 2 * i;
+			misses[i] = 2 * i + 1;
+		}
+		std::mt19937 rng(2017);
+		std::shuffle(keys.begin(), keys.end(), rng);
+		std::shuffle(misses.begin(), misses.end(), rng);
+		std::vector<std::pair<int, int>> batch(N);
+		for (size_t i = 0; i < N; ++i) {
+			batch[i] = std::make_pair(keys[i], keys[i]);
+		}
+		std::shuffle(keys.begin(), keys.end(), rng);
+		Benchmarks<std::map<int, int>>(runner, "std::map", batch, keys, misses);
+		Benchmarks<sjtu::map<int, int>>(runner, "sjtu::map", batch, keys, misses);
+		Benchmarks<sjtu::bplus_map<int, int>>(runner, "sjtu::bplus_map", batch, keys, misses);
+		Benchmarks<sjtu::flat_map<int, int>>(runner, "sjtu::flat_map", batch, keys, misses);
+		runner.Report(std::cout);
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
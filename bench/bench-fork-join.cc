@@ -0,0 +1,121 @@
+#include "benchmark.hpp"
+#include "class-matrix.hpp"
+#include "thread_pool.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+
+/**
+ * Recursive fork-join on sjtu::thread_pool with 1, 2, 4 and 8 workers against the serial code:
+ *   fib(FIB_N) forking down to FIB_CUTOFF, a test of the task overhead and of stealing,
+ *   and a MATRIX_N square multiply split in halves down to MATRIX_TILE tiles of the result,
+ *   each computed by Diamond::MultiplyAdd.
+ * The thread waiting for the root task works too, so a pool of n uses n + 1 threads.
+ */
+
+static const int FIB_N = 32;
+static const int FIB_CUTOFF = 18;
+static const size_t MATRIX_N = 512;
+static const size_t MATRIX_TILE = 128;
+static const size_t THREADS[] = {1, 2, 4, 8};
+
+static long Fib(int n)
+{
+	return n < 2 ? n : Fib(n - 1) + Fib(n - 2);
+}
+
+static long Fib(sjtu::thread_pool &pool, int n)
+{
+	if (n < FIB_CUTOFF) {
+		return Fib(n);
+	}
+	long a, b;
+	sjtu::thread_pool::task_group group(pool);
+	group.run([&] { a = Fib(pool, n - 1); });
+	b = Fib(pool, n - 2);
+	group.wait();
+	return a + b;
+}
+
+// c += a * b, halving the larger side of c until it is a tile, the tiles of c do not overlap
+static void Multiply(sjtu::thread_pool &pool, Diamond::MatrixView<double> c,
+                     Diamond::ConstMatrixView<double> a, Diamond::ConstMatrixView<double> b)
+{
+	const size_t rows = c.RowSize(), cols = c.ColSize(), k = a.ColSize();
+	if (rows <= MATRIX_TILE && cols <= MATRIX_TILE) {
+		Diamond::MultiplyAdd(c, a, b);
+		return;
+	}
+	sjtu::thread_pool::task_group group(pool);
+	if (rows >= cols) {
+		const size_t half = rows / 2;
+		group.run([&] {
+			Multiply(pool, c.SubMatrix(0, 0, half, cols), a.SubMatrix(0, 0, half, k), b);
+		});
+		Multiply(pool, c.SubMatrix(half, 0, rows - half, cols), a.SubMatrix(half, 0, rows - half, k), b);
+	} else {
+		const size_t half = cols / 2;
+		group.run([&] {
+			Multiply(pool, c.SubMatrix(0, 0, rows, half), a, b.SubMatrix(0, 0, k, half));
+		});
+		Multiply(pool, c.SubMatrix(0, half, rows, cols - half), a, b.SubMatrix(0, half, k, cols - half));
+	}
+	group.wait();
+}
+
+int main(int argc, char **argv)
+{
+	try {
+		Bench::Runner runner(argc, argv);
+		if (runner.GetOptions().format == Bench::Format::TEXT) {
+			std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+		}
+		char group[64];
+		snprintf(group, sizeof(group), "fib(%d)", FIB_N);
+		runner.Run(group, "serial", 1, [&] {
+			Bench::DoNotOptimize(Fib(FIB_N));
+		});
+		for (size_t threads : THREADS) {
+			sjtu::thread_pool pool(threads);
+			char name[64];
+			snprintf(name, sizeof(name), "thread_pool(%zu)", threads);
+			runner.Run(group, name, 1, [&] {
+				Bench::DoNotOptimize(Fib(pool, FIB_N));
+			});
+		}
+
+		std::mt19937 rng(2017);
+		std::uniform_real_distribution<double> uniform(-1, 1);
+		Diamond::Matrix<double> a(MATRIX_N, MATRIX_N), b(MATRIX_N, MATRIX_N), c(MATRIX_N, MATRIX_N, 0);
+		for (size_t i = 0; i < MATRIX_N; ++i) {
+			for (size_t j = 0; j < MATRIX_N; ++j) {
+				a[i][j] = uniform(rng);
+				b[i][j] = uniform(rng);
+			}
+		}
+		snprintf(group, sizeof(group), "multiply %zux%zu", MATRIX_N, MATRIX_N);
+		runner.Run(group, "serial", 1, [&] {
+			Diamond::Matrix<double> product = a * b;
+			Bench::DoNotOptimize(product[0][0]);
+		});
+		for (size_t threads : THREADS) {
+			sjtu::thread_pool pool(threads);
+			char name[64];
+			snprintf(name, sizeof(name), "thread_pool(%zu)", threads);
+			runner.Run(group, name, 1, [&] {
+				c = Diamond::Matrix<double>(MATRIX_N, MATRIX_N, 0);
+			}, [&] {
+				Multiply(pool, c.View(), a.View(), b.View());
+				Bench::DoNotOptimize(c[0][0]);
+			});
+		}
+		runner.Report(std::cout);
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
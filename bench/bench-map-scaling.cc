@@ -0,0 +1,258 @@
+#include "benchmark.hpp"
+#include "map.hpp"
+#include "bplus_map.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * insert, find, erase and iterate throughput of the maps from 1e3 keys up to --max-size,
+ *   for sequential, reverse, uniform random, Zipfian and clustered keys.
+ * Every pointer-based tree slows down once its nodes stop fitting in the caches,
+ *   the summary printed after the report shows where.
+ * The memory per entry is the heap requested per inserted key, it is only known
+ *   in bench_map_scaling_alloc, which counts the allocations.
+ */
+
+// up to 1e8 keys, the default stops at 1e6 as 1e8 needs about 10 GiB for the three maps
+static size_t MaxSize = 1000000;
+
+/**
+ * The keys in the order they are inserted (and erased), and the keys looked up by find.
+ * All the inserted keys are distinct, the lookups may repeat them.
+ */
+struct Workload {
+	std::vector<int> insert;
+	std::vector<int> lookup;
+};
+
+/**
+ * Zipf distribution over the ranks 0..n-1 with exponent theta < 1, by the approximation of
+ *   Gray et al., "Quickly generating billion-record synthetic databases", as in YCSB.
+ */
+class Zipf {
+protected:
+	size_t n;
+	double theta, alpha, zetan, eta;
+	std::uniform_real_distribution<double> uniform;
+public:
+	Zipf(size_t _n, double _theta) : n(_n), theta(_theta), alpha(1 / (1 - _theta)), zetan(0)
+	{
+		for (size_t i = 1; i <= n; ++i) {
+			zetan += 1 / std::pow(static_cast<double>(i), theta);
+		}
+		double zeta2 = 1 + 1 / std::pow(2.0, theta);
+		eta = (1 - std::pow(2.0 / n, 1 - theta)) / (1 - zeta2 / zetan);
+	}
+	template<typename _Tg>
+	size_t operator()(_Tg &rng)
+	{
+		double u = uniform(rng), uz = u * zetan;
+		if (uz < 1) {
+			return 0;
+		}
+		if (uz < 1 + std::pow(0.5, theta)) {
+			return 1;
+		}
+		return std::min(n - 1, static_cast<size_t>(n * std::pow(eta * u - eta + 1, alpha)));
+	}
+};
+
+// runs of CLUSTER consecutive even keys, the runs CLUSTER_STRIDE apart and visited in random order
+static const size_t CLUSTER = 64;
+static const int CLUSTER_STRIDE = 256;
+
+static std::vector<int> Clustered(size_t n, std::mt19937 &rng)
+{
+	std::vector<int> runs((n + CLUSTER - 1) / CLUSTER), keys;
+	for (size_t c = 0; c < runs.size(); ++c) {
+		runs[c] = c;
+	}
+	std::shuffle(runs.begin(), runs.end(), rng);
+	keys.reserve(n);
+	for (int c : runs) {
+		for (size_t j = 0; j < CLUSTER && static_cast<size_t>(c) * CLUSTER + j < n; ++j) {
+			keys.push_back(c * CLUSTER_STRIDE + 2 * j);
+		}
+	}
+	return keys;
+}
+
+static Workload MakeWorkload(const std::string &pattern, size_t n)
+{
+	std::mt19937 rng(2017);
+	Workload w;
+	w.insert.resize(n);
+	for (size_t i = 0; i < n; ++i) {
+		w.insert[i] = 2 * i;
+	}
+	if (pattern == "sequential") {
+		w.lookup = w.insert;
+	} else if (pattern == "reverse") {
+		std::reverse(w.insert.begin(), w.insert.end());
+		w.lookup = w.insert;
+	} else if (pattern == "uniform") {
+		std::shuffle(w.insert.begin(), w.insert.end(), rng);
+		w.lookup = w.insert;
+		std::shuffle(w.lookup.begin(), w.lookup.end(), rng);
+	} else if (pattern == "zipf") {
+		// the hottest ranks are spread over the key range
+		std::shuffle(w.insert.begin(), w.insert.end(), rng);
+		Zipf zipf(n, 0.99);
+		w.lookup.resize(n);
+		for (size_t i = 0; i < n; ++i) {
+			w.lookup[i] = w.insert[zipf(rng)];
+		}
+	} else {
+		w.insert = Clustered(n, rng);
+		w.lookup = Clustered(n, rng);
+	}
+	return w;
+}
+
+static std::string Group(const std::string &pattern, size_t n, const char *op)
+{
+	char group[64];
+	snprintf(group, sizeof(group), "%s n=%zu %s", pattern.c_str(), n, op);
+	return group;
+}
+
+template<class Map>
+void Benchmarks(Bench::Runner &runner, const char *name, const std::string &pattern, size_t n, const Workload &w)
+{
+	Map m;
+	// find, iterate and erase only rebuild the map when a previous benchmark emptied it
+	auto fill = [&] {
+		if (m.size() != n) {
+			m.clear();
+			for (int key : w.insert) {
+				m[key] = key;
+			}
+		}
+	};
+	runner.Run(Group(pattern, n, "insert"), name, n, [&] { m.clear(); }, [&] {
+		for (int key : w.insert) {
+			m.insert(typename Map::value_type(key, key));
+		}
+	});
+	runner.Run(Group(pattern, n, "find"), name, n, fill, [&] {
+		long sum = 0;
+		for (int key : w.lookup) {
+			sum += m.find(key)->second;
+		}
+		Bench::DoNotOptimize(sum);
+	});
+	runner.Run(Group(pattern, n, "iterate"), name, n, fill, [&] {
+		long sum = 0;
+		for (typename Map::iterator it = m.begin(); it != m.end(); ++it) {
+			sum += it->second;
+		}
+		Bench::DoNotOptimize(sum);
+	});
+	runner.Run(Group(pattern, n, "erase"), name, n, fill, [&] {
+		for (int key : w.insert) {
+			m.erase(m.find(key));
+		}
+	});
+}
+
+/**
+ * One line per map, pattern and size: millions of operations per second
+ *   and the bytes allocated per entry by the inserts.
+ */
+static void Summary(const Bench::Runner &runner, const std::vector<std::string> &patterns,
+                    const std::vector<size_t> &sizes, std::ostream &os)
+{
+	static const char *ops[] = {"insert", "find", "erase", "iterate"};
+	static const char *names[] = {"std::map", "sjtu::map", "sjtu::bplus_map"};
+	char line[256];
+	snprintf(line, sizeof(line), "\n%-15s %-11s %10s %10s %10s %10s %10s  %s", "map", "pattern", "n",
+	         "insert", "find", "erase", "iterate", "(Mops/s)  bytes/entry");
+	os << line << std::endl;
+	for (const char *name : names) {
+		for (const std::string &pattern : patterns) {
+			for (size_t n : sizes) {
+				bool any = false;
+				std::string row;
+				double bytes = -1;
+				for (const char *op : ops) {
+					const Bench::Result *res = nullptr;
+					for (const Bench::Result &r : runner.Results()) {
+						if (r.name == name && r.group == Group(pattern, n, op)) {
+							res = &r;
+						}
+					}
+					if (res && res->median > 0) {
+						snprintf(line, sizeof(line), " %10.2f", 1e3 / res->median);
+						any = true;
+						if (res->has_alloc && std::string(op) == "insert") {
+							bytes = res->bytes;
+						}
+					} else {
+						snprintf(line, sizeof(line), " %10s", "-");
+					}
+					row += line;
+				}
+				if (!any) {
+					continue;
+				}
+				snprintf(line, sizeof(line), "%-15s %-11s %10zu", name, pattern.c_str(), n);
+				os << line << row;
+				if (bytes >= 0) {
+					snprintf(line, sizeof(line), "  %21.1f", bytes);
+				} else {
+					snprintf(line, sizeof(line), "  %21s", "-");
+				}
+				os << line << std::endl;
+			}
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	// fewer repetitions than the other benchmarks, the largest sizes take seconds each
+	std::vector<char *> args = {argv[0], const_cast<char *>("--warmup=1"), const_cast<char *>("--reps=5")};
+	for (int i = 1; i < argc; ++i) {
+		std::string arg(argv[i]);
+		if (arg.compare(0, 11, "--max-size=") == 0) {
+			MaxSize = std::min(static_cast<size_t>(1e8), static_cast<size_t>(std::strtod(arg.c_str() + 11, nullptr)));
+		} else {
+			args.push_back(argv[i]);
+		}
+	}
+	try {
+		Bench::Runner runner(args.size(), args.data());
+		const std::vector<std::string> patterns = {"sequential", "reverse", "uniform", "zipf", "clustered"};
+		// 1, 3, 10, 30, ... thousand keys
+		std::vector<size_t> sizes;
+		for (size_t n = 1000; n <= MaxSize; n *= 10) {
+			sizes.push_back(n);
+			if (3 * n <= MaxSize) {
+				sizes.push_back(3 * n);
+			}
+		}
+		for (size_t n : sizes) {
+			for (const std::string &pattern : patterns) {
+				Workload w = MakeWorkload(pattern, n);
+				Benchmarks<std::map<int, int>>(runner, "std::map", pattern, n, w);
+				Benchmarks<sjtu::map<int, int>>(runner, "sjtu::map", pattern, n, w);
+				Benchmarks<sjtu::bplus_map<int, int>>(runner, "sjtu::bplus_map", pattern, n, w);
+			}
+		}
+		runner.Report(std::cout);
+		if (runner.GetOptions().format == Bench::Format::TEXT) {
+			Summary(runner, patterns, sizes, std::cout);
+		}
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--max-size=N] [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,109 @@
+#include "benchmark.hpp"
+#include "map.hpp"
+#include "bplus_map.hpp"
+#include "persistent_map.hpp"
+
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+static const size_t N = 100000;
+
+template<class Map>
+void Benchmarks(Bench::Runner &runner, const char *name, const std::vector<int> &keys, const std::vector<int> &misses)
+{
+	Map m;
+	auto fill = [&] {
+		m.clear();
+		for (int key : keys) {
+			m[key] = key;
+		}
+	};
+	runner.Run("insert random", name, N, [&] { m.clear(); }, [&] {
+		for (int key : keys) {
+			m.insert(typename Map::value_type(key, key));
+		}
+	});
+	runner.Run("operator[] random", name, N, [&] { m.clear(); }, [&] {
+		for (int key : keys) {
+			m[key] = key;
+		}
+	});
+	runner.Run("find hit", name, N, fill, [&] {
+		long sum = 0;
+		for (int key : keys) {
+			sum += m.find(key)->second;
+		}
+		Bench::DoNotOptimize(sum);
+	});
+	runner.Run("find miss", name, N, fill, [&] {
+		size_t found = 0;
+		for (int key : misses) {
+			found += m.find(key) != m.end();
+		}
+		Bench::DoNotOptimize(found);
+	});
+	runner.Run("iterate", name, N, fill, [&] {
+		long sum = 0;
+		for (typename Map::iterator it = m.begin(); it != m.end(); ++it) {
+			sum += it->second;
+		}
+		Bench::DoNotOptimize(sum);
+	});
+	runner.Run("erase", name, N, fill, [&] {
+		for (int key : keys) {
+			m.erase(m.find(key));
+		}
+	});
+	runner.Run("copy", name, N, fill, [&] {
+		Map copy(m);
+		Bench::DoNotOptimize(copy.size());
+	});
+}
+
+int main(int argc, char **argv)
+{
+	try {
+		Bench::Runner runner(argc, argv);
+		// distinct even keys in random order, and odd keys for the misses
+		std::vector<int> keys(N), misses(N);
+		for (size_t i = 0; i < N; ++i) {
+			keys[i] = 2 * i;
+			misses[i] = 2 * i + 1;
+		}
+		std::mt19937 rng(2017);
+		std::shuffle(keys.begin(), keys.end(), rng);
+		std::shuffle(misses.begin(), misses.end(), rng);
+		Benchmarks<std::map<int, int>>(runner, "std::map", keys, misses);
+		Benchmarks<sjtu::map<int, int>>(runner, "sjtu::map", keys, misses);
+		Benchmarks<sjtu::bplus_map<int, int>>(runner, "sjtu::bplus_map", keys, misses);
+		Benchmarks<sjtu::persistent_map<int, int>>(runner, "persistent_map", keys, misses);
+		// moving the upper half of a sjtu::map out and back, element by element against split() and join()
+		sjtu::map<int, int> whole;
+		for (int key : keys) {
+			whole[key] = key;
+		}
+		runner.Run("reshard half", "insert+erase", N, [&] {
+			sjtu::map<int, int> upper;
+			for (int key = N; key < 2 * (int)N; key += 2) {
+				upper[key] = whole.at(key);
+				whole.erase(whole.find(key));
+			}
+			for (int key = N; key < 2 * (int)N; key += 2) {
+				whole[key] = upper.at(key);
+			}
+		});
+		runner.Run("reshard half", "split+join", N, [&] {
+			sjtu::map<int, int> upper = whole.split(N);
+			whole.join(upper);
+			Bench::DoNotOptimize(whole.empty());
+		});
+		runner.Report(std::cout);
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,99 @@
+#include "benchmark.hpp"
+#include "class-matrix.hpp"
+#include "class-fixed-matrix.hpp"
+#include "class-sparse-matrix.hpp"
+#include "class-matrix-decomposition.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+static std::mt19937 rng(2017);
+
+Diamond::Matrix<double> RandomMatrix(size_t n, size_t m, double density = 1)
+{
+	std::uniform_real_distribution<double> value(-1, 1), coin(0, 1);
+	Diamond::Matrix<double> a(n, m, 0);
+	for (size_t i = 0; i < n; ++i) {
+		for (size_t j = 0; j < m; ++j) {
+			if (coin(rng) < density) {
+				a[i][j] = value(rng);
+			}
+		}
+	}
+	return a;
+}
+
+/**
+ * The baseline: the i-k-j triple loop over the same storage.
+ */
+Diamond::Matrix<double> NaiveMultiply(const Diamond::Matrix<double> &a, const Diamond::Matrix<double> &b)
+{
+	Diamond::Matrix<double> c(a.RowSize(), b.ColSize(), 0);
+	for (size_t i = 0; i < a.RowSize(); ++i) {
+		for (size_t k = 0; k < a.ColSize(); ++k) {
+			const double aik = a[i][k];
+			for (size_t j = 0; j < b.ColSize(); ++j) {
+				c[i][j] += aik * b[k][j];
+			}
+		}
+	}
+	return c;
+}
+
+int main(int argc, char **argv)
+{
+	try {
+		Bench::Runner runner(argc, argv);
+		for (size_t n : {64, 256}) {
+			Diamond::Matrix<double> a = RandomMatrix(n, n), b = RandomMatrix(n, n);
+			std::string group = "multiply " + std::to_string(n) + "x" + std::to_string(n);
+			runner.Run(group, "naive loop", 1, [&] {
+				Bench::DoNotOptimize(NaiveMultiply(a, b));
+			});
+			runner.Run(group, "Diamond::Matrix", 1, [&] {
+				Bench::DoNotOptimize(a * b);
+			});
+		}
+
+		const size_t N_SMALL = 10000;
+		Diamond::Matrix<double> a4 = RandomMatrix(4, 4), b4 = RandomMatrix(4, 4);
+		Diamond::FixedMatrix<double, 4, 4> fa4(a4), fb4(b4);
+		runner.Run("multiply 4x4", "Diamond::Matrix", N_SMALL, [&] {
+			for (size_t i = 0; i < N_SMALL; ++i) {
+				Bench::DoNotOptimize(a4 * b4);
+			}
+		});
+		runner.Run("multiply 4x4", "Diamond::FixedMatrix", N_SMALL, [&] {
+			for (size_t i = 0; i < N_SMALL; ++i) {
+				Bench::DoNotOptimize(fa4 * fb4);
+			}
+		});
+
+		for (double density : {0.001, 0.01}) {
+			Diamond::Matrix<double> s = RandomMatrix(400, 400, density), d = RandomMatrix(400, 400);
+			Diamond::SparseMatrix<double> sparse(s);
+			std::string group = "multiply 400x400, density " + std::to_string(density).substr(0, 5);
+			runner.Run(group, "dense", 1, [&] {
+				Bench::DoNotOptimize(s * d);
+			});
+			runner.Run(group, "Diamond::SparseMatrix", 1, [&] {
+				Bench::DoNotOptimize(sparse * d);
+			});
+		}
+
+		Diamond::Matrix<double> a = RandomMatrix(300, 300), x = RandomMatrix(300, 1);
+		runner.Run("solve 300x300", "Diamond::Inverse * b", 1, [&] {
+			Bench::DoNotOptimize(Diamond::Inverse(a) * x);
+		});
+		runner.Run("solve 300x300", "Diamond::LU", 1, [&] {
+			Bench::DoNotOptimize(Diamond::Solve(a, x));
+		});
+		runner.Report(std::cout);
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
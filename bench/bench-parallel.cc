@@ -0,0 +1,156 @@
+#include "benchmark.hpp"
+#include "deque.hpp"
+#include "map.hpp"
+#include "parallel.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * The parallel algorithms of parallel.hpp in a thread_pool of 1, 2, 4, ... --max-threads workers
+ *   against the serial loop over the iterators, the baseline, on a deque and a map of ELEMENTS:
+ *   for_each, a sum with reduce, a stable sort of random values and a sum over the map.
+ * Then building a map from a batch of ELEMENTS random entries, inserted one by one against
+ *   parallel::insert, and merging two maps of ELEMENTS / 2 random keys, inserting the elements
+ *   of one into the other against map::merge and parallel::merge.
+ * The time is per element, it should halve whenever the workers double until they outnumber the cores.
+ */
+
+static const size_t ELEMENTS = 1 << 20;
+static int MaxThreads = 8;
+
+static long Work(long x)
+{
+	return x * 3 + 1;
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<char *> args = {argv[0]};
+	for (int i = 1; i < argc; ++i) {
+		std::string arg(argv[i]);
+		if (arg.compare(0, 14, "--max-threads=") == 0) {
+			MaxThreads = std::max(1, std::atoi(arg.c_str() + 14));
+		} else {
+			args.push_back(argv[i]);
+		}
+	}
+	try {
+		Bench::Runner runner(args.size(), args.data());
+		if (runner.GetOptions().format == Bench::Format::TEXT) {
+			std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+		}
+		std::mt19937 rng(2017);
+		sjtu::deque<long> d;
+		sjtu::map<int, long> m;
+		std::vector<long> values;
+		for (size_t i = 0; i < ELEMENTS; ++i) {
+			d.push_back(i);
+			m[i] = i;
+			values.push_back(rng());
+		}
+		std::vector<sjtu::pair<int, long>> batch;
+		sjtu::map<int, long> half_a, half_b, into, from;
+		for (size_t i = 0; i < ELEMENTS; ++i) {
+			batch.push_back(sjtu::pair<int, long>(rng(), i));
+			(i % 2 ? half_a : half_b)[rng()] = i;
+		}
+		auto reset = [&] {
+			into = half_a;
+			from = half_b;
+		};
+		auto sum = [](long a, long b) { return a + b; };
+		auto mapped = [](const sjtu::pair<const int, long> &x) { return x.second; };
+		auto refill = [&] {
+			size_t i = 0;
+			for (long &x : d) {
+				x = values[i++];
+			}
+		};
+
+		runner.Run("deque for_each", "serial", ELEMENTS, [&] {
+			for (long &x : d) {
+				x = Work(x);
+			}
+		});
+		runner.Run("deque reduce", "serial", ELEMENTS, [&] {
+			long total = 0;
+			for (const long &x : d) {
+				total += x;
+			}
+			Bench::DoNotOptimize(total);
+		});
+		runner.Run("deque sort", "serial", ELEMENTS, refill, [&] {
+			std::vector<long> copy;
+			copy.reserve(ELEMENTS);
+			for (const long &x : d) {
+				copy.push_back(x);
+			}
+			std::stable_sort(copy.begin(), copy.end());
+			size_t i = 0;
+			for (long &x : d) {
+				x = copy[i++];
+			}
+		});
+		runner.Run("map reduce", "serial", ELEMENTS, [&] {
+			long total = 0;
+			for (sjtu::map<int, long>::const_iterator it = m.cbegin(); it != m.cend(); ++it) {
+				total += it->second;
+			}
+			Bench::DoNotOptimize(total);
+		});
+		runner.Run("map build", "serial insert", ELEMENTS, [&] {
+			sjtu::map<int, long> built;
+			for (const sjtu::pair<int, long> &x : batch) {
+				built.insert(sjtu::pair<const int, long>(x.first, x.second));
+			}
+			Bench::DoNotOptimize(built.size());
+		});
+		runner.Run("map merge", "serial insert", ELEMENTS, reset, [&] {
+			for (sjtu::map<int, long>::const_iterator it = from.cbegin(); it != from.cend(); ++it) {
+				into.insert(*it);
+			}
+		});
+		runner.Run("map merge", "map::merge", ELEMENTS, reset, [&] {
+			into.merge(from);
+		});
+		for (int threads = 1; threads <= MaxThreads; threads *= 2) {
+			sjtu::thread_pool pool(threads);
+			char name[64];
+			snprintf(name, sizeof(name), "parallel %d threads", threads);
+			runner.Run("deque for_each", name, ELEMENTS, [&] {
+				sjtu::parallel::for_each(pool, d, [](long &x) { x = Work(x); });
+			});
+			runner.Run("deque reduce", name, ELEMENTS, [&] {
+				Bench::DoNotOptimize(sjtu::parallel::reduce(pool, d, 0L, sum));
+			});
+			runner.Run("deque sort", name, ELEMENTS, refill, [&] {
+				sjtu::parallel::sort(pool, d);
+			});
+			runner.Run("map reduce", name, ELEMENTS, [&] {
+				Bench::DoNotOptimize(sjtu::parallel::transform_reduce(pool, m, 0L, sum, mapped));
+			});
+			runner.Run("map build", name, ELEMENTS, [&] {
+				sjtu::map<int, long> built;
+				sjtu::parallel::insert(pool, built, batch.begin(), batch.end());
+				Bench::DoNotOptimize(built.size());
+			});
+			runner.Run("map merge", name, ELEMENTS, reset, [&] {
+				sjtu::parallel::merge(pool, into, from);
+			});
+		}
+		runner.Report(std::cout);
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--max-threads=N] [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,143 @@
+#include "benchmark.hpp"
+#include "deque.hpp"
+#include "ring_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Elements handed from producer threads to consumer threads through a queue, for several
+ *   numbers of each: sjtu::deque behind a std::mutex, the baseline, against mpmc_queue
+ *   (and spsc_queue with one of each), pushing and popping one element or BATCH at a time.
+ * The time per element is the wall time of the run over ITEMS.
+ */
+
+static const size_t ITEMS = 200000;
+static const size_t CAPACITY = 1024;
+static const size_t BATCH = 32;
+
+/**
+ * The work queue the ring queues replace.
+ */
+class LockedDeque {
+protected:
+	sjtu::deque<size_t> d;
+	std::mutex lock;
+public:
+	explicit LockedDeque(size_t) {}
+	size_t try_push_batch(const size_t *first, size_t n)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		for (size_t i = 0; i < n; ++i) {
+			d.push_back(first[i]);
+		}
+		return n;
+	}
+	size_t try_pop_batch(size_t *out, size_t n)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		size_t i = 0;
+		while (i < n && d.try_pop_front(out[i])) {
+			++i;
+		}
+		return i;
+	}
+};
+
+template<class Queue>
+void Transfer(int producers, int consumers, size_t batch)
+{
+	Queue q(CAPACITY);
+	const size_t per_producer = ITEMS / producers;
+	const size_t total = per_producer * producers;
+	std::atomic<size_t> received(0);
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p) {
+		threads.push_back(std::thread([&q, &per_producer, batch, p] {
+			std::vector<size_t> buffer(batch);
+			for (size_t i = 0; i < per_producer; ) {
+				size_t n = std::min(batch, per_producer - i);
+				for (size_t j = 0; j < n; ++j) {
+					buffer[j] = p * per_producer + i + j;
+				}
+				for (size_t pushed = 0; pushed < n; ) {
+					size_t k = q.try_push_batch(buffer.data() + pushed, n - pushed);
+					if (!k) {
+						std::this_thread::yield();
+					}
+					pushed += k;
+				}
+				i += n;
+			}
+		}));
+	}
+	for (int c = 0; c < consumers; ++c) {
+		threads.push_back(std::thread([&q, &received, &total, batch] {
+			std::vector<size_t> buffer(batch);
+			size_t sum = 0;
+			while (received.load(std::memory_order_relaxed) < total) {
+				size_t k = q.try_pop_batch(buffer.data(), batch);
+				if (!k) {
+					std::this_thread::yield();
+					continue;
+				}
+				received += k;
+				for (size_t j = 0; j < k; ++j) {
+					sum += buffer[j];
+				}
+			}
+			Bench::DoNotOptimize(sum);
+		}));
+	}
+	for (std::thread &t : threads) {
+		t.join();
+	}
+}
+
+int main(int argc, char **argv)
+{
+	try {
+		Bench::Runner runner(argc, argv);
+		if (runner.GetOptions().format == Bench::Format::TEXT) {
+			std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+		}
+		const std::pair<int, int> configs[] = {{1, 1}, {1, 4}, {4, 1}, {2, 2}, {4, 4}, {8, 8}};
+		for (const std::pair<int, int> &config : configs) {
+			int producers = config.first, consumers = config.second;
+			char group[64];
+			snprintf(group, sizeof(group), "%d producers %d consumers", producers, consumers);
+			runner.Run(group, "sjtu::deque+mutex", ITEMS, [&] {
+				Transfer<LockedDeque>(producers, consumers, 1);
+			});
+			runner.Run(group, "deque+mutex batch", ITEMS, [&] {
+				Transfer<LockedDeque>(producers, consumers, BATCH);
+			});
+			runner.Run(group, "mpmc_queue", ITEMS, [&] {
+				Transfer<sjtu::mpmc_queue<size_t>>(producers, consumers, 1);
+			});
+			runner.Run(group, "mpmc_queue batch", ITEMS, [&] {
+				Transfer<sjtu::mpmc_queue<size_t>>(producers, consumers, BATCH);
+			});
+			if (producers == 1 && consumers == 1) {
+				runner.Run(group, "spsc_queue", ITEMS, [&] {
+					Transfer<sjtu::spsc_queue<size_t>>(producers, consumers, 1);
+				});
+				runner.Run(group, "spsc_queue batch", ITEMS, [&] {
+					Transfer<sjtu::spsc_queue<size_t>>(producers, consumers, BATCH);
+				});
+			}
+		}
+		runner.Report(std::cout);
+	} catch (std::invalid_argument &e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: " << argv[0] << " [--warmup=N] [--reps=N] [--format=text|json|csv] [--filter=SUBSTRING] [--perf] [--alloc]" << std::endl;
+		return 1;
+	}
+	return 0;
+}
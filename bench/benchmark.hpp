@@ -0,0 +1,399 @@
+#ifndef BENCH_BENCHMARK_HPP
+#define BENCH_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "perf-counters.hpp"
+#ifdef BENCH_ALLOC_HOOKS
+#include "alloc-counter.hpp"
+#endif
+
+namespace Bench {
+
+/**
+ * Keep the compiler from optimizing away a value, or the stores before a call.
+ */
+template<typename _Tv>
+inline void DoNotOptimize(const _Tv &value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+inline void ClobberMemory()
+{
+	asm volatile("" : : : "memory");
+}
+
+enum class Format { TEXT, JSON, CSV };
+
+struct Options {
+	size_t warmup = 2;
+	size_t reps = 15;
+	Format format = Format::TEXT;
+	// only the benchmarks whose "group/name" contains it are run
+	std::string filter;
+	// collect the PerfCounters events over the timed repetitions
+	bool perf = false;
+	// report the heap usage, on by default where the allocation hooks are linked
+#ifdef BENCH_ALLOC_HOOKS
+	bool alloc = true;
+#else
+	bool alloc = false;
+#endif
+};
+
+/**
+ * --warmup=N --reps=N --format=text|json|csv --filter=SUBSTRING --perf --alloc
+ */
+inline Options ParseOptions(int argc, char **argv)
+{
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg(argv[i]);
+		size_t eq = arg.find('=');
+		std::string key = arg.substr(0, eq), value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+		if (key == "--warmup") {
+			options.warmup = std::strtoul(value.c_str(), nullptr, 10);
+		} else if (key == "--reps") {
+			options.reps = std::max(static_cast<size_t>(1), static_cast<size_t>(std::strtoul(value.c_str(), nullptr, 10)));
+		} else if (key == "--perf" && eq == std::string::npos) {
+			options.perf = true;
+		} else if (key == "--alloc" && eq == std::string::npos) {
+			options.alloc = true;
+		} else if (key == "--filter") {
+			options.filter = value;
+		} else if (key == "--format" && value == "text") {
+			options.format = Format::TEXT;
+		} else if (key == "--format" && value == "json") {
+			options.format = Format::JSON;
+		} else if (key == "--format" && value == "csv") {
+			options.format = Format::CSV;
+		} else {
+			throw std::invalid_argument("unknown option " + arg);
+		}
+	}
+	return options;
+}
+
+/**
+ * Statistics of one benchmark over its repetitions, all in nanoseconds per operation.
+ */
+struct Result {
+	std::string group;
+	std::string name;
+	size_t ops = 0;
+	size_t reps = 0;
+	double median = 0;
+	double p95 = 0;
+	double mean = 0;
+	double stddev = 0;
+	double min = 0;
+	// one per timed repetition, in run order
+	std::vector<double> samples;
+	// events per operation, summed over the timed repetitions, if collected
+	bool has_counter[PERF_EVENTS] = {};
+	double counter[PERF_EVENTS] = {};
+	// heap usage of a repetition, if collected
+	bool has_alloc = false;
+	double allocations = 0;
+	double bytes = 0;
+	// highest live heap above the level before the repetition, over all of them
+	size_t peak_bytes = 0;
+};
+
+namespace Detail {
+
+inline std::string JsonString(const std::string &s)
+{
+	std::string res = "\"";
+	for (char c : s) {
+		if (c == '"' || c == '\\') {
+			res += '\\';
+		}
+		res += c;
+	}
+	return res + "\"";
+}
+
+inline std::string CsvString(const std::string &s)
+{
+	if (s.find_first_of(",\"") == std::string::npos) {
+		return s;
+	}
+	std::string res = "\"";
+	for (char c : s) {
+		if (c == '"') {
+			res += '"';
+		}
+		res += c;
+	}
+	return res + "\"";
+}
+
+inline void Summarize(std::vector<double> samples, Result &res)
+{
+	std::sort(samples.begin(), samples.end());
+	const size_t n = samples.size();
+	res.reps = n;
+	res.min = samples.front();
+	res.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+	// nearest rank
+	res.p95 = samples[std::min(n - 1, static_cast<size_t>(std::ceil(0.95 * n)) - 1)];
+	for (double x : samples) {
+		res.mean += x;
+	}
+	res.mean /= n;
+	for (double x : samples) {
+		res.stddev += (x - res.mean) * (x - res.mean);
+	}
+	res.stddev = n > 1 ? std::sqrt(res.stddev / (n - 1)) : 0;
+}
+
+}
+
+/**
+ * Runs benchmarks and collects their results.
+ * Every benchmark is run options.warmup times untimed, then options.reps times timed
+ *   with steady_clock, each repetition giving one ns/op sample.
+ * Benchmarks sharing a group are compared against the first one run in that group,
+ *   which is meant to be the std:: or baseline implementation.
+ */
+class Runner {
+protected:
+	Options options;
+	std::vector<Result> results;
+	std::unique_ptr<PerfCounters> perf;
+
+	void OpenCounters()
+	{
+#ifndef BENCH_ALLOC_HOOKS
+		if (options.alloc) {
+			std::cerr << "warning: built without the allocation hooks, --alloc is ignored" << std::endl;
+			options.alloc = false;
+		}
+#endif
+		if (!options.perf) {
+			return;
+		}
+		perf.reset(new PerfCounters());
+		if (!perf->AnyAvailable()) {
+			std::cerr << "warning: no performance counter is available, only timings are reported" << std::endl;
+		}
+	}
+public:
+	explicit Runner(const Options &_options) : options(_options)
+	{
+		OpenCounters();
+	}
+	Runner(int argc, char **argv) : options(ParseOptions(argc, argv))
+	{
+		OpenCounters();
+	}
+	const Options & GetOptions() const
+	{
+		return options;
+	}
+	const std::vector<Result> & Results() const
+	{
+		return results;
+	}
+	/**
+	 * setup() prepares a repetition and is not timed,
+	 *   body() is timed and must perform ops operations.
+	 */
+	template<typename _Ts, typename _Tb>
+	void Run(const std::string &group, const std::string &name, const size_t &ops, _Ts setup, _Tb body)
+	{
+		if ((group + "/" + name).find(options.filter) == std::string::npos) {
+			return;
+		}
+		for (size_t r = 0; r < options.warmup; ++r) {
+			setup();
+			body();
+		}
+		std::vector<double> samples;
+		samples.reserve(options.reps);
+		if (perf) {
+			perf->Reset();
+		}
+		Result res;
+		for (size_t r = 0; r < options.reps; ++r) {
+			setup();
+#ifdef BENCH_ALLOC_HOOKS
+			AllocScope scope;
+#endif
+			if (perf) {
+				perf->Start();
+			}
+			ClobberMemory();
+			auto start = std::chrono::steady_clock::now();
+			body();
+			ClobberMemory();
+			auto stop = std::chrono::steady_clock::now();
+			if (perf) {
+				perf->Stop();
+			}
+#ifdef BENCH_ALLOC_HOOKS
+			if (options.alloc) {
+				res.has_alloc = true;
+				res.allocations += 1.0 * scope.Allocations() / options.reps;
+				res.bytes += 1.0 * scope.Bytes() / options.reps;
+				res.peak_bytes = std::max(res.peak_bytes, scope.Peak());
+			}
+#endif
+			samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count() / std::max(ops, static_cast<size_t>(1)));
+		}
+		Detail::Summarize(samples, res);
+		res.samples = samples;
+		res.group = group;
+		res.name = name;
+		res.ops = ops;
+		res.allocations /= std::max(ops, static_cast<size_t>(1));
+		res.bytes /= std::max(ops, static_cast<size_t>(1));
+		for (size_t e = 0; perf && e < PERF_EVENTS; ++e) {
+			res.has_counter[e] = perf->Available(e);
+			res.counter[e] = 1.0 * perf->Total(e) / options.reps / std::max(ops, static_cast<size_t>(1));
+		}
+		results.push_back(res);
+	}
+	template<typename _Tb>
+	void Run(const std::string &group, const std::string &name, const size_t &ops, _Tb body)
+	{
+		Run(group, name, ops, [] {}, body);
+	}
+	/**
+	 * median of the first benchmark of the group divided by the median of res.
+	 */
+	double Speedup(const Result &res) const
+	{
+		for (const Result &base : results) {
+			if (base.group == res.group) {
+				return res.median > 0 ? base.median / res.median : 0;
+			}
+		}
+		return 0;
+	}
+	/**
+	 * The results with the members of each group together, groups in order of first appearance.
+	 */
+	std::vector<Result> Grouped() const
+	{
+		std::vector<Result> res;
+		for (size_t i = 0; i < results.size(); ++i) {
+			bool seen = false;
+			for (size_t j = 0; j < i && !seen; ++j) {
+				seen = results[j].group == results[i].group;
+			}
+			for (size_t j = i; j < results.size() && !seen; ++j) {
+				if (results[j].group == results[i].group) {
+					res.push_back(results[j]);
+				}
+			}
+		}
+		return res;
+	}
+	void Report(std::ostream &os) const
+	{
+		const std::vector<Result> results = Grouped();
+		char line[256];
+		if (options.format == Format::JSON) {
+			os << "{\"benchmarks\": [";
+			for (size_t i = 0; i < results.size(); ++i) {
+				const Result &r = results[i];
+				snprintf(line, sizeof(line), "\"ops\": %zu, \"reps\": %zu, \"median_ns\": %.4f, \"p95_ns\": %.4f, "
+				         "\"mean_ns\": %.4f, \"stddev_ns\": %.4f, \"min_ns\": %.4f, \"speedup\": %.4f",
+				         r.ops, r.reps, r.median, r.p95, r.mean, r.stddev, r.min, Speedup(r));
+				os << (i ? ",\n  " : "\n  ") << "{\"group\": " << Detail::JsonString(r.group)
+				   << ", \"name\": " << Detail::JsonString(r.name) << ", " << line;
+				for (size_t e = 0; options.perf && e < PERF_EVENTS; ++e) {
+					os << ", \"" << PerfEventName(e) << "_per_op\": ";
+					if (r.has_counter[e]) {
+						os << r.counter[e];
+					} else {
+						os << "null";
+					}
+				}
+				os << ", \"samples_ns\": [";
+				for (size_t k = 0; k < r.samples.size(); ++k) {
+					snprintf(line, sizeof(line), "%s%.4f", k ? ", " : "", r.samples[k]);
+					os << line;
+				}
+				os << "]";
+				if (options.alloc) {
+					os << ", \"allocations_per_op\": " << r.allocations << ", \"bytes_per_op\": " << r.bytes
+					   << ", \"peak_bytes\": " << r.peak_bytes;
+				}
+				os << "}";
+			}
+			os << "\n]}" << std::endl;
+		} else if (options.format == Format::CSV) {
+			os << "group,name,ops,reps,median_ns,p95_ns,mean_ns,stddev_ns,min_ns,speedup";
+			for (size_t e = 0; options.perf && e < PERF_EVENTS; ++e) {
+				os << "," << PerfEventName(e) << "_per_op";
+			}
+			if (options.alloc) {
+				os << ",allocations_per_op,bytes_per_op,peak_bytes";
+			}
+			os << std::endl;
+			for (const Result &r : results) {
+				snprintf(line, sizeof(line), "%zu,%zu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f",
+				         r.ops, r.reps, r.median, r.p95, r.mean, r.stddev, r.min, Speedup(r));
+				os << Detail::CsvString(r.group) << "," << Detail::CsvString(r.name) << "," << line;
+				for (size_t e = 0; options.perf && e < PERF_EVENTS; ++e) {
+					os << ",";
+					if (r.has_counter[e]) {
+						os << r.counter[e];
+					}
+				}
+				if (options.alloc) {
+					os << "," << r.allocations << "," << r.bytes << "," << r.peak_bytes;
+				}
+				os << std::endl;
+			}
+		} else {
+			snprintf(line, sizeof(line), "%-40s %12s %12s %9s %8s", "benchmark", "median ns/op", "p95 ns/op", "stddev", "speedup");
+			os << line;
+			for (size_t e = 0; options.perf && e < PERF_EVENTS; ++e) {
+				snprintf(line, sizeof(line), " %14s", PerfEventName(e));
+				os << line;
+			}
+			if (options.alloc) {
+				snprintf(line, sizeof(line), " %10s %12s %12s", "allocs/op", "bytes/op", "peak KiB");
+				os << line;
+			}
+			os << std::endl;
+			for (const Result &r : results) {
+				snprintf(line, sizeof(line), "%-40s %12.2f %12.2f %8.1f%% %7.2fx", (r.group + "/" + r.name).c_str(),
+				         r.median, r.p95, r.mean > 0 ? 100 * r.stddev / r.mean : 0, Speedup(r));
+				os << line;
+				for (size_t e = 0; options.perf && e < PERF_EVENTS; ++e) {
+					if (r.has_counter[e]) {
+						snprintf(line, sizeof(line), " %14.3f", r.counter[e]);
+					} else {
+						snprintf(line, sizeof(line), " %14s", "n/a");
+					}
+					os << line;
+				}
+				if (options.alloc) {
+					snprintf(line, sizeof(line), " %10.3f %12.1f %12.1f", r.allocations, r.bytes, r.peak_bytes / 1024.0);
+					os << line;
+				}
+				os << std::endl;
+			}
+			if (options.perf) {
+				os << "(events per operation, n/a where the counter is unavailable)" << std::endl;
+			}
+		}
+	}
+};
+
+}
+#endif
@@ -0,0 +1,141 @@
+#ifndef BENCH_PERF_COUNTERS_HPP
+#define BENCH_PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Bench {
+
+enum PerfEvent { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, PAGE_FAULTS, PERF_EVENTS };
+
+inline const char * PerfEventName(const size_t &event)
+{
+	static const char *names[PERF_EVENTS] = {"cycles", "instructions", "cache_misses", "branch_misses", "page_faults"};
+	return names[event];
+}
+
+/**
+ * Hardware and software counters of the calling thread, read through perf_event_open.
+ * The threads it starts after the counters are opened count into them too, so a
+ *   multithreaded benchmark has to create its threads once the Runner exists.
+ * Every event is opened on its own, so the ones the kernel or the machine does not
+ *   provide (no PMU in a VM, perf_event_paranoid, not Linux) are just unavailable
+ *   while the others still count.
+ */
+class PerfCounters {
+protected:
+	int fd[PERF_EVENTS];
+	uint64_t start[PERF_EVENTS];
+	uint64_t total[PERF_EVENTS];
+
+	uint64_t Read(const size_t &event) const
+	{
+		uint64_t value = 0;
+#ifdef __linux__
+		if (read(fd[event], &value, sizeof(value)) != sizeof(value)) {
+			value = 0;
+		}
+#endif
+		return value;
+	}
+public:
+	PerfCounters()
+	{
+		for (size_t e = 0; e < PERF_EVENTS; ++e) {
+			fd[e] = -1;
+			start[e] = total[e] = 0;
+		}
+#ifdef __linux__
+		static const uint32_t types[PERF_EVENTS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+		                                            PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE};
+		static const uint64_t configs[PERF_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		                                              PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+		                                              PERF_COUNT_SW_PAGE_FAULTS};
+		for (size_t e = 0; e < PERF_EVENTS; ++e) {
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = types[e];
+			attr.config = configs[e];
+			attr.disabled = 1;
+			attr.inherit = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			fd[e] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+		}
+#endif
+	}
+	PerfCounters(const PerfCounters &) = delete;
+	PerfCounters & operator=(const PerfCounters &) = delete;
+	~PerfCounters()
+	{
+#ifdef __linux__
+		for (size_t e = 0; e < PERF_EVENTS; ++e) {
+			if (fd[e] >= 0) {
+				close(fd[e]);
+			}
+		}
+#endif
+	}
+	bool Available(const size_t &event) const
+	{
+		return fd[event] >= 0;
+	}
+	bool AnyAvailable() const
+	{
+		for (size_t e = 0; e < PERF_EVENTS; ++e) {
+			if (Available(e)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	/**
+	 * Forget the counts accumulated so far.
+	 */
+	void Reset()
+	{
+		for (size_t e = 0; e < PERF_EVENTS; ++e) {
+			total[e] = 0;
+		}
+	}
+	void Start()
+	{
+#ifdef __linux__
+		for (size_t e = 0; e < PERF_EVENTS; ++e) {
+			if (Available(e)) {
+				start[e] = Read(e);
+				ioctl(fd[e], PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+#endif
+	}
+	/**
+	 * Add the counts since the last Start() to the totals.
+	 */
+	void Stop()
+	{
+#ifdef __linux__
+		for (size_t e = 0; e < PERF_EVENTS; ++e) {
+			if (Available(e)) {
+				ioctl(fd[e], PERF_EVENT_IOC_DISABLE, 0);
+				total[e] += Read(e) - start[e];
+			}
+		}
+#endif
+	}
+	uint64_t Total(const size_t &event) const
+	{
+		return total[event];
+	}
+};
+
+}
+#endif
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Performance regression runner for the bench_* targets.
+
+    regress.py record  --build-dir BUILD   run the benchmarks, store them as this machine's baseline
+    regress.py compare --build-dir BUILD   run them again and report the changes against the baseline
+
+Baselines are kept per machine in bench/baselines/<machine>.json, the machine being
+the host name, the CPU model and the build type, since timings from different
+machines or builds cannot be compared.
+
+A benchmark is reported as a slowdown when its median grew by more than
+--threshold and a Mann-Whitney U test on the per-repetition samples rejects
+"no change" at --alpha. The allocation counts of the bench_*_alloc targets are
+deterministic, any increase of allocations or bytes per operation is reported.
+compare exits with 1 if anything regressed.
+"""
+
+import argparse
+import json
+import math
+import os
+import platform
+import re
+import subprocess
+import sys
+
+BENCHMARKS = ["bench_deque", "bench_map", "bench_bint", "bench_matrix"]
+BASELINE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "baselines")
+
+
+def cpu_model():
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    return line.split(":", 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor() or platform.machine()
+
+
+def build_type(build_dir):
+    try:
+        with open(os.path.join(build_dir, "CMakeCache.txt")) as f:
+            for line in f:
+                if line.startswith("CMAKE_BUILD_TYPE:"):
+                    return line.split("=", 1)[1].strip() or "None"
+    except OSError:
+        pass
+    return "unknown"
+
+
+def machine_id(build_dir):
+    raw = "%s-%s-%s" % (platform.node(), cpu_model(), build_type(build_dir))
+    return re.sub(r"[^A-Za-z0-9_.-]+", "_", raw).strip("_")
+
+
+def run(build_dir, target, args):
+    exe = os.path.join(build_dir, target)
+    if not os.access(exe, os.X_OK):
+        sys.exit("%s not found, build it first" % exe)
+    out = subprocess.check_output([exe, "--format=json"] + args)
+    return json.loads(out.decode())["benchmarks"]
+
+
+def collect(opts):
+    args = ["--reps=%d" % opts.reps, "--warmup=%d" % opts.warmup]
+    if opts.filter:
+        args.append("--filter=" + opts.filter)
+    results = {}
+    for target in BENCHMARKS:
+        if opts.only and opts.only not in target:
+            continue
+        print("running %s" % target, file=sys.stderr)
+        for b in run(opts.build_dir, target, args):
+            results["%s:%s/%s" % (target, b["group"], b["name"])] = {"samples_ns": b["samples_ns"], "median_ns": b["median_ns"]}
+        if os.access(os.path.join(opts.build_dir, target + "_alloc"), os.X_OK):
+            # a single repetition is enough, the counts do not vary
+            for b in run(opts.build_dir, target + "_alloc", ["--reps=1", "--warmup=0"] + args[2:]):
+                key = "%s:%s/%s" % (target, b["group"], b["name"])
+                if key in results:
+                    results[key]["allocations_per_op"] = b["allocations_per_op"]
+                    results[key]["bytes_per_op"] = b["bytes_per_op"]
+    return results
+
+
+def mann_whitney_p(a, b):
+    """Two-sided p-value of the Mann-Whitney U test, normal approximation with tie correction."""
+    n1, n2 = len(a), len(b)
+    if n1 < 2 or n2 < 2:
+        return 1.0
+    pooled = sorted([(x, 0) for x in a] + [(x, 1) for x in b])
+    ranks = [0.0] * len(pooled)
+    ties = 0.0
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1
+        t = j - i + 1
+        ties += t ** 3 - t
+        i = j + 1
+    r1 = sum(r for r, (_, g) in zip(ranks, pooled) if g == 0)
+    u = r1 - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    sigma = math.sqrt(n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1))))
+    if sigma == 0:
+        return 1.0
+    z = (abs(u - n1 * n2 / 2.0) - 0.5) / sigma
+    return math.erfc(max(z, 0) / math.sqrt(2))
+
+
+def compare(baseline, current, opts):
+    regressions = 0
+    print("%-64s %12s %12s %8s %8s  %s" % ("benchmark", "base ns/op", "now ns/op", "change", "p", "verdict"))
+    for key in sorted(current):
+        now = current[key]
+        if key not in baseline:
+            print("%-64s %12s %12.2f %8s %8s  new" % (key, "-", now["median_ns"], "", ""))
+            continue
+        base = baseline[key]
+        change = now["median_ns"] / base["median_ns"] - 1 if base["median_ns"] > 0 else 0.0
+        p = mann_whitney_p(base["samples_ns"], now["samples_ns"])
+        verdict = ""
+        if p < opts.alpha and change > opts.threshold:
+            verdict = "SLOWER"
+        elif p < opts.alpha and change < -opts.threshold:
+            verdict = "faster"
+        for field in ("allocations_per_op", "bytes_per_op"):
+            if field in base and field in now and now[field] > base[field] * (1 + 1e-9) + 1e-9:
+                verdict += (" " if verdict else "") + "MORE %s (%g -> %g)" % (field.replace("_per_op", ""), base[field], now[field])
+        regressions += "SLOWER" in verdict or "MORE" in verdict
+        print("%-64s %12.2f %12.2f %+7.1f%% %8.4f  %s" % (key, base["median_ns"], now["median_ns"], 100 * change, p, verdict))
+    for key in sorted(set(baseline) - set(current)):
+        print("%-64s missing" % key)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("command", choices=["record", "compare"])
+    parser.add_argument("--build-dir", default=".", help="directory holding the bench_* executables")
+    parser.add_argument("--baseline-dir", default=BASELINE_DIR)
+    parser.add_argument("--machine", help="baseline name, by default derived from host, CPU and build type")
+    parser.add_argument("--reps", type=int, default=15)
+    parser.add_argument("--warmup", type=int, default=2)
+    parser.add_argument("--filter", help="only the benchmarks whose group/name contains it")
+    parser.add_argument("--only", help="only the targets whose name contains it, e.g. map")
+    parser.add_argument("--alpha", type=float, default=0.01, help="significance level of the U test")
+    parser.add_argument("--threshold", type=float, default=0.05, help="smallest relative change of the median reported")
+    opts = parser.parse_args()
+
+    path = os.path.join(opts.baseline_dir, (opts.machine or machine_id(opts.build_dir)) + ".json")
+    if opts.command == "record":
+        results = collect(opts)
+        if not os.path.isdir(opts.baseline_dir):
+            os.makedirs(opts.baseline_dir)
+        with open(path, "w") as f:
+            json.dump({"machine": machine_id(opts.build_dir), "cpu": cpu_model(), "results": results}, f, indent=1, sort_keys=True)
+        print("baseline of %d benchmarks written to %s" % (len(results), path))
+        return 0
+
+    if not os.path.exists(path):
+        sys.exit("no baseline %s, run 'regress.py record' first" % path)
+    with open(path) as f:
+        baseline = json.load(f)["results"]
+    regressions = compare(baseline, collect(opts), opts)
+    print("%d regression(s)" % regressions)
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
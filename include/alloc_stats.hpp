@@ -0,0 +1,99 @@
+#ifndef SJTU_ALLOC_STATS_HPP
+#define SJTU_ALLOC_STATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace sjtu {
+
+/**
+ * Defining SJTU_COUNT_ALLOCATIONS before including deque.hpp or map.hpp makes them count
+ *   the heap blocks of their nodes and elements, for each instantiation separately,
+ *   read with allocation_stats(). Without it the counting compiles to nothing.
+ * Every translation unit of a program must agree on it.
+ */
+#ifdef SJTU_COUNT_ALLOCATIONS
+constexpr bool count_allocations = true;
+#else
+constexpr bool count_allocations = false;
+#endif
+
+struct alloc_stats {
+	size_t allocations;
+	size_t deallocations;
+	// requested by all the allocations, freed or not
+	size_t bytes;
+	size_t live;
+	// highest live since the last reset_peak()
+	size_t peak;
+};
+
+namespace alloc_detail {
+
+	// the counters of all the containers of type Container, relaxed as they are only statistics
+	template<class Container>
+	class counter {
+		static std::atomic<size_t> allocations;
+		static std::atomic<size_t> deallocations;
+		static std::atomic<size_t> bytes;
+		static std::atomic<size_t> live;
+		static std::atomic<size_t> peak;
+
+	public:
+		static void allocated(size_t size) {
+			if (!count_allocations) {
+				return;
+			}
+			allocations.fetch_add(1, std::memory_order_relaxed);
+			bytes.fetch_add(size, std::memory_order_relaxed);
+			size_t now = live.fetch_add(size, std::memory_order_relaxed) + size;
+			size_t high = peak.load(std::memory_order_relaxed);
+			while (now > high && !peak.compare_exchange_weak(high, now, std::memory_order_relaxed)) {}
+		}
+		static void released(size_t size) {
+			if (!count_allocations) {
+				return;
+			}
+			deallocations.fetch_add(1, std::memory_order_relaxed);
+			live.fetch_sub(size, std::memory_order_relaxed);
+		}
+		static alloc_stats stats() {
+			alloc_stats ret;
+			ret.allocations = allocations.load(std::memory_order_relaxed);
+			ret.deallocations = deallocations.load(std::memory_order_relaxed);
+			ret.bytes = bytes.load(std::memory_order_relaxed);
+			ret.live = live.load(std::memory_order_relaxed);
+			ret.peak = peak.load(std::memory_order_relaxed);
+			return ret;
+		}
+		static void reset_peak() {
+			peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+	};
+
+	template<class Container> std::atomic<size_t> counter<Container>::allocations(0);
+	template<class Container> std::atomic<size_t> counter<Container>::deallocations(0);
+	template<class Container> std::atomic<size_t> counter<Container>::bytes(0);
+	template<class Container> std::atomic<size_t> counter<Container>::live(0);
+	template<class Container> std::atomic<size_t> counter<Container>::peak(0);
+
+	// base of the nodes of Container, every new and delete of a node is counted
+	template<class Container>
+	struct counted {
+		static void* operator new(size_t size) {
+			void* p = ::operator new(size);
+			counter<Container>::allocated(size);
+			return p;
+		}
+		static void operator delete(void* p, size_t size) noexcept {
+			counter<Container>::released(size);
+			::operator delete(p);
+		}
+	};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,773 @@
+/**
+ * implement a container like std::map, as a B+ tree
+ */
+#ifndef SJTU_BPLUS_MAP_HPP
+#define SJTU_BPLUS_MAP_HPP
+
+// only for std::less<T>
+#include <functional>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * Target size of a B+ tree node in bytes, four cache lines: a node is searched
+ *   with a few misses that the prefetcher overlaps, instead of one miss per level of an AVL tree.
+ */
+const size_t BPLUS_NODE_BYTES = 256;
+
+/**
+ * Ordered map with the same interface as sjtu::map, stored as a B+ tree:
+ *   the elements sit in sorted arrays in the leaves, which are linked to their siblings,
+ *   the inner nodes only hold separator keys and children.
+ * A lookup touches about log_16(n) nodes instead of log_2(n), and iterating is a walk
+ *   through contiguous arrays. lower_bound() and upper_bound() start range scans.
+ * Unlike sjtu::map, elements move between nodes:
+ *   insert() and erase() invalidate all iterators and pointers to elements.
+ * Key must be copy constructible, the separators are copies of keys.
+ */
+template<
+	class Key,
+	class T,
+	class Compare = std::less<Key>
+> class bplus_map {
+public:
+    typedef pair<const Key, T> value_type;
+
+private:
+    static constexpr int LEAF_SLOTS = sizeof(value_type) * 4 > BPLUS_NODE_BYTES ? 4 :
+                                      static_cast<int>(BPLUS_NODE_BYTES / sizeof(value_type));
+    static constexpr int INNER_SLOTS = (sizeof(Key) + sizeof(void*)) * 4 > BPLUS_NODE_BYTES ? 4 :
+                                       static_cast<int>(BPLUS_NODE_BYTES / (sizeof(Key) + sizeof(void*)));
+    // every node but the root keeps at least this many elements (leaf) or keys (inner)
+    static constexpr int LEAF_MIN = LEAF_SLOTS / 2;
+    static constexpr int INNER_MIN = (INNER_SLOTS - 1) / 2;
+
+    struct node {
+        bool is_leaf;
+        int count;
+        explicit node(bool leaf): is_leaf(leaf), count(0) {}
+    };
+
+    struct leaf : node {
+        leaf* prev;
+        leaf* next;
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type data[LEAF_SLOTS];
+
+        leaf(): node(true), prev(nullptr), next(nullptr) {}
+        ~leaf() {
+            for (int i = 0; i < this->count; ++i) {
+                value(i).~value_type();
+            }
+        }
+        value_type &value(int i) {
+            return *reinterpret_cast<value_type*>(&data[i]);
+        }
+        const Key &key(int i) {
+            return value(i).first;
+        }
+        // move value(from) into the empty slot to
+        void move(int to, value_type &from) {
+            new (&data[to]) value_type(std::move(from));
+            from.~value_type();
+        }
+    };
+
+    struct inner : node {
+        // child[i] holds the keys from key(i - 1) (inclusive) to key(i)
+        typename std::aligned_storage<sizeof(Key), alignof(Key)>::type keys[INNER_SLOTS];
+        node* child[INNER_SLOTS + 1];
+
+        inner(): node(false) {}
+        ~inner() {
+            for (int i = 0; i < this->count; ++i) {
+                key(i).~Key();
+            }
+        }
+        Key &key(int i) {
+            return *reinterpret_cast<Key*>(&keys[i]);
+        }
+        void move(int to, Key &from) {
+            new (&keys[to]) Key(std::move(from));
+            from.~Key();
+        }
+        // Key is not required to be assignable
+        void assign(int i, const Key &k) {
+            key(i).~Key();
+            new (&keys[i]) Key(k);
+        }
+        // the child whose range contains k
+        int find_child(const Key &k, const Compare &comp) {
+            int lo = 0, hi = this->count;
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (comp(k, key(mid))) {
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            return lo;
+        }
+    };
+
+    size_t map_size;
+    node* root;
+    // the first and the last leaf, for begin() and --end()
+    leaf* head;
+    leaf* tail;
+    Compare comp;
+
+public:
+	/**
+	 * see BidirectionalIterator at CppReference for help.
+	 *
+	 * if there is anything wrong throw invalid_iterator.
+	 *     like it = map.begin(); --it;
+	 *       or it = map.end(); ++end();
+	 * no check is done if SJTU_UNCHECKED is defined, see exceptions.hpp.
+	 */
+	class const_iterator;
+	class iterator {
+        friend class bplus_map;
+        friend class const_iterator;
+		const bplus_map* this_map;
+        leaf* this_leaf;
+        int index;
+	public:
+		iterator():this_map(nullptr), this_leaf(nullptr), index(0) {}
+        iterator(const bplus_map* m, leaf* l, int i): this_map(m), this_leaf(l), index(i) {}
+		iterator(const iterator &other) = default;
+
+		iterator operator++(int) {
+            iterator ret {*this};
+            ++*this;
+            return ret;
+        }
+		iterator & operator++() {
+            if (checked_access && !this_leaf) {
+                throw invalid_iterator();
+            }
+
+            if (++index == this_leaf->count) {
+                this_leaf = this_leaf->next;
+                index = 0;
+            }
+
+            return *this;
+        }
+
+		iterator operator--(int) {
+            iterator ret {*this};
+            --*this;
+            return ret;
+        }
+		iterator & operator--() {
+            if (checked_access && *this == this_map->begin()) {
+                throw invalid_iterator();
+            }
+
+            if (!this_leaf) {
+                this_leaf = this_map->tail;
+                index = this_leaf->count - 1;
+            } else if (index == 0) {
+                this_leaf = this_leaf->prev;
+                index = this_leaf->count - 1;
+            } else {
+                --index;
+            }
+
+            return *this;
+        }
+
+		value_type & operator*() const {
+            return this_leaf->value(index);
+        }
+        value_type* operator->() const noexcept {
+            return &this_leaf->value(index);
+        }
+
+		bool operator==(const iterator &rhs) const {
+            return this_map == rhs.this_map && this_leaf == rhs.this_leaf && index == rhs.index;
+        }
+		bool operator==(const const_iterator &rhs) const {
+            return rhs == *this;
+        }
+
+		bool operator!=(const iterator &rhs) const {
+            return !(*this == rhs);
+        }
+		bool operator!=(const const_iterator &rhs) const {
+            return rhs != *this;
+        }
+	};
+	class const_iterator {
+    private:
+        iterator it;
+    public:
+        const_iterator() = default;
+        const_iterator(const bplus_map* m, leaf* l, int i): it(m, l, i) {}
+        const_iterator(const const_iterator &other) = default;
+        const_iterator(const iterator &other): it(other) {}
+
+        const_iterator operator++(int) {
+            return const_iterator(it++);
+        }
+        const_iterator& operator++() {
+            ++it;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            return const_iterator(it--);
+        }
+        const_iterator& operator--() {
+            --it;
+            return *this;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return it == rhs;
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return it == rhs.it;
+        }
+
+        bool operator!=(const iterator &rhs) const {
+            return it != rhs;
+        }
+        bool operator!=(const const_iterator &rhs) const {
+            return it != rhs.it;
+        }
+
+        const value_type* operator->() const {
+            return it.operator->();
+        }
+        const value_type& operator*() const {
+            return *it;
+        }
+	};
+
+	bplus_map(): map_size(0), root(nullptr), head(nullptr), tail(nullptr), comp() {}
+	bplus_map(const bplus_map &other): map_size(other.map_size), head(nullptr), tail(nullptr), comp(other.comp) {
+        leaf* last = nullptr;
+        root = clone_tree(other.root, last);
+        tail = last;
+    }
+
+	bplus_map & operator=(const bplus_map &other) {
+        if (this == &other) {
+            return *this;
+        }
+
+        clear();
+
+        leaf* last = nullptr;
+        root = clone_tree(other.root, last);
+        tail = last;
+        comp = other.comp;
+        map_size = other.map_size;
+
+        return *this;
+    }
+
+	~bplus_map() {
+        clear();
+    }
+
+private:
+    // first position in l whose key is not less than k (lower) or greater than k (!lower)
+    int search_leaf(leaf* l, const Key &k, bool lower) const {
+        int lo = 0, hi = l->count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (lower ? comp(l->key(mid), k) : !comp(k, l->key(mid))) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    leaf* search_leaf(const Key &k) const {
+        node* pos = root;
+        while (pos && !pos->is_leaf) {
+            inner* in = static_cast<inner*>(pos);
+            pos = in->child[in->find_child(k, comp)];
+        }
+        return static_cast<leaf*>(pos);
+    }
+
+    iterator bound(const Key &k, bool lower) const {
+        leaf* l = search_leaf(k);
+        if (!l) {
+            return end();
+        }
+
+        int i = search_leaf(l, k, lower);
+        // the separators may be keys erased since, the bound can be at the start of the next leaf
+        if (i == l->count) {
+            return iterator(this, l->next, 0);
+        }
+        return iterator(this, l, i);
+    }
+
+    pair<leaf*, int> search_node(const Key &k) const {
+        leaf* l = search_leaf(k);
+        if (l) {
+            int i = search_leaf(l, k, true);
+            if (i < l->count && !comp(k, l->key(i))) {
+                return pair<leaf*, int>(l, i);
+            }
+        }
+        return pair<leaf*, int>(nullptr, 0);
+    }
+
+    node* clone_tree(const node* tree, leaf* &last) {
+        if (!tree) {
+            return nullptr;
+        }
+
+        if (tree->is_leaf) {
+            leaf* from = const_cast<leaf*>(static_cast<const leaf*>(tree));
+            leaf* ret = new leaf();
+            for (int i = 0; i < from->count; ++i) {
+                new (&ret->data[i]) value_type(from->value(i));
+                ++ret->count;
+            }
+            ret->prev = last;
+            if (last) {
+                last->next = ret;
+            } else {
+                head = ret;
+            }
+            last = ret;
+            return ret;
+        }
+
+        inner* from = const_cast<inner*>(static_cast<const inner*>(tree));
+        inner* ret = new inner();
+        for (int i = 0; i <= from->count; ++i) {
+            ret->child[i] = clone_tree(from->child[i], last);
+        }
+        for (int i = 0; i < from->count; ++i) {
+            new (&ret->keys[i]) Key(from->key(i));
+            ++ret->count;
+        }
+        return ret;
+    }
+
+    void clear(node* tree) {
+        if (!tree) {
+            return;
+        }
+
+        if (tree->is_leaf) {
+            delete static_cast<leaf*>(tree);
+        } else {
+            inner* in = static_cast<inner*>(tree);
+            for (int i = 0; i <= in->count; ++i) {
+                clear(in->child[i]);
+            }
+            delete in;
+        }
+    }
+
+    /**
+     * split the full child i of parent in two halves,
+     *   the separator between them goes up into parent, which is not full.
+     */
+    void split_child(inner* parent, int i) {
+        node* c = parent->child[i];
+        node* right;
+        if (c->is_leaf) {
+            leaf* l = static_cast<leaf*>(c);
+            leaf* r = new leaf();
+            int half = l->count / 2;
+            for (int j = half; j < l->count; ++j) {
+                r->move(j - half, l->value(j));
+            }
+            r->count = l->count - half;
+            l->count = half;
+            r->next = l->next;
+            r->prev = l;
+            if (l->next) {
+                l->next->prev = r;
+            } else {
+                tail = r;
+            }
+            l->next = r;
+            right = r;
+        } else {
+            inner* l = static_cast<inner*>(c);
+            inner* r = new inner();
+            int mid = l->count / 2;
+            for (int j = mid + 1; j < l->count; ++j) {
+                r->move(j - mid - 1, l->key(j));
+                r->child[j - mid - 1] = l->child[j];
+            }
+            r->child[l->count - mid - 1] = l->child[l->count];
+            r->count = l->count - mid - 1;
+            l->count = mid;
+            right = r;
+        }
+
+        for (int j = parent->count; j > i; --j) {
+            parent->move(j, parent->key(j - 1));
+            parent->child[j + 1] = parent->child[j];
+        }
+        if (c->is_leaf) {
+            new (&parent->keys[i]) Key(static_cast<leaf*>(right)->key(0));
+        } else {
+            // the middle key of the inner node moves up
+            inner* l = static_cast<inner*>(c);
+            parent->move(i, l->key(l->count));
+        }
+        parent->child[i + 1] = right;
+        ++parent->count;
+    }
+
+    // the value is constructed in the leaf from args, key must not be present
+    template<class... Args>
+    pair<leaf*, int> insert_helper(const Key &key, Args&&... args) {
+        if (!root) {
+            root = head = tail = new leaf();
+        }
+        if (is_full(root)) {
+            inner* new_root = new inner();
+            new_root->child[0] = root;
+            root = new_root;
+            split_child(new_root, 0);
+        }
+
+        // full nodes are split on the way down, so a split never has to go back up
+        node* pos = root;
+        while (!pos->is_leaf) {
+            inner* in = static_cast<inner*>(pos);
+            int i = in->find_child(key, comp);
+            if (is_full(in->child[i])) {
+                split_child(in, i);
+                i = in->find_child(key, comp);
+            }
+            pos = in->child[i];
+        }
+
+        leaf* l = static_cast<leaf*>(pos);
+        int i = search_leaf(l, key, true);
+        for (int j = l->count; j > i; --j) {
+            l->move(j, l->value(j - 1));
+        }
+        new (&l->data[i]) value_type(std::forward<Args>(args)...);
+        ++l->count;
+        ++map_size;
+
+        return pair<leaf*, int>(l, i);
+    }
+
+    static bool is_full(node* n) {
+        return n->is_leaf ? n->count == LEAF_SLOTS : n->count == INNER_SLOTS;
+    }
+
+    /**
+     * make sure child i of parent can lose an element or key, by taking one from a sibling
+     *   or merging it with one. Returns the index the child has afterwards.
+     */
+    int fill_child(inner* parent, int i) {
+        node* c = parent->child[i];
+        int min = INNER_MIN;
+        if (c->is_leaf) {
+            min = LEAF_MIN;
+        }
+        if (c->count > min) {
+            return i;
+        }
+
+        if (i > 0 && parent->child[i - 1]->count > min) {
+            borrow_from_left(parent, i);
+        } else if (i < parent->count && parent->child[i + 1]->count > min) {
+            borrow_from_right(parent, i);
+        } else if (i > 0) {
+            merge_children(parent, i - 1);
+            --i;
+        } else {
+            merge_children(parent, i);
+        }
+        return i;
+    }
+
+    void borrow_from_left(inner* parent, int i) {
+        node* c = parent->child[i];
+        node* s = parent->child[i - 1];
+        if (c->is_leaf) {
+            leaf* l = static_cast<leaf*>(c);
+            leaf* from = static_cast<leaf*>(s);
+            for (int j = l->count; j > 0; --j) {
+                l->move(j, l->value(j - 1));
+            }
+            l->move(0, from->value(from->count - 1));
+            parent->assign(i - 1, l->key(0));
+        } else {
+            inner* in = static_cast<inner*>(c);
+            inner* from = static_cast<inner*>(s);
+            in->child[in->count + 1] = in->child[in->count];
+            for (int j = in->count; j > 0; --j) {
+                in->move(j, in->key(j - 1));
+                in->child[j] = in->child[j - 1];
+            }
+            in->move(0, parent->key(i - 1));
+            in->child[0] = from->child[from->count];
+            parent->move(i - 1, from->key(from->count - 1));
+        }
+        ++c->count;
+        --s->count;
+    }
+
+    void borrow_from_right(inner* parent, int i) {
+        node* c = parent->child[i];
+        node* s = parent->child[i + 1];
+        if (c->is_leaf) {
+            leaf* l = static_cast<leaf*>(c);
+            leaf* from = static_cast<leaf*>(s);
+            l->move(l->count, from->value(0));
+            for (int j = 1; j < from->count; ++j) {
+                from->move(j - 1, from->value(j));
+            }
+            parent->assign(i, from->key(0));
+        } else {
+            inner* in = static_cast<inner*>(c);
+            inner* from = static_cast<inner*>(s);
+            in->move(in->count, parent->key(i));
+            in->child[in->count + 1] = from->child[0];
+            parent->move(i, from->key(0));
+            for (int j = 1; j < from->count; ++j) {
+                from->move(j - 1, from->key(j));
+                from->child[j - 1] = from->child[j];
+            }
+            from->child[from->count - 1] = from->child[from->count];
+        }
+        ++c->count;
+        --s->count;
+    }
+
+    // merge child i + 1 of parent into child i, dropping the separator between them
+    void merge_children(inner* parent, int i) {
+        node* c = parent->child[i];
+        node* s = parent->child[i + 1];
+        if (c->is_leaf) {
+            leaf* l = static_cast<leaf*>(c);
+            leaf* r = static_cast<leaf*>(s);
+            for (int j = 0; j < r->count; ++j) {
+                l->move(l->count + j, r->value(j));
+            }
+            l->count += r->count;
+            r->count = 0;
+            parent->key(i).~Key();
+            l->next = r->next;
+            if (r->next) {
+                r->next->prev = l;
+            } else {
+                tail = l;
+            }
+            delete r;
+        } else {
+            inner* l = static_cast<inner*>(c);
+            inner* r = static_cast<inner*>(s);
+            l->move(l->count, parent->key(i));
+            for (int j = 0; j < r->count; ++j) {
+                l->move(l->count + 1 + j, r->key(j));
+                l->child[l->count + 1 + j] = r->child[j];
+            }
+            l->child[l->count + 1 + r->count] = r->child[r->count];
+            l->count += r->count + 1;
+            r->count = 0;
+            delete r;
+        }
+
+        for (int j = i + 1; j < parent->count; ++j) {
+            parent->move(j - 1, parent->key(j));
+            parent->child[j] = parent->child[j + 1];
+        }
+        --parent->count;
+    }
+
+public:
+
+	/**
+	 * Returns a reference to the mapped value
+	 * an exception of type `index_out_of_bound'
+	 */
+	T & at(const Key &key) {
+        pair<leaf*, int> res = search_node(key);
+
+        if (!res.first) {
+            throw index_out_of_bound();
+        }
+
+        return res.first->value(res.second).second;
+    }
+	const T & at(const Key &key) const {
+        pair<leaf*, int> res = search_node(key);
+
+        if (!res.first) {
+            throw index_out_of_bound();
+        }
+
+        return res.first->value(res.second).second;
+    }
+	/**
+	 * Returns a pointer to the mapped value, or nullptr if such key does not exist.
+	 *   It is valid until the next insert() or erase().
+	 */
+	T * find_ptr(const Key &key) {
+        pair<leaf*, int> res = search_node(key);
+
+        return res.first ? &res.first->value(res.second).second : nullptr;
+    }
+	const T * find_ptr(const Key &key) const {
+        pair<leaf*, int> res = search_node(key);
+
+        return res.first ? &res.first->value(res.second).second : nullptr;
+    }
+
+	/**
+	 * access specified element
+	 *   performing an insertion if such key does not already exist.
+	 */
+	T & operator[](const Key &key) {
+        pair<leaf*, int> res = search_node(key);
+
+        if (!res.first) {
+            res = insert_helper(key, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>());
+        }
+
+        return res.first->value(res.second).second;
+    }
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const {
+        return at(key);
+    }
+
+	iterator begin() const {
+        return iterator(this, head && head->count ? head : nullptr, 0);
+    }
+	const_iterator cbegin() const {
+        return begin();
+    }
+
+	iterator end() const {
+        return iterator(this, nullptr, 0);
+    }
+	const_iterator cend() const {
+        return end();
+    }
+
+	bool empty() const {
+        return !map_size;
+    }
+
+	size_t size() const {
+        return map_size;
+    }
+
+	void clear() {
+        clear(root);
+        map_size = 0;
+        root = nullptr;
+        head = tail = nullptr;
+    }
+
+	/**
+	 * insert an element.
+	 * return a pair, the first of the pair is
+	 *   the iterator to the new element (or the element that prevented the insertion),
+	 *   the second one is true if insert successfully, or false.
+	 */
+	pair<iterator, bool> insert(value_type value) {
+        pair<leaf*, int> res = search_node(value.first);
+
+        if (res.first) {
+            return pair<iterator, bool>(iterator(this, res.first, res.second), false);
+        } else {
+            res = insert_helper(value.first, std::move(value));
+            return pair<iterator, bool>(iterator(this, res.first, res.second), true);
+        }
+    }
+
+	/**
+	 * erase the element at pos.
+	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+	 */
+	void erase(iterator pos) {
+        if (pos.this_map != this || !pos.this_leaf || pos.index >= pos.this_leaf->count) {
+            throw index_out_of_bound();
+        }
+
+        // every node on the way down gets an element to spare, so removing one never underflows
+        // a copy, the element moves while the nodes are filled
+        const Key key(pos->first);
+        node* n = root;
+        while (!n->is_leaf) {
+            inner* in = static_cast<inner*>(n);
+            n = in->child[fill_child(in, in->find_child(key, comp))];
+            if (in == root && in->count == 0) {
+                // the only two children of the root were merged
+                root = n;
+                delete in;
+            }
+        }
+
+        leaf* l = static_cast<leaf*>(n);
+        int i = search_leaf(l, key, true);
+        l->value(i).~value_type();
+        for (int j = i + 1; j < l->count; ++j) {
+            l->move(j - 1, l->value(j));
+        }
+        --l->count;
+        --map_size;
+
+        if (!map_size) {
+            clear();
+        }
+    }
+	/**
+	 * Returns the number of elements with key, either 1 or 0
+	 */
+	size_t count(const Key &key) const {
+        return search_node(key).first ? 1 : 0;
+    }
+	/**
+	 * Finds an element with key equivalent to key.
+	 *   If no such element is found, past-the-end (see end()) iterator is returned.
+	 */
+	iterator find(const Key &key) {
+        pair<leaf*, int> res = search_node(key);
+
+        return iterator(this, res.first, res.second);
+    }
+	const_iterator find(const Key &key) const {
+        pair<leaf*, int> res = search_node(key);
+
+        return const_iterator(this, res.first, res.second);
+    }
+	/**
+	 * the first element whose key is not less than key, or end().
+	 */
+	iterator lower_bound(const Key &key) const {
+        return bound(key, true);
+    }
+	/**
+	 * the first element whose key is greater than key, or end().
+	 */
+	iterator upper_bound(const Key &key) const {
+        return bound(key, false);
+    }
+};
+}
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef DIAMOND_FIXED_MATRIX_HPP
+#define DIAMOND_FIXED_MATRIX_HPP
+
+#include <initializer_list>
+#include <stdexcept>
+#include "class-matrix.hpp"
+
+namespace Diamond {
+
+namespace FixedDetail {
+
+/**
+ * Unroll<N>::Run(f) calls f(0), f(1), ..., f(N - 1) without a loop,
+ *   the index is a constant once the call is inlined.
+ */
+template<size_t _N>
+struct Unroll {
+	template<typename _Tf>
+	static inline void Run(const _Tf &f)
+	{
+		Unroll<_N - 1>::Run(f);
+		f(_N - 1);
+	}
+};
+template<>
+struct Unroll<0> {
+	template<typename _Tf>
+	static inline void Run(const _Tf &) {}
+};
+
+/**
+ * a[0] * b[0][col] + ... + a[_K - 1] * b[_K - 1][col]
+ */
+template<size_t _K>
+struct Dot {
+	template<typename _Td, typename _Tb>
+	static inline _Td Run(const _Td *a, const _Tb &b, const size_t &col)
+	{
+		return Dot<_K - 1>::Run(a, b, col) + a[_K - 1] * b[_K - 1][col];
+	}
+};
+template<>
+struct Dot<1> {
+	template<typename _Td, typename _Tb>
+	static inline _Td Run(const _Td *a, const _Tb &b, const size_t &col)
+	{
+		return a[0] * b[0][col];
+	}
+};
+
+}
+
+/**
+ * Matrix with dimensions fixed at compile time.
+ * Elements live inside the object (no heap allocation) and the kernels below
+ *   are unrolled over the dimensions, which pays off for 2x2 .. 4x4 sized matrices.
+ * It is a dense matrix-like type, so it mixes with Matrix and the views through the
+ *   generic operators, giving a dynamic Matrix as result.
+ */
+template<typename _Td, size_t _Rows, size_t _Cols>
+class FixedMatrix {
+	static_assert(_Rows > 0 && _Cols > 0, "a fixed matrix cannot be empty");
+protected:
+	_Td data[_Rows][_Cols];
+public:
+	typedef _Td value_type;
+	FixedMatrix() : data() {}
+	explicit FixedMatrix(const _Td &fillValue)
+	{
+		FixedDetail::Unroll<_Rows * _Cols>::Run([&](const size_t &k) {
+			data[k / _Cols][k % _Cols] = fillValue;
+		});
+	}
+	/**
+	 * Elements in row-major order, the missing ones are zero.
+	 */
+	FixedMatrix(std::initializer_list<_Td> values) : data()
+	{
+		if (values.size() > _Rows * _Cols) {
+			throw std::invalid_argument("too many elements for the fixed matrix");
+		}
+		size_t k = 0;
+		for (const _Td &v : values) {
+			data[k / _Cols][k % _Cols] = v;
+			++k;
+		}
+	}
+	/**
+	 * Conversion from a Matrix, a view, or anything dense matrix-like of the same size.
+	 */
+	template<typename _Tm, typename = typename EnableIfDense<_Tm, void>::type>
+	explicit FixedMatrix(const _Tm &mat)
+	{
+		if (mat.RowSize() != _Rows || mat.ColSize() != _Cols) {
+			throw std::invalid_argument("different matrics\'s sizes");
+		}
+		for (size_t i = 0; i < _Rows; ++i) {
+			for (size_t j = 0; j < _Cols; ++j) {
+				data[i][j] = mat[i][j];
+			}
+		}
+	}
+	FixedMatrix(const FixedMatrix &mat) = default;
+	FixedMatrix & operator=(const FixedMatrix &rhs) = default;
+	static constexpr size_t RowSize()
+	{
+		return _Rows;
+	}
+	static constexpr size_t ColSize()
+	{
+		return _Cols;
+	}
+	_Td * operator[](const size_t &Kth)
+	{
+		return data[Kth];
+	}
+	const _Td * operator[](const size_t &Kth) const
+	{
+		return data[Kth];
+	}
+	Matrix<_Td> ToMatrix() const
+	{
+		return Matrix<_Td>(*this);
+	}
+	~FixedMatrix() = default;
+};
+
+template<typename _Td, size_t _Rows, size_t _Cols>
+struct IsDenseMatrix<FixedMatrix<_Td, _Rows, _Cols>> : std::true_type {};
+
+template<typename _Td, size_t _Rows, size_t _Cols>
+FixedMatrix<_Td, _Rows, _Cols> operator+(const FixedMatrix<_Td, _Rows, _Cols> &a, const FixedMatrix<_Td, _Rows, _Cols> &b)
+{
+	FixedMatrix<_Td, _Rows, _Cols> c;
+	FixedDetail::Unroll<_Rows * _Cols>::Run([&](const size_t &k) {
+		c[k / _Cols][k % _Cols] = a[k / _Cols][k % _Cols] + b[k / _Cols][k % _Cols];
+	});
+	return c;
+}
+
+template<typename _Td, size_t _Rows, size_t _Cols>
+FixedMatrix<_Td, _Rows, _Cols> operator-(const FixedMatrix<_Td, _Rows, _Cols> &a, const FixedMatrix<_Td, _Rows, _Cols> &b)
+{
+	FixedMatrix<_Td, _Rows, _Cols> c;
+	FixedDetail::Unroll<_Rows * _Cols>::Run([&](const size_t &k) {
+		c[k / _Cols][k % _Cols] = a[k / _Cols][k % _Cols] - b[k / _Cols][k % _Cols];
+	});
+	return c;
+}
+
+template<typename _Td, size_t _Rows, size_t _Cols>
+FixedMatrix<_Td, _Rows, _Cols> operator-(const FixedMatrix<_Td, _Rows, _Cols> &mat)
+{
+	FixedMatrix<_Td, _Rows, _Cols> result;
+	FixedDetail::Unroll<_Rows * _Cols>::Run([&](const size_t &k) {
+		result[k / _Cols][k % _Cols] = -mat[k / _Cols][k % _Cols];
+	});
+	return result;
+}
+
+template<typename _Td, size_t _Rows, size_t _Cols>
+bool operator==(const FixedMatrix<_Td, _Rows, _Cols> &a, const FixedMatrix<_Td, _Rows, _Cols> &b)
+{
+	bool equal = true;
+	FixedDetail::Unroll<_Rows * _Cols>::Run([&](const size_t &k) {
+		equal = equal && a[k / _Cols][k % _Cols] == b[k / _Cols][k % _Cols];
+	});
+	return equal;
+}
+
+/**
+ * Multiplication of two fixed matrics, every dot product is fully unrolled.
+ */
+template<typename _Td, size_t _Rows, size_t _K, size_t _Cols>
+FixedMatrix<_Td, _Rows, _Cols> operator*(const FixedMatrix<_Td, _Rows, _K> &a, const FixedMatrix<_Td, _K, _Cols> &b)
+{
+	FixedMatrix<_Td, _Rows, _Cols> c;
+	FixedDetail::Unroll<_Rows * _Cols>::Run([&](const size_t &k) {
+		c[k / _Cols][k % _Cols] = FixedDetail::Dot<_K>::Run(a[k / _Cols], b, k % _Cols);
+	});
+	return c;
+}
+
+template<typename _Td, size_t _Rows, size_t _Cols>
+FixedMatrix<_Td, _Rows, _Cols> operator*(const FixedMatrix<_Td, _Rows, _Cols> &a,
+                                         const typename FixedMatrix<_Td, _Rows, _Cols>::value_type &b)
+{
+	FixedMatrix<_Td, _Rows, _Cols> c;
+	FixedDetail::Unroll<_Rows * _Cols>::Run([&](const size_t &k) {
+		c[k / _Cols][k % _Cols] = a[k / _Cols][k % _Cols] * b;
+	});
+	return c;
+}
+
+template<typename _Td, size_t _Rows, size_t _Cols>
+FixedMatrix<_Td, _Rows, _Cols> operator*(const typename FixedMatrix<_Td, _Rows, _Cols>::value_type &b,
+                                         const FixedMatrix<_Td, _Rows, _Cols> &a)
+{
+	return a * b;
+}
+
+template<typename _Td, size_t _Rows, size_t _Cols>
+FixedMatrix<_Td, _Rows, _Cols> operator/(const FixedMatrix<_Td, _Rows, _Cols> &a, const double &b)
+{
+	FixedMatrix<_Td, _Rows, _Cols> c;
+	FixedDetail::Unroll<_Rows * _Cols>::Run([&](const size_t &k) {
+		c[k / _Cols][k % _Cols] = a[k / _Cols][k % _Cols] / b;
+	});
+	return c;
+}
+
+template<typename _Td, size_t _Rows, size_t _Cols>
+FixedMatrix<_Td, _Cols, _Rows> Transpose(const FixedMatrix<_Td, _Rows, _Cols> &a)
+{
+	FixedMatrix<_Td, _Cols, _Rows> res;
+	FixedDetail::Unroll<_Rows * _Cols>::Run([&](const size_t &k) {
+		res[k % _Cols][k / _Cols] = a[k / _Cols][k % _Cols];
+	});
+	return res;
+}
+
+template<typename _Td, size_t _N>
+FixedMatrix<_Td, _N, _N> FixedI()
+{
+	FixedMatrix<_Td, _N, _N> res;
+	FixedDetail::Unroll<_N>::Run([&](const size_t &k) {
+		res[k][k] = static_cast<_Td>(1);
+	});
+	return res;
+}
+
+template<typename _Td, size_t _N>
+FixedMatrix<_Td, _N, _N> Pow(FixedMatrix<_Td, _N, _N> A, size_t &b)
+{
+	FixedMatrix<_Td, _N, _N> result = FixedI<_Td, _N>();
+	while (b > 0) {
+		if (b & static_cast<size_t>(1)) {
+			result = result * A;
+		}
+		A = A * A;
+		b = b >> static_cast<size_t>(1);
+	}
+	return result;
+}
+
+}
+#endif
@@ -0,0 +1,222 @@
+#ifndef DIAMOND_MATRIX_BATCH_HPP
+#define DIAMOND_MATRIX_BATCH_HPP
+
+#include <vector>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include "class-matrix.hpp"
+
+namespace Diamond {
+
+/**
+ * Number of batch members processed together by the batched kernels,
+ *   small enough for a lane block of a, b and c to stay in L1.
+ */
+const size_t BATCH_LANE_BLOCK = 256;
+/**
+ * A thread is not started for less than this many products.
+ */
+const size_t BATCH_MIN_PER_THREAD = 1024;
+
+/**
+ * A batch of matrices of the same shape, stored interleaved:
+ *   element (i, j) of all the members is contiguous, at data[(i * n_cols + j) * n_batch + t].
+ * The kernels then apply every scalar operation to consecutive members at once,
+ *   which the compiler turns into SIMD lanes.
+ */
+template<typename _Td>
+class MatrixBatch {
+protected:
+	size_t n_batch = 0;
+	size_t n_rows = 0;
+	size_t n_cols = 0;
+	std::vector<_Td> data;
+public:
+	typedef _Td value_type;
+	MatrixBatch() {}
+	MatrixBatch(const size_t &_n_batch, const size_t &_n_rows, const size_t &_n_cols)
+		: n_batch(_n_batch), n_rows(_n_rows), n_cols(_n_cols), data(_n_batch * _n_rows * _n_cols) {}
+	/**
+	 * Pack a non-empty container of same-shaped matrices.
+	 */
+	template<typename _Tc>
+	explicit MatrixBatch(const _Tc &mats)
+	{
+		if (mats.empty()) {
+			throw std::invalid_argument("empty matrix batch");
+		}
+		n_batch = mats.size();
+		n_rows = mats.begin()->RowSize();
+		n_cols = mats.begin()->ColSize();
+		data.resize(n_batch * n_rows * n_cols);
+		size_t t = 0;
+		for (typename _Tc::const_iterator it = mats.begin(); it != mats.end(); ++it, ++t) {
+			if (it->RowSize() != n_rows || it->ColSize() != n_cols) {
+				throw std::invalid_argument("different matrics\'s sizes");
+			}
+			for (size_t i = 0; i < n_rows; ++i) {
+				for (size_t j = 0; j < n_cols; ++j) {
+					At(t, i, j) = (*it)[i][j];
+				}
+			}
+		}
+	}
+	inline const size_t & BatchSize() const
+	{
+		return n_batch;
+	}
+	inline const size_t & RowSize() const
+	{
+		return n_rows;
+	}
+	inline const size_t & ColSize() const
+	{
+		return n_cols;
+	}
+	inline _Td & At(const size_t &t, const size_t &i, const size_t &j)
+	{
+		return data[(i * n_cols + j) * n_batch + t];
+	}
+	inline const _Td & At(const size_t &t, const size_t &i, const size_t &j) const
+	{
+		return data[(i * n_cols + j) * n_batch + t];
+	}
+	/**
+	 * The lanes of element (i, j), one per member.
+	 */
+	inline _Td * Lanes(const size_t &i, const size_t &j)
+	{
+		return &data[(i * n_cols + j) * n_batch];
+	}
+	inline const _Td * Lanes(const size_t &i, const size_t &j) const
+	{
+		return &data[(i * n_cols + j) * n_batch];
+	}
+	/**
+	 * Unpack the t-th member.
+	 */
+	Matrix<_Td> operator[](const size_t &t) const
+	{
+		Matrix<_Td> res(n_rows, n_cols);
+		for (size_t i = 0; i < n_rows; ++i) {
+			for (size_t j = 0; j < n_cols; ++j) {
+				res[i][j] = At(t, i, j);
+			}
+		}
+		return res;
+	}
+	std::vector<Matrix<_Td>> Unpack() const
+	{
+		std::vector<Matrix<_Td>> res;
+		res.reserve(n_batch);
+		for (size_t t = 0; t < n_batch; ++t) {
+			res.push_back((*this)[t]);
+		}
+		return res;
+	}
+	~MatrixBatch() = default;
+};
+
+namespace BatchDetail {
+
+/**
+ * c[t] = a[t] * b[t] for t in [first, last).
+ */
+template<typename _Td>
+void MultiplyRange(MatrixBatch<_Td> &c, const MatrixBatch<_Td> &a, const MatrixBatch<_Td> &b,
+                   const size_t &first, const size_t &last)
+{
+	const size_t M = a.RowSize(), N = b.ColSize(), K = a.ColSize();
+	for (size_t t0 = first; t0 < last; t0 += BATCH_LANE_BLOCK) {
+		const size_t lanes = std::min(BATCH_LANE_BLOCK, last - t0);
+		for (size_t i = 0; i < M; ++i) {
+			for (size_t j = 0; j < N; ++j) {
+				_Td *cp = c.Lanes(i, j) + t0;
+				std::fill(cp, cp + lanes, static_cast<_Td>(0));
+				for (size_t k = 0; k < K; ++k) {
+					const _Td *ap = a.Lanes(i, k) + t0;
+					const _Td *bp = b.Lanes(k, j) + t0;
+					for (size_t t = 0; t < lanes; ++t) {
+						cp[t] += ap[t] * bp[t];
+					}
+				}
+			}
+		}
+	}
+}
+
+}
+
+/**
+ * Member-wise product of two batches, c[t] = a[t] * b[t].
+ * The batch is split into contiguous ranges over n_threads threads,
+ *   n_threads = 0 means one per hardware thread.
+ */
+template<typename _Td>
+MatrixBatch<_Td> BatchMultiply(const MatrixBatch<_Td> &a, const MatrixBatch<_Td> &b, size_t n_threads = 0)
+{
+	if (a.BatchSize() != b.BatchSize() || a.ColSize() != b.RowSize()) {
+		throw std::invalid_argument("different matrics\'s sizes");
+	}
+	const size_t n = a.BatchSize();
+	MatrixBatch<_Td> c(n, a.RowSize(), b.ColSize());
+	if (!n_threads) {
+		n_threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	n_threads = std::max(static_cast<size_t>(1), std::min(n_threads, n / BATCH_MIN_PER_THREAD));
+	if (n_threads == 1) {
+		BatchDetail::MultiplyRange(c, a, b, 0, n);
+		return c;
+	}
+	// ranges are multiples of the lane block, so the threads write apart in every lane row of c,
+	//   they only share the cache line at a range boundary when a row is not a whole number of lines
+	const size_t blocks = (n + BATCH_LANE_BLOCK - 1) / BATCH_LANE_BLOCK;
+	std::vector<std::thread> workers;
+	workers.reserve(n_threads - 1);
+	size_t first = 0;
+	try {
+		for (size_t w = 0; w < n_threads; ++w) {
+			const size_t last = std::min(n, (blocks * (w + 1) / n_threads) * BATCH_LANE_BLOCK);
+			if (w + 1 == n_threads) {
+				BatchDetail::MultiplyRange(c, a, b, first, last);
+			} else {
+				workers.push_back(std::thread(BatchDetail::MultiplyRange<_Td>, std::ref(c), std::cref(a), std::cref(b), first, last));
+			}
+			first = last;
+		}
+	} catch (...) {
+		// a thread failed to start or this thread's range threw, the started ones are joined first
+		for (size_t w = 0; w < workers.size(); ++w) {
+			workers[w].join();
+		}
+		throw;
+	}
+	for (size_t w = 0; w < workers.size(); ++w) {
+		workers[w].join();
+	}
+	return c;
+}
+
+/**
+ * Member-wise product of two containers of same-shaped matrices,
+ *   packed into batches, multiplied by BatchMultiply, and unpacked.
+ * Packing and unpacking cost about as much as the products themselves,
+ *   keep the data in MatrixBatch form between calls where possible.
+ */
+template<typename _Td>
+std::vector<Matrix<_Td>> BatchMultiply(const std::vector<Matrix<_Td>> &a, const std::vector<Matrix<_Td>> &b,
+                                       size_t n_threads = 0)
+{
+	if (a.size() != b.size()) {
+		throw std::invalid_argument("different batch sizes");
+	}
+	if (a.empty()) {
+		return std::vector<Matrix<_Td>>();
+	}
+	return BatchMultiply(MatrixBatch<_Td>(a), MatrixBatch<_Td>(b), n_threads).Unpack();
+}
+
+}
+#endif
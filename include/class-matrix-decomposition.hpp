@@ -0,0 +1,331 @@
+#ifndef DIAMOND_MATRIX_DECOMPOSITION_HPP
+#define DIAMOND_MATRIX_DECOMPOSITION_HPP
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "class-matrix.hpp"
+
+namespace Diamond {
+
+/**
+ * Columns factorized together before the trailing matrix is updated by MultiplyAdd.
+ */
+const size_t DECOMPOSITION_BLOCK = 64;
+
+/**
+ * LU factorization with partial pivoting, PA = LU.
+ * It is computed block column by block column: a panel of DECOMPOSITION_BLOCK columns is
+ *   factorized in place, then the rest of the matrix is updated by one blocked MultiplyAdd,
+ *   which is where almost all the 2n^3/3 flops are spent.
+ * A singular matrix can still be factorized, its Determinant() is 0 but Solve() throws.
+ */
+template<typename _Td>
+class LU {
+protected:
+	// L below the diagonal (its unit diagonal is not stored), U on and above it
+	Matrix<_Td> lu;
+	// row i of PA is row perm[i] of A
+	std::vector<size_t> perm;
+	bool odd_permutation = false;
+	bool singular = false;
+
+	void Factorize()
+	{
+		const size_t n = lu.RowSize();
+		for (size_t j0 = 0; j0 < n; j0 += DECOMPOSITION_BLOCK) {
+			const size_t jb = std::min(DECOMPOSITION_BLOCK, n - j0);
+			for (size_t j = j0; j < j0 + jb; ++j) {
+				size_t p = j;
+				for (size_t i = j + 1; i < n; ++i) {
+					if (std::abs(lu[i][j]) > std::abs(lu[p][j])) {
+						p = i;
+					}
+				}
+				if (p != j) {
+					for (size_t k = 0; k < n; ++k) {
+						std::swap(lu[p][k], lu[j][k]);
+					}
+					std::swap(perm[p], perm[j]);
+					odd_permutation = !odd_permutation;
+				}
+				if (lu[j][j] == static_cast<_Td>(0)) {
+					singular = true;
+					continue;
+				}
+				for (size_t i = j + 1; i < n; ++i) {
+					lu[i][j] /= lu[j][j];
+					const _Td lij = lu[i][j];
+					for (size_t k = j + 1; k < j0 + jb; ++k) {
+						lu[i][k] -= lij * lu[j][k];
+					}
+				}
+			}
+			const size_t rest = n - j0 - jb;
+			if (!rest) {
+				break;
+			}
+			// U12 = L11^-1 A12
+			for (size_t i = j0 + 1; i < j0 + jb; ++i) {
+				for (size_t k = j0; k < i; ++k) {
+					const _Td lik = lu[i][k];
+					for (size_t j = j0 + jb; j < n; ++j) {
+						lu[i][j] -= lik * lu[k][j];
+					}
+				}
+			}
+			// A22 -= L21 U12
+			MultiplyAdd(lu.SubMatrix(j0 + jb, j0 + jb, rest, rest),
+			            lu.SubMatrix(j0 + jb, j0, rest, jb), lu.SubMatrix(j0, j0 + jb, jb, rest), -1);
+		}
+	}
+public:
+	template<typename _Tm, typename = typename EnableIfDense<_Tm, void>::type>
+	explicit LU(const _Tm &A) : lu(A), perm(A.RowSize())
+	{
+		if (A.RowSize() != A.ColSize()) {
+			throw std::invalid_argument("The row size and column size are different.");
+		}
+		for (size_t i = 0; i < perm.size(); ++i) {
+			perm[i] = i;
+		}
+		Factorize();
+	}
+	inline bool IsSingular() const
+	{
+		return singular;
+	}
+	inline const Matrix<_Td> & Packed() const
+	{
+		return lu;
+	}
+	inline const std::vector<size_t> & Permutation() const
+	{
+		return perm;
+	}
+	Matrix<_Td> L() const
+	{
+		const size_t n = lu.RowSize();
+		Matrix<_Td> res(n, n, 0);
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t j = 0; j < i; ++j) {
+				res[i][j] = lu[i][j];
+			}
+			res[i][i] = static_cast<_Td>(1);
+		}
+		return res;
+	}
+	Matrix<_Td> U() const
+	{
+		const size_t n = lu.RowSize();
+		Matrix<_Td> res(n, n, 0);
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t j = i; j < n; ++j) {
+				res[i][j] = lu[i][j];
+			}
+		}
+		return res;
+	}
+	_Td Determinant() const
+	{
+		_Td det = static_cast<_Td>(odd_permutation ? -1 : 1);
+		for (size_t i = 0; i < lu.RowSize(); ++i) {
+			det *= lu[i][i];
+		}
+		return det;
+	}
+	/**
+	 * X with AX = B, for every column of B at once.
+	 */
+	template<typename _Tm>
+	typename EnableIfDense<_Tm, Matrix<_Td>>::type Solve(const _Tm &B) const
+	{
+		const size_t n = lu.RowSize();
+		if (B.RowSize() != n) {
+			throw std::invalid_argument("different matrics\'s sizes");
+		}
+		if (singular) {
+			throw std::invalid_argument("singular matrix");
+		}
+		const size_t m = B.ColSize();
+		Matrix<_Td> X(n, m);
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t j = 0; j < m; ++j) {
+				X[i][j] = B[perm[i]][j];
+			}
+		}
+		for (size_t i = 1; i < n; ++i) {
+			for (size_t k = 0; k < i; ++k) {
+				const _Td lik = lu[i][k];
+				for (size_t j = 0; j < m; ++j) {
+					X[i][j] -= lik * X[k][j];
+				}
+			}
+		}
+		for (size_t i = n; i-- > 0; ) {
+			for (size_t k = i + 1; k < n; ++k) {
+				const _Td uik = lu[i][k];
+				for (size_t j = 0; j < m; ++j) {
+					X[i][j] -= uik * X[k][j];
+				}
+			}
+			const _Td uii = lu[i][i];
+			for (size_t j = 0; j < m; ++j) {
+				X[i][j] /= uii;
+			}
+		}
+		return X;
+	}
+	Matrix<_Td> Inverse() const
+	{
+		return Solve(I<_Td>(lu.RowSize()));
+	}
+};
+
+/**
+ * Cholesky factorization A = LL^T of a symmetric positive definite matrix,
+ *   blocked like LU but with half the work, only the lower triangle of A is read.
+ * Throws std::invalid_argument if A is not positive definite.
+ */
+template<typename _Td>
+class Cholesky {
+protected:
+	Matrix<_Td> l;
+
+	void Factorize()
+	{
+		const size_t n = l.RowSize();
+		for (size_t j0 = 0; j0 < n; j0 += DECOMPOSITION_BLOCK) {
+			const size_t jb = std::min(DECOMPOSITION_BLOCK, n - j0);
+			for (size_t j = j0; j < j0 + jb; ++j) {
+				_Td d = l[j][j];
+				for (size_t k = j0; k < j; ++k) {
+					d -= l[j][k] * l[j][k];
+				}
+				if (!(d > static_cast<_Td>(0))) {
+					throw std::invalid_argument("matrix is not positive definite");
+				}
+				const _Td ljj = std::sqrt(d);
+				l[j][j] = ljj;
+				for (size_t i = j + 1; i < j0 + jb; ++i) {
+					_Td s = l[i][j];
+					for (size_t k = j0; k < j; ++k) {
+						s -= l[i][k] * l[j][k];
+					}
+					l[i][j] = s / ljj;
+				}
+			}
+			const size_t rest = n - j0 - jb;
+			if (!rest) {
+				break;
+			}
+			// L21 = A21 L11^-T
+			for (size_t i = j0 + jb; i < n; ++i) {
+				for (size_t j = j0; j < j0 + jb; ++j) {
+					_Td s = l[i][j];
+					for (size_t k = j0; k < j; ++k) {
+						s -= l[i][k] * l[j][k];
+					}
+					l[i][j] = s / l[j][j];
+				}
+			}
+			// lower triangle of A22 -= L21 L21^T, one block row at a time
+			ConstMatrixView<_Td> l21 = static_cast<const Matrix<_Td> &>(l).SubMatrix(j0 + jb, j0, rest, jb);
+			for (size_t r = 0; r < rest; r += DECOMPOSITION_BLOCK) {
+				const size_t rb = std::min(DECOMPOSITION_BLOCK, rest - r);
+				MultiplyAdd(l.SubMatrix(j0 + jb + r, j0 + jb, rb, r + rb),
+				            l21.SubMatrix(r, 0, rb, jb), l21.SubMatrix(0, 0, r + rb, jb).TransposedView(), -1);
+			}
+		}
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t j = i + 1; j < n; ++j) {
+				l[i][j] = static_cast<_Td>(0);
+			}
+		}
+	}
+public:
+	template<typename _Tm, typename = typename EnableIfDense<_Tm, void>::type>
+	explicit Cholesky(const _Tm &A) : l(A)
+	{
+		if (A.RowSize() != A.ColSize()) {
+			throw std::invalid_argument("The row size and column size are different.");
+		}
+		Factorize();
+	}
+	inline const Matrix<_Td> & L() const
+	{
+		return l;
+	}
+	_Td Determinant() const
+	{
+		_Td det = static_cast<_Td>(1);
+		for (size_t i = 0; i < l.RowSize(); ++i) {
+			det *= l[i][i] * l[i][i];
+		}
+		return det;
+	}
+	template<typename _Tm>
+	typename EnableIfDense<_Tm, Matrix<_Td>>::type Solve(const _Tm &B) const
+	{
+		const size_t n = l.RowSize();
+		if (B.RowSize() != n) {
+			throw std::invalid_argument("different matrics\'s sizes");
+		}
+		const size_t m = B.ColSize();
+		Matrix<_Td> X(B);
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t k = 0; k < i; ++k) {
+				const _Td lik = l[i][k];
+				for (size_t j = 0; j < m; ++j) {
+					X[i][j] -= lik * X[k][j];
+				}
+			}
+			const _Td lii = l[i][i];
+			for (size_t j = 0; j < m; ++j) {
+				X[i][j] /= lii;
+			}
+		}
+		for (size_t i = n; i-- > 0; ) {
+			for (size_t k = i + 1; k < n; ++k) {
+				const _Td lki = l[k][i];
+				for (size_t j = 0; j < m; ++j) {
+					X[i][j] -= lki * X[k][j];
+				}
+			}
+			const _Td lii = l[i][i];
+			for (size_t j = 0; j < m; ++j) {
+				X[i][j] /= lii;
+			}
+		}
+		return X;
+	}
+	Matrix<_Td> Inverse() const
+	{
+		return Solve(I<_Td>(l.RowSize()));
+	}
+};
+
+template<typename _Tm>
+typename EnableIfDense<_Tm, typename _Tm::value_type>::type Determinant(const _Tm &A)
+{
+	return LU<typename _Tm::value_type>(A).Determinant();
+}
+
+template<typename _Tm>
+typename EnableIfDense<_Tm, Matrix<typename _Tm::value_type>>::type Inverse(const _Tm &A)
+{
+	return LU<typename _Tm::value_type>(A).Inverse();
+}
+
+/**
+ * X with AX = B.
+ */
+template<typename _Ma, typename _Mb>
+typename EnableIfDense2<_Ma, _Mb, Matrix<typename _Ma::value_type>>::type Solve(const _Ma &A, const _Mb &B)
+{
+	return LU<typename _Ma::value_type>(A).Solve(B);
+}
+
+}
+#endif
@@ -5,9 +5,43 @@
 #include <iomanip>
 #include <vector>
 #include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
 
 namespace Diamond {
 
+template<typename _Td> class Matrix;
+template<typename _Td> class ConstMatrixView;
+template<typename _Td> class MatrixView;
+
+/**
+ * Dense matrix-like types, i.e. the ones with RowSize(), ColSize() and [i][j] access.
+ * All the operators below accept any mix of them.
+ */
+template<typename _Tm>
+struct IsDenseMatrix : std::false_type {};
+template<typename _Td>
+struct IsDenseMatrix<Matrix<_Td>> : std::true_type {};
+template<typename _Td>
+struct IsDenseMatrix<ConstMatrixView<_Td>> : std::true_type {};
+template<typename _Td>
+struct IsDenseMatrix<MatrixView<_Td>> : std::true_type {};
+
+template<typename _Tm, typename _Tr, bool = IsDenseMatrix<_Tm>::value>
+struct EnableIfDense {};
+template<typename _Tm, typename _Tr>
+struct EnableIfDense<_Tm, _Tr, true> {
+	typedef _Tr type;
+};
+
+template<typename _Ma, typename _Mb, typename _Tr,
+         bool = IsDenseMatrix<_Ma>::value && IsDenseMatrix<_Mb>::value>
+struct EnableIfDense2 {};
+template<typename _Ma, typename _Mb, typename _Tr>
+struct EnableIfDense2<_Ma, _Mb, _Tr, true>
+	: std::enable_if<std::is_same<typename _Ma::value_type, typename _Mb::value_type>::value, _Tr> {};
+
 template<typename _Td>
 class Matrix {
 protected:
@@ -33,6 +67,7 @@ protected:
 		}
 	};
 public:
+	typedef _Td value_type;
 	Matrix() {};
 	Matrix(const size_t &_n_rows, const size_t &_n_cols)
 		: n_rows(_n_rows), n_cols(_n_cols), data(std::vector<std::vector<_Td>>(n_rows, std::vector<_Td>(n_cols))) {}
@@ -40,8 +75,27 @@ public:
 		: n_rows(_n_rows), n_cols(_n_cols), data(std::vector<std::vector<_Td>>(n_rows, std::vector<_Td>(n_cols, fillValue))) {}
 	Matrix(const Matrix<_Td> &mat)
 		: n_rows(mat.n_rows), n_cols(mat.n_cols), data(mat.data) {}
+	/**
+	 * The matrix moved from is left 0 x 0.
+	 */
 	Matrix(Matrix<_Td> &&mat) noexcept
-		: n_rows(mat.n_rows), n_cols(mat.n_cols), data(mat.data) {}
+		: n_rows(mat.n_rows), n_cols(mat.n_cols), data(std::move(mat.data))
+	{
+		mat.n_rows = mat.n_cols = 0;
+	}
+	/**
+	 * Copy the elements of a view (or any other dense matrix-like object).
+	 */
+	template<typename _Tm, typename = typename EnableIfDense<_Tm, void>::type>
+	explicit Matrix(const _Tm &mat)
+		: n_rows(mat.RowSize()), n_cols(mat.ColSize()), data(std::vector<std::vector<_Td>>(n_rows, std::vector<_Td>(n_cols)))
+	{
+		for (size_t i = 0; i < n_rows; ++i) {
+			for (size_t j = 0; j < n_cols; ++j) {
+				data[i][j] = mat[i][j];
+			}
+		}
+	}
 	Matrix<_Td> & operator=(const Matrix<_Td> &rhs)
 	{
 		this->n_rows = rhs.n_rows;
@@ -51,9 +105,13 @@ public:
 	}
 	Matrix<_Td> & operator=(Matrix<_Td> &&rhs)
 	{
+		if (this == &rhs) {
+			return *this;
+		}
 		this->n_rows = rhs.n_rows;
 		this->n_cols = rhs.n_cols;
-		this->data = rhs.data;
+		this->data = std::move(rhs.data);
+		rhs.n_rows = rhs.n_cols = 0;
 		return *this;
 	}
 	inline const size_t & RowSize() const
@@ -72,19 +130,262 @@ public:
 	{
 		return ConstRowProxy(this->data[Kth]);
 	}
+	/**
+	 * Non-owning views, see MatrixView below.
+	 * A view is invalidated when the matrix is assigned to or destroyed.
+	 */
+	MatrixView<_Td> View()
+	{
+		return MatrixView<_Td>(&data, n_rows, n_cols);
+	}
+	ConstMatrixView<_Td> View() const
+	{
+		return ConstMatrixView<_Td>(&data, n_rows, n_cols);
+	}
+	MatrixView<_Td> SubMatrix(const size_t &row, const size_t &col, const size_t &_n_rows, const size_t &_n_cols)
+	{
+		return View().SubMatrix(row, col, _n_rows, _n_cols);
+	}
+	ConstMatrixView<_Td> SubMatrix(const size_t &row, const size_t &col, const size_t &_n_rows, const size_t &_n_cols) const
+	{
+		return View().SubMatrix(row, col, _n_rows, _n_cols);
+	}
+	MatrixView<_Td> Slice(const size_t &row, const size_t &col, const size_t &_n_rows, const size_t &_n_cols,
+	                      const size_t &row_step, const size_t &col_step)
+	{
+		return View().Slice(row, col, _n_rows, _n_cols, row_step, col_step);
+	}
+	ConstMatrixView<_Td> Slice(const size_t &row, const size_t &col, const size_t &_n_rows, const size_t &_n_cols,
+	                           const size_t &row_step, const size_t &col_step) const
+	{
+		return View().Slice(row, col, _n_rows, _n_cols, row_step, col_step);
+	}
+	MatrixView<_Td> Row(const size_t &Kth)
+	{
+		return View().Row(Kth);
+	}
+	ConstMatrixView<_Td> Row(const size_t &Kth) const
+	{
+		return View().Row(Kth);
+	}
+	MatrixView<_Td> Col(const size_t &Kth)
+	{
+		return View().Col(Kth);
+	}
+	ConstMatrixView<_Td> Col(const size_t &Kth) const
+	{
+		return View().Col(Kth);
+	}
+	MatrixView<_Td> TransposedView()
+	{
+		return View().TransposedView();
+	}
+	ConstMatrixView<_Td> TransposedView() const
+	{
+		return View().TransposedView();
+	}
 	~Matrix() = default;
 };
 
 /**
- * Sum of two matrics.
+ * Read-only strided window into the storage of a Matrix.
+ * Element (i, j) of the view is element
+ *   (row_base + i * row_step, col_base + j * col_step) of the matrix,
+ *   or (row_base + j * row_step, col_base + i * col_step) if the view is transposed.
  */
 template<typename _Td>
-Matrix<_Td> operator+(const Matrix<_Td> &a, const Matrix<_Td> &b)
+class ConstMatrixView {
+protected:
+	typedef std::vector<std::vector<_Td>> Storage;
+	const Storage *rows = nullptr;
+	size_t n_rows = 0;
+	size_t n_cols = 0;
+	size_t row_base = 0;
+	size_t col_base = 0;
+	size_t row_step = 1;
+	size_t col_step = 1;
+	bool transposed = false;
+	class ConstRowProxy {
+		const ConstMatrixView<_Td> &view;
+		const size_t row;
+	public:
+		ConstRowProxy(const ConstMatrixView<_Td> &_view, const size_t &_row) : view(_view), row(_row) {}
+		const _Td & operator[](const size_t &pos) const
+		{
+			return view.At(row, pos);
+		}
+	};
+	ConstMatrixView(const Storage *_rows, const size_t &_n_rows, const size_t &_n_cols)
+		: rows(_rows), n_rows(_n_rows), n_cols(_n_cols) {}
+	friend class Matrix<_Td>;
+public:
+	typedef _Td value_type;
+	ConstMatrixView() {}
+	inline const size_t & RowSize() const
+	{
+		return n_rows;
+	}
+	inline const size_t & ColSize() const
+	{
+		return n_cols;
+	}
+	inline const _Td & At(const size_t &i, const size_t &j) const
+	{
+		return transposed ? (*rows)[row_base + j * row_step][col_base + i * col_step]
+		                  : (*rows)[row_base + i * row_step][col_base + j * col_step];
+	}
+	const ConstRowProxy operator[](const size_t &Kth) const
+	{
+		return ConstRowProxy(*this, Kth);
+	}
+	/**
+	 * The _n_rows x _n_cols window whose top-left element is (row, col) of this view,
+	 *   taking every row_step-th row and every col_step-th column.
+	 */
+	ConstMatrixView<_Td> Slice(const size_t &row, const size_t &col, const size_t &_n_rows, const size_t &_n_cols,
+	                           const size_t &_row_step, const size_t &_col_step) const
+	{
+		if (!_row_step || !_col_step) {
+			throw std::invalid_argument("zero step of a matrix view");
+		}
+		if ((_n_rows && row + (_n_rows - 1) * _row_step >= n_rows) || (!_n_rows && row > n_rows)
+		    || (_n_cols && col + (_n_cols - 1) * _col_step >= n_cols) || (!_n_cols && col > n_cols)) {
+			throw std::out_of_range("matrix view out of the matrix");
+		}
+		ConstMatrixView<_Td> res(*this);
+		res.n_rows = _n_rows;
+		res.n_cols = _n_cols;
+		if (transposed) {
+			res.row_base = row_base + col * row_step;
+			res.col_base = col_base + row * col_step;
+			res.row_step = row_step * _col_step;
+			res.col_step = col_step * _row_step;
+		} else {
+			res.row_base = row_base + row * row_step;
+			res.col_base = col_base + col * col_step;
+			res.row_step = row_step * _row_step;
+			res.col_step = col_step * _col_step;
+		}
+		return res;
+	}
+	ConstMatrixView<_Td> SubMatrix(const size_t &row, const size_t &col, const size_t &_n_rows, const size_t &_n_cols) const
+	{
+		return Slice(row, col, _n_rows, _n_cols, 1, 1);
+	}
+	ConstMatrixView<_Td> Row(const size_t &Kth) const
+	{
+		return SubMatrix(Kth, 0, 1, n_cols);
+	}
+	ConstMatrixView<_Td> Col(const size_t &Kth) const
+	{
+		return SubMatrix(0, Kth, n_rows, 1);
+	}
+	ConstMatrixView<_Td> TransposedView() const
+	{
+		ConstMatrixView<_Td> res(*this);
+		res.n_rows = n_cols;
+		res.n_cols = n_rows;
+		res.transposed = !transposed;
+		return res;
+	}
+};
+
+/**
+ * Writable view. Copying a view copies the window, not the elements;
+ *   assigning to a view writes the elements of the right hand side into the window.
+ */
+template<typename _Td>
+class MatrixView : public ConstMatrixView<_Td> {
+	typedef ConstMatrixView<_Td> Base;
+	class RowProxy {
+		const MatrixView<_Td> &view;
+		const size_t row;
+	public:
+		RowProxy(const MatrixView<_Td> &_view, const size_t &_row) : view(_view), row(_row) {}
+		_Td & operator[](const size_t &pos) const
+		{
+			return view.At(row, pos);
+		}
+	};
+	MatrixView(typename Base::Storage *_rows, const size_t &_n_rows, const size_t &_n_cols)
+		: Base(_rows, _n_rows, _n_cols) {}
+	explicit MatrixView(const Base &view) : Base(view) {}
+	friend class Matrix<_Td>;
+public:
+	MatrixView() {}
+	MatrixView(const MatrixView<_Td> &view) = default;
+	MatrixView<_Td> & operator=(const MatrixView<_Td> &rhs)
+	{
+		return Assign(rhs);
+	}
+	template<typename _Tm>
+	typename EnableIfDense<_Tm, MatrixView<_Td> &>::type operator=(const _Tm &rhs)
+	{
+		return Assign(rhs);
+	}
+	inline _Td & At(const size_t &i, const size_t &j) const
+	{
+		return const_cast<_Td &>(Base::At(i, j));
+	}
+	RowProxy operator[](const size_t &Kth) const
+	{
+		return RowProxy(*this, Kth);
+	}
+	void Fill(const _Td &value) const
+	{
+		for (size_t i = 0; i < this->n_rows; ++i) {
+			for (size_t j = 0; j < this->n_cols; ++j) {
+				At(i, j) = value;
+			}
+		}
+	}
+	MatrixView<_Td> Slice(const size_t &row, const size_t &col, const size_t &_n_rows, const size_t &_n_cols,
+	                      const size_t &_row_step, const size_t &_col_step) const
+	{
+		return MatrixView<_Td>(Base::Slice(row, col, _n_rows, _n_cols, _row_step, _col_step));
+	}
+	MatrixView<_Td> SubMatrix(const size_t &row, const size_t &col, const size_t &_n_rows, const size_t &_n_cols) const
+	{
+		return MatrixView<_Td>(Base::SubMatrix(row, col, _n_rows, _n_cols));
+	}
+	MatrixView<_Td> Row(const size_t &Kth) const
+	{
+		return MatrixView<_Td>(Base::Row(Kth));
+	}
+	MatrixView<_Td> Col(const size_t &Kth) const
+	{
+		return MatrixView<_Td>(Base::Col(Kth));
+	}
+	MatrixView<_Td> TransposedView() const
+	{
+		return MatrixView<_Td>(Base::TransposedView());
+	}
+private:
+	template<typename _Tm>
+	MatrixView<_Td> & Assign(const _Tm &rhs)
+	{
+		if (this->n_rows != rhs.RowSize() || this->n_cols != rhs.ColSize()) {
+			throw std::invalid_argument("different matrics\'s sizes");
+		}
+		for (size_t i = 0; i < this->n_rows; ++i) {
+			for (size_t j = 0; j < this->n_cols; ++j) {
+				At(i, j) = rhs[i][j];
+			}
+		}
+		return *this;
+	}
+};
+
+/**
+ * Sum of two matrics.
+ */
+template<typename _Ma, typename _Mb>
+typename EnableIfDense2<_Ma, _Mb, Matrix<typename _Ma::value_type>>::type operator+(const _Ma &a, const _Mb &b)
 {
 	if (a.RowSize() != b.RowSize() || a.ColSize() != b.ColSize()) {
 		throw std::invalid_argument("different matrics\'s sizes");
 	}
-	Matrix<_Td> c(a.RowSize(), a.ColSize());
+	Matrix<typename _Ma::value_type> c(a.RowSize(), a.ColSize());
 	for (size_t i = 0; i < a.RowSize(); ++i) {
 		for (size_t j = 0; j < a.ColSize(); ++j) {
 			c[i][j] = a[i][j] + b[i][j];
@@ -93,13 +394,13 @@ Matrix<_Td> operator+(const Matrix<_Td> &a, const Matrix<_Td> &b)
 	return c;
 }
 
-template<typename _Td>
-Matrix<_Td> operator-(const Matrix<_Td> &a, const Matrix<_Td> &b)
+template<typename _Ma, typename _Mb>
+typename EnableIfDense2<_Ma, _Mb, Matrix<typename _Ma::value_type>>::type operator-(const _Ma &a, const _Mb &b)
 {
 	if (a.RowSize() != b.RowSize() || a.ColSize() != b.ColSize()) {
 		throw std::invalid_argument("different matrics\'s sizes");
 	}
-	Matrix<_Td> c(a.RowSize(), a.ColSize());
+	Matrix<typename _Ma::value_type> c(a.RowSize(), a.ColSize());
 	for (size_t i = 0; i < a.RowSize(); ++i) {
 		for (size_t j = 0; j < a.ColSize(); ++j) {
 			c[i][j] = a[i][j] - b[i][j];
@@ -107,8 +408,8 @@ Matrix<_Td> operator-(const Matrix<_Td> &a, const Matrix<_Td> &b)
 	}
 	return c;
 }
-template<typename _Td>
-bool operator==(const Matrix<_Td> &a, const Matrix<_Td> &b)
+template<typename _Ma, typename _Mb>
+typename EnableIfDense2<_Ma, _Mb, bool>::type operator==(const _Ma &a, const _Mb &b)
 {
 	if (a.RowSize() != b.RowSize() || a.ColSize() != b.ColSize()) {
 		return false;
@@ -122,10 +423,10 @@ bool operator==(const Matrix<_Td> &a, const Matrix<_Td> &b)
 	return true;
 }
 
-template<typename _Td>
-Matrix<_Td> operator-(const Matrix<_Td> &mat)
+template<typename _Tm>
+typename EnableIfDense<_Tm, Matrix<typename _Tm::value_type>>::type operator-(const _Tm &mat)
 {
-	Matrix<_Td> result(mat.RowSize(), mat.ColSize());
+	Matrix<typename _Tm::value_type> result(mat.RowSize(), mat.ColSize());
 	for (size_t i = 0; i < mat.RowSize(); ++i) {
 		for (size_t j = 0; j < mat.ColSize(); ++j) {
 			result[i][j] = -mat[i][j];
@@ -145,33 +446,118 @@ Matrix<_Td> operator-(Matrix<_Td> &&mat)
 	return mat;
 }
 
+const size_t MULTIPLY_BLOCK = 64;
+
 /**
- * Multiplication of two matrics.
+ * c += alpha * a * b, the blocked kernel behind operator*.
+ * Each MULTIPLY_BLOCK square tile of a and b is packed into a contiguous buffer first,
+ *   so the inner loops run on plain arrays whatever the layout of the operands is.
+ * c must not overlap a or b.
  */
-template<typename _Td>
-Matrix<_Td> operator*(const Matrix<_Td> &a, const Matrix<_Td> &b)
+template<typename _Td, typename _Ma, typename _Mb>
+typename EnableIfDense2<_Ma, _Mb, void>::type MultiplyAdd(MatrixView<_Td> c, const _Ma &a, const _Mb &b,
+                                                        const typename MatrixView<_Td>::value_type &alpha = 1)
 {
-	if (a.ColSize() != b.RowSize()) {
+	if (a.ColSize() != b.RowSize() || c.RowSize() != a.RowSize() || c.ColSize() != b.ColSize()) {
 		throw std::invalid_argument("different matrics\'s sizes");
 	}
-	Matrix<_Td> c(a.RowSize(), b.ColSize(), 0);
-	for (size_t i = 0; i < a.RowSize(); ++i) {
-		for (size_t j = 0; j < b.ColSize(); ++j) {
-			for (size_t k = 0; k < a.ColSize(); ++k) {
-				c[i][j] += a[i][k] * b[k][j];
+	const size_t bs = MULTIPLY_BLOCK;
+	const size_t M = a.RowSize(), N = b.ColSize(), K = a.ColSize();
+	if (M * N * K <= bs * bs) {
+		// too small for packing to pay off
+		for (size_t i = 0; i < M; ++i) {
+			for (size_t k = 0; k < K; ++k) {
+				const _Td aik = alpha * a[i][k];
+				for (size_t j = 0; j < N; ++j) {
+					c.At(i, j) += aik * b[k][j];
+				}
+			}
+		}
+		return;
+	}
+	const size_t bm_max = std::min(bs, M), bn_max = std::min(bs, N), bk_max = std::min(bs, K);
+	std::vector<_Td> apack(bm_max * bk_max), bpack(bk_max * bn_max), ctile(bm_max * bn_max);
+	for (size_t j0 = 0; j0 < N; j0 += bs) {
+		const size_t bn = std::min(bs, N - j0);
+		for (size_t k0 = 0; k0 < K; k0 += bs) {
+			const size_t bk = std::min(bs, K - k0);
+			for (size_t k = 0; k < bk; ++k) {
+				for (size_t j = 0; j < bn; ++j) {
+					bpack[k * bn + j] = b[k0 + k][j0 + j];
+				}
+			}
+			for (size_t i0 = 0; i0 < M; i0 += bs) {
+				const size_t bm = std::min(bs, M - i0);
+				for (size_t i = 0; i < bm; ++i) {
+					for (size_t k = 0; k < bk; ++k) {
+						apack[i * bk + k] = alpha * a[i0 + i][k0 + k];
+					}
+				}
+				std::fill(ctile.begin(), ctile.begin() + bm * bn, static_cast<_Td>(0));
+				size_t i = 0;
+				// four rows of the tile at a time, so every row of bpack loaded is used four times
+				for (; i + 4 <= bm; i += 4) {
+					_Td *c0 = &ctile[i * bn], *c1 = c0 + bn, *c2 = c1 + bn, *c3 = c2 + bn;
+					for (size_t k = 0; k < bk; ++k) {
+						const _Td a0 = apack[i * bk + k], a1 = apack[(i + 1) * bk + k];
+						const _Td a2 = apack[(i + 2) * bk + k], a3 = apack[(i + 3) * bk + k];
+						const _Td *brow = &bpack[k * bn];
+						for (size_t j = 0; j < bn; ++j) {
+							c0[j] += a0 * brow[j];
+							c1[j] += a1 * brow[j];
+							c2[j] += a2 * brow[j];
+							c3[j] += a3 * brow[j];
+						}
+					}
+				}
+				for (; i < bm; ++i) {
+					_Td *crow = &ctile[i * bn];
+					for (size_t k = 0; k < bk; ++k) {
+						const _Td aik = apack[i * bk + k];
+						const _Td *brow = &bpack[k * bn];
+						for (size_t j = 0; j < bn; ++j) {
+							crow[j] += aik * brow[j];
+						}
+					}
+				}
+				for (size_t i = 0; i < bm; ++i) {
+					for (size_t j = 0; j < bn; ++j) {
+						c.At(i0 + i, j0 + j) += ctile[i * bn + j];
+					}
+				}
 			}
 		}
 	}
+}
+
+template<typename _Td, typename _Ma, typename _Mb>
+typename EnableIfDense2<_Ma, _Mb, void>::type MultiplyAdd(Matrix<_Td> &c, const _Ma &a, const _Mb &b,
+                                                        const typename Matrix<_Td>::value_type &alpha = 1)
+{
+	MultiplyAdd(c.View(), a, b, alpha);
+}
+
+/**
+ * Multiplication of two matrics.
+ */
+template<typename _Ma, typename _Mb>
+typename EnableIfDense2<_Ma, _Mb, Matrix<typename _Ma::value_type>>::type operator*(const _Ma &a, const _Mb &b)
+{
+	if (a.ColSize() != b.RowSize()) {
+		throw std::invalid_argument("different matrics\'s sizes");
+	}
+	Matrix<typename _Ma::value_type> c(a.RowSize(), b.ColSize(), 0);
+	MultiplyAdd(c.View(), a, b);
 	return c;
 }
 
 /**
  * Operations between a number and a matrix;
  */
-template<typename _Td>
-Matrix<_Td> operator*(const Matrix<_Td> &a, const _Td &b)
+template<typename _Tm>
+typename EnableIfDense<_Tm, Matrix<typename _Tm::value_type>>::type operator*(const _Tm &a, const typename _Tm::value_type &b)
 {
-	Matrix<_Td> c(a.RowSize(), a.ColSize());
+	Matrix<typename _Tm::value_type> c(a.RowSize(), a.ColSize());
 	for (size_t i = 0; i < a.RowSize(); ++i) {
 		for (size_t j = 0; j < a.ColSize(); ++j) {
 			c[i][j] = a[i][j] * b;
@@ -180,10 +566,10 @@ Matrix<_Td> operator*(const Matrix<_Td> &a, const _Td &b)
 	return c;
 }
 
-template<typename _Td>
-Matrix<_Td> operator*(const _Td &b, const Matrix<_Td> &a)
+template<typename _Tm>
+typename EnableIfDense<_Tm, Matrix<typename _Tm::value_type>>::type operator*(const typename _Tm::value_type &b, const _Tm &a)
 {
-	Matrix<_Td> c(a.RowSize(), a.ColSize());
+	Matrix<typename _Tm::value_type> c(a.RowSize(), a.ColSize());
 	for (size_t i = 0; i < a.RowSize(); ++i) {
 		for (size_t j = 0; j < a.ColSize(); ++j) {
 			c[i][j] = a[i][j] * b;
@@ -192,10 +578,10 @@ Matrix<_Td> operator*(const _Td &b, const Matrix<_Td> &a)
 	return c;
 }
 
-template<typename _Td>
-Matrix<_Td> operator/(const Matrix<_Td> &a, const double &b)
+template<typename _Tm>
+typename EnableIfDense<_Tm, Matrix<typename _Tm::value_type>>::type operator/(const _Tm &a, const double &b)
 {
-	Matrix<_Td> c(a.RowSize(), a.ColSize());
+	Matrix<typename _Tm::value_type> c(a.RowSize(), a.ColSize());
 	for (size_t i = 0; i < a.RowSize(); ++i) {
 		for (size_t j = 0; j < a.ColSize(); ++j) {
 			c[i][j] = a[i][j] / b;
@@ -204,10 +590,10 @@ Matrix<_Td> operator/(const Matrix<_Td> &a, const double &b)
 	return c;
 }
 
-template<typename _Td>
-Matrix<_Td> Transpose(const Matrix<_Td> &a)
+template<typename _Tm>
+typename EnableIfDense<_Tm, Matrix<typename _Tm::value_type>>::type Transpose(const _Tm &a)
 {
-	Matrix<_Td> res(a.ColSize(), a.RowSize());
+	Matrix<typename _Tm::value_type> res(a.ColSize(), a.RowSize());
 	for (size_t i = 0; i < a.ColSize(); ++i) {
 		for (size_t j = 0; j < a.RowSize(); ++j) {
 			res[i][j] = a[j][i];
@@ -216,8 +602,8 @@ Matrix<_Td> Transpose(const Matrix<_Td> &a)
 	return res;
 }
 
-template<typename _Td>
-std::ostream & operator<<(std::ostream &stream, const Matrix<_Td> &mat)
+template<typename _Tm>
+typename EnableIfDense<_Tm, std::ostream &>::type operator<<(std::ostream &stream, const _Tm &mat)
 {
 	std::ostream::fmtflags oldFlags = stream.flags();
 	stream.precision(8);
@@ -262,6 +648,12 @@ Matrix<_Td> Pow(Matrix<_Td> A, size_t &b)
 	return result;
 }
 
+template<typename _Td>
+Matrix<_Td> Pow(const ConstMatrixView<_Td> &A, size_t &b)
+{
+	return Pow(Matrix<_Td>(A), b);
+}
+
 }
 #endif
 
@@ -0,0 +1,321 @@
+#ifndef DIAMOND_SPARSE_MATRIX_HPP
+#define DIAMOND_SPARSE_MATRIX_HPP
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "class-matrix.hpp"
+
+namespace Diamond {
+
+/**
+ * A single non-zero entry, used to build a SparseMatrix in any order.
+ */
+template<typename _Td>
+struct SparseEntry {
+	size_t row;
+	size_t col;
+	_Td value;
+	SparseEntry(const size_t &_row, const size_t &_col, const _Td &_value)
+		: row(_row), col(_col), value(_value) {}
+};
+
+/**
+ * Compressed sparse row (CSR) matrix.
+ * The non-zeros of row i are values[row_ptr[i] .. row_ptr[i + 1]),
+ *   with their column indices strictly increasing in col_idx.
+ * The compressed sparse column form of a matrix is the CSR form of its transpose,
+ *   see Transpose() below.
+ */
+template<typename _Td>
+class SparseMatrix {
+protected:
+	size_t n_rows = 0;
+	size_t n_cols = 0;
+	std::vector<size_t> row_ptr;
+	std::vector<size_t> col_idx;
+	std::vector<_Td> values;
+public:
+	SparseMatrix() : row_ptr(1, 0) {}
+	SparseMatrix(const size_t &_n_rows, const size_t &_n_cols)
+		: n_rows(_n_rows), n_cols(_n_cols), row_ptr(_n_rows + 1, 0) {}
+	/**
+	 * Build from unordered entries, entries at the same position are summed up.
+	 */
+	SparseMatrix(const size_t &_n_rows, const size_t &_n_cols, std::vector<SparseEntry<_Td>> entries)
+		: n_rows(_n_rows), n_cols(_n_cols), row_ptr(_n_rows + 1, 0)
+	{
+		std::sort(entries.begin(), entries.end(), [](const SparseEntry<_Td> &a, const SparseEntry<_Td> &b) {
+			return a.row < b.row || (a.row == b.row && a.col < b.col);
+		});
+		col_idx.reserve(entries.size());
+		values.reserve(entries.size());
+		for (size_t p = 0; p < entries.size(); ++p) {
+			const SparseEntry<_Td> &e = entries[p];
+			if (e.row >= n_rows || e.col >= n_cols) {
+				throw std::out_of_range("sparse entry out of the matrix");
+			}
+			if (!values.empty() && row_ptr[e.row + 1] != 0 && col_idx.back() == e.col) {
+				values.back() += e.value;
+				continue;
+			}
+			col_idx.push_back(e.col);
+			values.push_back(e.value);
+			++row_ptr[e.row + 1];
+		}
+		for (size_t i = 0; i < n_rows; ++i) {
+			row_ptr[i + 1] += row_ptr[i];
+		}
+	}
+	/**
+	 * Conversion from a dense matrix, zero elements are dropped.
+	 */
+	explicit SparseMatrix(const Matrix<_Td> &mat)
+		: n_rows(mat.RowSize()), n_cols(mat.ColSize()), row_ptr(mat.RowSize() + 1, 0)
+	{
+		const _Td zero = static_cast<_Td>(0);
+		for (size_t i = 0; i < n_rows; ++i) {
+			for (size_t j = 0; j < n_cols; ++j) {
+				if (mat[i][j] != zero) {
+					col_idx.push_back(j);
+					values.push_back(mat[i][j]);
+				}
+			}
+			row_ptr[i + 1] = values.size();
+		}
+	}
+	SparseMatrix(const SparseMatrix<_Td> &mat) = default;
+	SparseMatrix(SparseMatrix<_Td> &&mat) noexcept
+		: n_rows(mat.n_rows), n_cols(mat.n_cols), row_ptr(std::move(mat.row_ptr)),
+		  col_idx(std::move(mat.col_idx)), values(std::move(mat.values)) {}
+	SparseMatrix<_Td> & operator=(const SparseMatrix<_Td> &rhs) = default;
+	SparseMatrix<_Td> & operator=(SparseMatrix<_Td> &&rhs) noexcept
+	{
+		this->n_rows = rhs.n_rows;
+		this->n_cols = rhs.n_cols;
+		this->row_ptr = std::move(rhs.row_ptr);
+		this->col_idx = std::move(rhs.col_idx);
+		this->values = std::move(rhs.values);
+		return *this;
+	}
+	inline const size_t & RowSize() const
+	{
+		return n_rows;
+	}
+	inline const size_t & ColSize() const
+	{
+		return n_cols;
+	}
+	inline size_t NonZeros() const
+	{
+		return values.size();
+	}
+	inline const std::vector<size_t> & RowPtr() const
+	{
+		return row_ptr;
+	}
+	inline const std::vector<size_t> & ColIdx() const
+	{
+		return col_idx;
+	}
+	inline const std::vector<_Td> & Values() const
+	{
+		return values;
+	}
+	/**
+	 * Random access in O(log(nnz of the row)), zero if the entry is not stored.
+	 */
+	_Td operator()(const size_t &row, const size_t &col) const
+	{
+		typename std::vector<size_t>::const_iterator first = col_idx.begin() + row_ptr[row];
+		typename std::vector<size_t>::const_iterator last = col_idx.begin() + row_ptr[row + 1];
+		typename std::vector<size_t>::const_iterator it = std::lower_bound(first, last, col);
+		if (it == last || *it != col) {
+			return static_cast<_Td>(0);
+		}
+		return values[it - col_idx.begin()];
+	}
+	Matrix<_Td> ToDense() const
+	{
+		Matrix<_Td> res(n_rows, n_cols, 0);
+		for (size_t i = 0; i < n_rows; ++i) {
+			for (size_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+				res[i][col_idx[p]] = values[p];
+			}
+		}
+		return res;
+	}
+	~SparseMatrix() = default;
+
+	template<typename _Tf>
+	friend SparseMatrix<_Tf> operator*(const SparseMatrix<_Tf> &a, const SparseMatrix<_Tf> &b);
+	template<typename _Tf>
+	friend SparseMatrix<_Tf> Transpose(const SparseMatrix<_Tf> &a);
+	template<typename _Tf>
+	friend SparseMatrix<_Tf> SparseI(const size_t &n);
+};
+
+/**
+ * Sparse times dense, O(nnz(a) * b.ColSize()).
+ */
+template<typename _Td>
+Matrix<_Td> operator*(const SparseMatrix<_Td> &a, const Matrix<_Td> &b)
+{
+	if (a.ColSize() != b.RowSize()) {
+		throw std::invalid_argument("different matrics\'s sizes");
+	}
+	const std::vector<size_t> &row_ptr = a.RowPtr();
+	const std::vector<size_t> &col_idx = a.ColIdx();
+	const std::vector<_Td> &values = a.Values();
+	Matrix<_Td> c(a.RowSize(), b.ColSize(), 0);
+	for (size_t i = 0; i < a.RowSize(); ++i) {
+		for (size_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+			const _Td &v = values[p];
+			const size_t &k = col_idx[p];
+			for (size_t j = 0; j < b.ColSize(); ++j) {
+				c[i][j] += v * b[k][j];
+			}
+		}
+	}
+	return c;
+}
+
+/**
+ * Dense times sparse, O(a.RowSize() * nnz(b)).
+ */
+template<typename _Td>
+Matrix<_Td> operator*(const Matrix<_Td> &a, const SparseMatrix<_Td> &b)
+{
+	if (a.ColSize() != b.RowSize()) {
+		throw std::invalid_argument("different matrics\'s sizes");
+	}
+	const std::vector<size_t> &row_ptr = b.RowPtr();
+	const std::vector<size_t> &col_idx = b.ColIdx();
+	const std::vector<_Td> &values = b.Values();
+	Matrix<_Td> c(a.RowSize(), b.ColSize(), 0);
+	for (size_t i = 0; i < a.RowSize(); ++i) {
+		for (size_t k = 0; k < b.RowSize(); ++k) {
+			const _Td &aik = a[i][k];
+			for (size_t p = row_ptr[k]; p < row_ptr[k + 1]; ++p) {
+				c[i][col_idx[p]] += aik * values[p];
+			}
+		}
+	}
+	return c;
+}
+
+/**
+ * Sparse times sparse (Gustavson's row-by-row algorithm).
+ * Each row of the result is accumulated in a dense buffer,
+ *   entries cancelled out to zero are not stored.
+ */
+template<typename _Td>
+SparseMatrix<_Td> operator*(const SparseMatrix<_Td> &a, const SparseMatrix<_Td> &b)
+{
+	if (a.ColSize() != b.RowSize()) {
+		throw std::invalid_argument("different matrics\'s sizes");
+	}
+	const _Td zero = static_cast<_Td>(0);
+	const size_t none = static_cast<size_t>(-1);
+	SparseMatrix<_Td> c(a.RowSize(), b.ColSize());
+	std::vector<_Td> acc(b.ColSize(), zero);
+	std::vector<size_t> mark(b.ColSize(), none);
+	std::vector<size_t> touched;
+	for (size_t i = 0; i < a.RowSize(); ++i) {
+		touched.clear();
+		for (size_t p = a.row_ptr[i]; p < a.row_ptr[i + 1]; ++p) {
+			const size_t &k = a.col_idx[p];
+			const _Td &v = a.values[p];
+			for (size_t q = b.row_ptr[k]; q < b.row_ptr[k + 1]; ++q) {
+				const size_t &j = b.col_idx[q];
+				if (mark[j] != i) {
+					mark[j] = i;
+					acc[j] = zero;
+					touched.push_back(j);
+				}
+				acc[j] += v * b.values[q];
+			}
+		}
+		std::sort(touched.begin(), touched.end());
+		for (size_t t = 0; t < touched.size(); ++t) {
+			const size_t &j = touched[t];
+			if (acc[j] != zero) {
+				c.col_idx.push_back(j);
+				c.values.push_back(acc[j]);
+			}
+		}
+		c.row_ptr[i + 1] = c.values.size();
+	}
+	return c;
+}
+
+template<typename _Td>
+SparseMatrix<_Td> Transpose(const SparseMatrix<_Td> &a)
+{
+	SparseMatrix<_Td> res(a.ColSize(), a.RowSize());
+	res.col_idx.resize(a.NonZeros());
+	res.values.resize(a.NonZeros());
+	for (size_t p = 0; p < a.NonZeros(); ++p) {
+		++res.row_ptr[a.col_idx[p] + 1];
+	}
+	for (size_t i = 0; i < res.n_rows; ++i) {
+		res.row_ptr[i + 1] += res.row_ptr[i];
+	}
+	std::vector<size_t> next(res.row_ptr.begin(), res.row_ptr.end() - 1);
+	for (size_t i = 0; i < a.RowSize(); ++i) {
+		for (size_t p = a.row_ptr[i]; p < a.row_ptr[i + 1]; ++p) {
+			size_t &pos = next[a.col_idx[p]];
+			res.col_idx[pos] = i;
+			res.values[pos] = a.values[p];
+			++pos;
+		}
+	}
+	return res;
+}
+
+template<typename _Td>
+SparseMatrix<_Td> SparseI(const size_t &n)
+{
+	SparseMatrix<_Td> res(n, n);
+	res.col_idx.resize(n);
+	res.values.assign(n, static_cast<_Td>(1));
+	for (size_t i = 0; i < n; ++i) {
+		res.col_idx[i] = i;
+		res.row_ptr[i + 1] = i + 1;
+	}
+	return res;
+}
+
+template<typename _Td>
+Matrix<_Td> ToDense(const SparseMatrix<_Td> &a)
+{
+	return a.ToDense();
+}
+
+template<typename _Td>
+SparseMatrix<_Td> ToSparse(const Matrix<_Td> &a)
+{
+	return SparseMatrix<_Td>(a);
+}
+
+template<typename _Td>
+SparseMatrix<_Td> Pow(SparseMatrix<_Td> A, size_t &b)
+{
+	if (A.RowSize() != A.ColSize()) {
+		throw std::invalid_argument("The row size and column size are different.");
+	}
+	SparseMatrix<_Td> result = SparseI<_Td>(A.ColSize());
+	while (b > 0) {
+		if (b & static_cast<size_t>(1)) {
+			result = result * A;
+		}
+		b = b >> static_cast<size_t>(1);
+		if (b > 0) {
+			A = A * A;
+		}
+	}
+	return result;
+}
+
+}
+#endif
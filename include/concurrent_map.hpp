@@ -0,0 +1,455 @@
+/**
+ * implement an ordered map shared by many threads
+ */
+#ifndef SJTU_CONCURRENT_MAP_HPP
+#define SJTU_CONCURRENT_MAP_HPP
+
+// only for std::less<T>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+namespace concurrent_detail {
+    // threads using concurrent containers at the same time
+    const int MAX_THREADS = 128;
+    const size_t CACHE_LINE = 64;
+
+    class spinlock {
+        std::atomic<bool> locked;
+    public:
+        spinlock(): locked(false) {}
+        void lock() {
+            while (locked.exchange(true, std::memory_order_acquire)) {
+                while (locked.load(std::memory_order_relaxed)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        void unlock() {
+            locked.store(false, std::memory_order_release);
+        }
+    };
+
+    /**
+     * A slot in [0, MAX_THREADS) owned by the calling thread until it exits,
+     *   throws runtime_error if more threads than that use the containers at once.
+     */
+    inline int thread_slot() {
+        static std::atomic<bool> used[MAX_THREADS];
+        struct holder {
+            int slot = -1;
+            ~holder() {
+                if (slot >= 0) {
+                    used[slot].store(false);
+                }
+            }
+        };
+        static thread_local holder self;
+        if (self.slot < 0) {
+            for (int i = 0; i < MAX_THREADS && self.slot < 0; ++i) {
+                bool expected = false;
+                if (used[i].compare_exchange_strong(expected, true)) {
+                    self.slot = i;
+                }
+            }
+            if (self.slot < 0) {
+                throw runtime_error();
+            }
+        }
+        return self.slot;
+    }
+
+    inline uint32_t random_bits() {
+        static thread_local uint32_t state = 2463534242u ^ static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
+
+/**
+ * Ordered map that any number of threads may use at once without an external lock,
+ *   as a lazy skip list (Herlihy, Lev, Luchangco and Shavit, "A Simple Optimistic Skiplist Algorithm"):
+ *   find() and the scans take no lock at all, insert() and erase() lock only
+ *   the predecessors of the node at each of its levels, after checking them optimistically.
+ * Erased nodes are freed by epoch based reclamation once no thread can still be reading them.
+ * The interface differs from sjtu::map as references could not outlive a concurrent erase():
+ *   find() copies the value out, the values cannot be changed in place,
+ *   and range() calls a function on each element instead of handing out iterators.
+ * The scans are weakly consistent, they see the elements present for their whole duration
+ *   and maybe some of those inserted or erased meanwhile, in key order.
+ */
+template<
+	class Key,
+	class T,
+	class Compare = std::less<Key>
+> class concurrent_map {
+private:
+    static const int MAX_LEVEL = 16;
+
+    struct alignas(std::atomic<void*>) node {
+        const Key key;
+        const T value;
+        const int levels;
+        std::atomic<bool> marked;
+        std::atomic<bool> fully_linked;
+        concurrent_detail::spinlock lock;
+
+        node(const Key &k, const T &v, int l): key(k), value(v), levels(l), marked(false), fully_linked(false) {}
+
+        // the links at each level are allocated right after the node
+        std::atomic<node*>* next() {
+            return reinterpret_cast<std::atomic<node*>*>(this + 1);
+        }
+
+        static node* create(const Key &k, const T &v, int levels) {
+            void* raw = ::operator new(sizeof(node) + levels * sizeof(std::atomic<node*>));
+            node* ret = new (raw) node(k, v, levels);
+            for (int i = 0; i < levels; ++i) {
+                new (ret->next() + i) std::atomic<node*>(nullptr);
+            }
+            return ret;
+        }
+
+        static void destroy(node* n) {
+            n->~node();
+            ::operator delete(n);
+        }
+    };
+
+    // nullptr stands for the head in the predecessors, the head is never marked
+    std::atomic<node*> head[MAX_LEVEL];
+    concurrent_detail::spinlock head_lock;
+    std::atomic<size_t> map_size;
+    Compare comp;
+
+    /**
+     * Epochs: a thread announces the global epoch when it starts an operation and 0 when it ends.
+     * A node unlinked when the epoch was e is only freed once every announced epoch is above e,
+     *   as those threads started after the unlink and cannot reach the node.
+     * Operations nest when a for_each or range callback uses the map, only the outermost one announces.
+     */
+    struct alignas(concurrent_detail::CACHE_LINE) thread_state {
+        std::atomic<uint64_t> epoch;
+        size_t depth;
+        std::vector<std::pair<uint64_t, node*>> retired;
+        thread_state(): epoch(0), depth(0) {}
+    };
+    std::atomic<uint64_t> global_epoch;
+    thread_state threads[concurrent_detail::MAX_THREADS];
+
+    static const size_t RECLAIM_EVERY = 64;
+
+    class guard {
+        thread_state &self;
+    public:
+        explicit guard(const concurrent_map* m):
+                self(const_cast<concurrent_map*>(m)->threads[concurrent_detail::thread_slot()]) {
+            if (self.depth++ == 0) {
+                self.epoch.store(m->global_epoch.load());
+            }
+        }
+        ~guard() {
+            if (--self.depth == 0) {
+                self.epoch.store(0, std::memory_order_release);
+            }
+        }
+    };
+
+    std::atomic<node*>* links(node* pred) {
+        return pred ? pred->next() : head;
+    }
+    const std::atomic<node*>* links(node* pred) const {
+        return pred ? pred->next() : head;
+    }
+
+    concurrent_detail::spinlock &lock_of(node* pred) {
+        return pred ? pred->lock : head_lock;
+    }
+
+    bool less(const node* n, const Key &key) const {
+        return comp(n->key, key);
+    }
+
+    /**
+     * fill the predecessor and the successor of key at every level,
+     * return the highest level where key was found, or -1.
+     */
+    int search(const Key &key, node** preds, node** succs) const {
+        int found = -1;
+        node* pred = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; --level) {
+            node* curr = links(pred)[level].load(std::memory_order_acquire);
+            while (curr && less(curr, key)) {
+                pred = curr;
+                curr = curr->next()[level].load(std::memory_order_acquire);
+            }
+            if (found == -1 && curr && !comp(key, curr->key)) {
+                found = level;
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        return found;
+    }
+
+    static int random_level() {
+        // P(levels > l) = 4^-l
+        uint32_t bits = concurrent_detail::random_bits() | (1u << (2 * (MAX_LEVEL - 1)));
+        return 1 + __builtin_ctz(bits) / 2;
+    }
+
+    void unlock_preds(node** preds, int highest) {
+        node* prev = reinterpret_cast<node*>(1);
+        for (int level = 0; level <= highest; ++level) {
+            if (preds[level] != prev) {
+                lock_of(preds[level]).unlock();
+                prev = preds[level];
+            }
+        }
+    }
+
+    void retire(node* n) {
+        thread_state &self = threads[concurrent_detail::thread_slot()];
+        self.retired.push_back(std::make_pair(global_epoch.load(), n));
+        if (self.retired.size() % RECLAIM_EVERY) {
+            return;
+        }
+
+        global_epoch.fetch_add(1);
+        uint64_t min = UINT64_MAX;
+        for (int i = 0; i < concurrent_detail::MAX_THREADS; ++i) {
+            uint64_t e = threads[i].epoch.load();
+            if (e && e < min) {
+                min = e;
+            }
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < self.retired.size(); ++i) {
+            if (self.retired[i].first < min) {
+                node::destroy(self.retired[i].second);
+            } else {
+                self.retired[kept++] = self.retired[i];
+            }
+        }
+        self.retired.resize(kept);
+    }
+
+public:
+	concurrent_map(): map_size(0), comp(), global_epoch(1) {
+        for (int i = 0; i < MAX_LEVEL; ++i) {
+            head[i].store(nullptr);
+        }
+    }
+	concurrent_map(const concurrent_map &other) = delete;
+	concurrent_map & operator=(const concurrent_map &other) = delete;
+
+	/**
+	 * no other thread may be using the map any more.
+	 */
+	~concurrent_map() {
+        node* n = head[0].load();
+        while (n) {
+            node* next = n->next()[0].load();
+            node::destroy(n);
+            n = next;
+        }
+        for (int i = 0; i < concurrent_detail::MAX_THREADS; ++i) {
+            for (size_t j = 0; j < threads[i].retired.size(); ++j) {
+                node::destroy(threads[i].retired[j].second);
+            }
+        }
+    }
+
+	/**
+	 * insert key with value, return false and leave the map unchanged if key is present.
+	 */
+	bool insert(const Key &key, const T &value) {
+        guard g(this);
+        const int top = random_level();
+        node* preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        while (true) {
+            int found = search(key, preds, succs);
+            if (found != -1) {
+                node* n = succs[found];
+                if (!n->marked.load()) {
+                    // present, or being inserted by another thread
+                    while (!n->fully_linked.load()) {
+                        std::this_thread::yield();
+                    }
+                    return false;
+                }
+                // being erased, try again once it is unlinked
+                continue;
+            }
+
+            int highest = -1;
+            bool valid = true;
+            node* prev = reinterpret_cast<node*>(1);
+            for (int level = 0; valid && level < top; ++level) {
+                node* pred = preds[level];
+                node* succ = succs[level];
+                if (pred != prev) {
+                    lock_of(pred).lock();
+                    prev = pred;
+                }
+                highest = level;
+                valid = (!pred || !pred->marked.load()) && (!succ || !succ->marked.load())
+                        && links(pred)[level].load() == succ;
+            }
+            if (!valid) {
+                unlock_preds(preds, highest);
+                continue;
+            }
+
+            node* n = node::create(key, value, top);
+            for (int level = 0; level < top; ++level) {
+                n->next()[level].store(succs[level], std::memory_order_relaxed);
+            }
+            for (int level = 0; level < top; ++level) {
+                links(preds[level])[level].store(n, std::memory_order_release);
+            }
+            n->fully_linked.store(true);
+            unlock_preds(preds, highest);
+            map_size.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+	/**
+	 * erase key, return false if it is not present.
+	 */
+	bool erase(const Key &key) {
+        guard g(this);
+        node* victim = nullptr;
+        bool is_marked = false;
+        int top = -1;
+        node* preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        while (true) {
+            int found = search(key, preds, succs);
+            if (!is_marked) {
+                if (found == -1) {
+                    return false;
+                }
+                victim = succs[found];
+                // only a fully linked node found at its top level can be erased
+                if (!victim->fully_linked.load() || victim->levels - 1 != found || victim->marked.load()) {
+                    return false;
+                }
+                top = victim->levels;
+                victim->lock.lock();
+                if (victim->marked.load()) {
+                    victim->lock.unlock();
+                    return false;
+                }
+                victim->marked.store(true);
+                is_marked = true;
+            }
+
+            int highest = -1;
+            bool valid = true;
+            node* prev = reinterpret_cast<node*>(1);
+            for (int level = 0; valid && level < top; ++level) {
+                node* pred = preds[level];
+                if (pred != prev) {
+                    lock_of(pred).lock();
+                    prev = pred;
+                }
+                highest = level;
+                valid = (!pred || !pred->marked.load()) && links(pred)[level].load() == victim;
+            }
+            if (!valid) {
+                unlock_preds(preds, highest);
+                continue;
+            }
+
+            for (int level = top - 1; level >= 0; --level) {
+                links(preds[level])[level].store(victim->next()[level].load(), std::memory_order_release);
+            }
+            victim->lock.unlock();
+            unlock_preds(preds, highest);
+            map_size.fetch_sub(1, std::memory_order_relaxed);
+            retire(victim);
+            return true;
+        }
+    }
+
+	/**
+	 * copy the value of key into value and return true, or return false if key is not present.
+	 */
+	bool find(const Key &key, T &value) const {
+        guard g(this);
+        node* preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        int found = search(key, preds, succs);
+        if (found == -1 || !succs[found]->fully_linked.load() || succs[found]->marked.load()) {
+            return false;
+        }
+        value = succs[found]->value;
+        return true;
+    }
+	/**
+	 * Returns the number of elements with key, either 1 or 0
+	 */
+	size_t count(const Key &key) const {
+        guard g(this);
+        node* preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        int found = search(key, preds, succs);
+        return found != -1 && succs[found]->fully_linked.load() && !succs[found]->marked.load();
+    }
+
+	/**
+	 * f(key, value) for the elements with lo <= key < hi, in key order.
+	 * f may find, insert or erase in this map too.
+	 */
+	template<class F>
+	void range(const Key &lo, const Key &hi, F f) const {
+        guard g(this);
+        node* preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        search(lo, preds, succs);
+        for (node* n = succs[0]; n && comp(n->key, hi); n = n->next()[0].load(std::memory_order_acquire)) {
+            if (n->fully_linked.load() && !n->marked.load()) {
+                f(n->key, n->value);
+            }
+        }
+    }
+	/**
+	 * f(key, value) for all the elements, in key order.
+	 * f may find, insert or erase in this map too.
+	 */
+	template<class F>
+	void for_each(F f) const {
+        guard g(this);
+        for (node* n = head[0].load(std::memory_order_acquire); n; n = n->next()[0].load(std::memory_order_acquire)) {
+            if (n->fully_linked.load() && !n->marked.load()) {
+                f(n->key, n->value);
+            }
+        }
+    }
+
+	/**
+	 * exact when no other thread is inserting or erasing.
+	 */
+	size_t size() const {
+        return map_size.load(std::memory_order_relaxed);
+    }
+	bool empty() const {
+        return !size();
+    }
+};
+}
+
+#endif
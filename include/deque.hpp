@@ -1,25 +1,30 @@
 #ifndef SJTU_DEQUE_HPP
 #define SJTU_DEQUE_HPP
 
+#include "alloc_stats.hpp"
 #include "exceptions.hpp"
 
 #include <cstddef>
+#include <utility>
 
 namespace sjtu { 
 
 template<class T>
 class deque {
-	struct node{
+	struct node : alloc_detail::counted<deque> {
 		node* prev;
 		node* next;
 		T* object;
 
 		node(): prev(nullptr), next(nullptr), object(nullptr) {};
 		node(node* _prev, node* _next, const T &obj):
-				prev(_prev), next(_next), object(new T(obj)) {};
+				prev(_prev), next(_next), object(new T(obj)) {
+			alloc_detail::counter<deque>::allocated(sizeof(T));
+		};
 		~node() {
 			if (object) {
 				delete object;
+				alloc_detail::counter<deque>::released(sizeof(T));
 			}
 		}
 	};
@@ -27,6 +32,9 @@ class deque {
 	size_t curr_size;
 	node* dummy_head;
 	node* dummy_tail;
+
+	// the parallel algorithms of parallel.hpp split the list of nodes
+	friend struct parallel_access;
 public:
 	class const_iterator;
 	class iterator {
@@ -67,7 +75,7 @@ public:
 		// return th distance between two iterator,
 		// if these two iterators points to different vectors, throw invaild_iterator.
 		int operator-(const iterator &rhs) const {
-			if(dq != rhs.dq) {
+			if(checked_access && dq != rhs.dq) {
 				throw invalid_iterator();
 			}
 			node* lptr = ptr;
@@ -136,13 +144,13 @@ public:
 		}
 
 		T& operator*() const {
-			if (!ptr->object) {
+			if (checked_access && !ptr->object) {
 				throw invalid_iterator();
 			}
 			return *ptr->object;
 		}
 		T* operator->() const noexcept {
-			if (!ptr->object) {
+			if (checked_access && !ptr->object) {
 				throw invalid_iterator();
 			}
 			return ptr->object;
@@ -210,7 +218,7 @@ public:
 			}
 
 			int operator-(const const_iterator& rhs) {
-				if(dq != rhs.dq) {
+				if(checked_access && dq != rhs.dq) {
 					throw invalid_iterator();
 				}
 				node* lptr = ptr;
@@ -282,14 +290,14 @@ public:
 			}
 
 			const T& operator*() const {
-				if (!ptr->object) {
+				if (checked_access && !ptr->object) {
 					throw invalid_iterator();
 				}
 				return *ptr->object;
 			}
 
 			const T* operator->() const noexcept {
-				if (!ptr->object) {
+				if (checked_access && !ptr->object) {
 					throw invalid_iterator();
 				}
 				return ptr->object;
@@ -368,11 +376,37 @@ public:
 		const_iterator cit = cbegin() +  pos;
 		return *cit;
 	}
+	/**
+	 * access specified element with bounds checking
+	 * return nullptr instead of throwing if out of bound.
+	 */
+	T * try_at(const size_t &pos) {
+		if (curr_size <= pos) {
+			return nullptr;
+		}
+		return &*(begin() + pos);
+	}
+	const T * try_at(const size_t &pos) const {
+		if (curr_size <= pos) {
+			return nullptr;
+		}
+		return &*(cbegin() + pos);
+	}
+	/**
+	 * access specified element
+	 * checked like at(), unless SJTU_UNCHECKED is defined.
+	 */
 	T & operator[](const size_t &pos) {
-		return at(pos);
+		if (checked_access) {
+			return at(pos);
+		}
+		return *(begin() + pos);
 	}
 	const T & operator[](const size_t &pos) const {
-		return at(pos);
+		if (checked_access) {
+			return at(pos);
+		}
+		return *(cbegin() + pos);
 	}
 	/**
 	 * access the first element
@@ -426,6 +460,16 @@ public:
 	size_t size() const {
 		return curr_size;
 	}
+	/**
+	 * the nodes and elements allocated by all the deques of this type,
+	 *   all zero unless SJTU_COUNT_ALLOCATIONS is defined, see alloc_stats.hpp.
+	 */
+	static alloc_stats allocation_stats() {
+		return alloc_detail::counter<deque>::stats();
+	}
+	static void reset_allocation_peak() {
+		alloc_detail::counter<deque>::reset_peak();
+	}
 	/**
 	 * clears the contents
 	 */
@@ -508,6 +552,29 @@ public:
 		--curr_size;
 		delete back;
 	}
+	/**
+	 * removes the last element
+	 *     return false instead of throwing when the container is empty.
+	 */
+	bool try_pop_back() {
+		if (!curr_size) {
+			return false;
+		}
+		pop_back();
+		return true;
+	}
+	/**
+	 * moves the last element into value and removes it
+	 *     return false, leaving value untouched, when the container is empty.
+	 */
+	bool try_pop_back(T &value) {
+		if (!curr_size) {
+			return false;
+		}
+		value = std::move(*dummy_tail->prev->object);
+		pop_back();
+		return true;
+	}
 	/**
 	 * inserts an element to the beginning.
 	 */
@@ -536,6 +603,29 @@ public:
 		delete front;
 		--curr_size;
 	}
+	/**
+	 * removes the first element.
+	 *     return false instead of throwing when the container is empty.
+	 */
+	bool try_pop_front() {
+		if (!curr_size) {
+			return false;
+		}
+		pop_front();
+		return true;
+	}
+	/**
+	 * moves the first element into value and removes it
+	 *     return false, leaving value untouched, when the container is empty.
+	 */
+	bool try_pop_front(T &value) {
+		if (!curr_size) {
+			return false;
+		}
+		value = std::move(*dummy_head->next->object);
+		pop_front();
+		return true;
+	}
 };
 
 }
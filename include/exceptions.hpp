@@ -2,63 +2,70 @@
 #define SJTU_EXCEPTIONS_HPP
 
 #include <cstddef>
-#include <cstring>
-#include <string>
+#include <exception>
 
 namespace sjtu
 {
-    
-    class exception
+
+    /**
+     * Defining SJTU_UNCHECKED before including the containers turns off the validation
+     *   done by deque::operator[] and by the iterators of deque and map, for release builds.
+     * at(), insert(), erase() and the pops keep their checks.
+     * Every translation unit of a program must agree on it.
+     */
+#ifdef SJTU_UNCHECKED
+    constexpr bool checked_access = false;
+#else
+    constexpr bool checked_access = true;
+#endif
+
+    /**
+     * Both strings are only pointed to, never copied, so constructing, copying
+     *   and throwing an exception does not allocate.
+     * The optional variant passed to the constructors must outlive the exception,
+     *   a string literal is the intended use.
+     */
+    class exception : public std::exception
     {
     protected:
-        const std::string variant = "";
-        std::string detail = "";
+        const char *variant = "";
+        const char *detail = "";
+        exception(const char *_variant, const char *_detail) noexcept : variant(_variant), detail(_detail) {}
     public:
-        exception() {}
-        exception(const exception &ec) : variant(ec.variant), detail(ec.detail){}
-        virtual std::string what()
+        exception() noexcept {}
+        exception(const exception &ec) noexcept = default;
+        exception &operator=(const exception &ec) noexcept = default;
+        virtual const char *what() const noexcept override
         {
-            return variant + " " + detail;
+            return detail;
+        }
+        const char *where() const noexcept
+        {
+            return variant;
         }
     };
     class index_out_of_bound : public exception
     {
-    protected:
-        const std::string variant;
     public:
-        index_out_of_bound(const std::string &ec = std :: string("")) : variant(ec) { detail = "error : index out of bound.";}
-        
-        virtual std::string what() { return variant + " " + detail;}
+        index_out_of_bound(const char *ec = "") noexcept : exception(ec, "error : index out of bound.") {}
     };
-    
+
     class runtime_error : public exception
     {
-    protected:
-        const std::string variant;
     public:
-        runtime_error(const std::string &ec = std :: string("")) : variant(ec) { detail = "error : runtime error.";}
-        
-        virtual std::string what() { return variant + " " + detail;}
+        runtime_error(const char *ec = "") noexcept : exception(ec, "error : runtime error.") {}
     };
-    
+
     class invalid_iterator : public exception
     {
-    protected:
-        const std::string variant;
     public:
-        invalid_iterator(const std::string &ec = std :: string("")) : variant(ec) { detail = "error : invalid iterator.";}
-        
-        virtual std::string what() { return variant + " " + detail;}
+        invalid_iterator(const char *ec = "") noexcept : exception(ec, "error : invalid iterator.") {}
     };
-    
+
     class container_is_empty : public exception
     {
-    protected:
-        const std::string variant;
     public:
-        container_is_empty(const std::string &ec = std :: string("")) : variant(ec) { detail = "error : container is empty.";}
-        
-        virtual std::string what() { return variant + " " + detail;}
+        container_is_empty(const char *ec = "") noexcept : exception(ec, "error : container is empty.") {}
     };
 }
 
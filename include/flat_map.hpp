@@ -0,0 +1,473 @@
+/**
+ * implement a sorted map in contiguous storage
+ */
+#ifndef SJTU_FLAT_MAP_HPP
+#define SJTU_FLAT_MAP_HPP
+
+// only for std::less<T>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * Ordered map for tables built once and queried many times, with the lookup interface of sjtu::map.
+ * The keys and the values are kept sorted in two arrays, so a map of ints takes
+ *   16 bytes per element, counting the search index, against about 56 for sjtu::map.
+ * Lookups do not binary search the sorted keys but a copy of them in Eytzinger order,
+ *   the implicit binary tree stored breadth first: the next nodes of a search are adjacent,
+ *   so they are prefetched together, and the loop is branchless.
+ * Inserting or erasing one element costs O(n), insert(first, last) adds a whole batch in one merge.
+ * Inserting and erasing invalidate all iterators and pointers to elements.
+ */
+template<
+	class Key,
+	class T,
+	class Compare = std::less<Key>
+> class flat_map {
+public:
+    typedef pair<const Key, T> value_type;
+    // what the iterators point at, the key and the value live in different arrays
+    typedef pair<const Key &, T &> reference;
+    typedef pair<const Key &, const T &> const_reference;
+
+private:
+    std::vector<Key> keys;
+    std::vector<T> values;
+    // eytz[k] is keys[rank[k]], the children of k are 2k and 2k + 1, eytz[0] is unused
+    std::vector<Key> eytz;
+    std::vector<uint32_t> rank;
+    Compare comp;
+
+    // operator-> of the iterators, the pair they point at is a temporary
+    template<class Ref>
+    struct arrow {
+        Ref ref;
+        const Ref* operator->() const {
+            return &ref;
+        }
+    };
+
+public:
+	/**
+	 * see BidirectionalIterator at CppReference for help.
+	 *
+	 * if there is anything wrong throw invalid_iterator.
+	 *     like it = map.begin(); --it;
+	 *       or it = map.end(); ++end();
+	 * no check is done if SJTU_UNCHECKED is defined, see exceptions.hpp.
+	 */
+	class const_iterator;
+	class iterator {
+        friend class flat_map;
+        friend class const_iterator;
+		flat_map* this_map;
+        size_t index;
+	public:
+		iterator():this_map(nullptr), index(0) {}
+        iterator(flat_map* m, size_t i): this_map(m), index(i) {}
+		iterator(const iterator &other) = default;
+
+		iterator operator++(int) {
+            iterator ret {*this};
+            ++*this;
+            return ret;
+        }
+		iterator & operator++() {
+            if (checked_access && (!this_map || index >= this_map->size())) {
+                throw invalid_iterator();
+            }
+
+            ++index;
+            return *this;
+        }
+		iterator operator--(int) {
+            iterator ret {*this};
+            --*this;
+            return ret;
+        }
+		iterator & operator--() {
+            if (checked_access && (!this_map || index == 0)) {
+                throw invalid_iterator();
+            }
+
+            --index;
+            return *this;
+        }
+
+		reference operator*() const {
+            return reference(this_map->keys[index], this_map->values[index]);
+        }
+        arrow<reference> operator->() const {
+            return arrow<reference> {**this};
+        }
+
+		bool operator==(const iterator &rhs) const {
+            return this_map == rhs.this_map && index == rhs.index;
+        }
+		bool operator==(const const_iterator &rhs) const {
+            return rhs == *this;
+        }
+
+		bool operator!=(const iterator &rhs) const {
+            return this_map != rhs.this_map || index != rhs.index;
+        }
+		bool operator!=(const const_iterator &rhs) const {
+            return rhs != *this;
+        }
+	};
+	class const_iterator {
+    private:
+        const flat_map* this_map;
+        size_t index;
+    public:
+        const_iterator():this_map(nullptr), index(0) {}
+        const_iterator(const flat_map* m, size_t i): this_map(m), index(i) {}
+        const_iterator(const const_iterator &other) = default;
+        const_iterator(const iterator &other): this_map(other.this_map), index(other.index) {}
+
+        const_iterator operator++(int) {
+            const_iterator ret {*this};
+            ++*this;
+            return ret;
+        }
+        const_iterator& operator++() {
+            if (checked_access && (!this_map || index >= this_map->size())) {
+                throw invalid_iterator();
+            }
+
+            ++index;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator ret {*this};
+            --*this;
+            return ret;
+        }
+        const_iterator& operator--() {
+            if (checked_access && (!this_map || index == 0)) {
+                throw invalid_iterator();
+            }
+
+            --index;
+            return *this;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return this_map == rhs.this_map && index == rhs.index;
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return this_map == rhs.this_map && index == rhs.index;
+        }
+
+        bool operator!=(const iterator &rhs) const {
+            return this_map != rhs.this_map || index != rhs.index;
+        }
+        bool operator!=(const const_iterator &rhs) const {
+            return this_map != rhs.this_map || index != rhs.index;
+        }
+
+        const_reference operator*() const {
+            return const_reference(this_map->keys[index], this_map->values[index]);
+        }
+        arrow<const_reference> operator->() const {
+            return arrow<const_reference> {**this};
+        }
+	};
+
+	flat_map(): comp() {}
+	flat_map(const flat_map &other) = default;
+	flat_map & operator=(const flat_map &other) = default;
+	/**
+	 * build the map from the elements in [first, last) at once, for a duplicated key the first one is kept.
+	 */
+	template<class InputIt>
+	flat_map(InputIt first, InputIt last): comp() {
+        insert(first, last);
+    }
+
+private:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    // rank[k] for the subtree of k, filled in order from next
+    void build_rank(size_t k, size_t &next) {
+        // recursive on the left child, a loop on the right one
+        while (k < rank.size()) {
+            size_t left = 2 * k;
+            build_rank(left, next);
+            rank[k] = static_cast<uint32_t>(next++);
+            k = 2 * k + 1;
+        }
+    }
+
+    void rebuild_index() {
+        const size_t n = keys.size();
+        if (n > UINT32_MAX) {
+            throw runtime_error();
+        }
+        eytz.clear();
+        rank.assign(n ? n + 1 : 0, 0);
+        if (!n) {
+            return;
+        }
+
+        size_t next = 0;
+        build_rank(1, next);
+        eytz.reserve(n + 1);
+        eytz.push_back(keys[0]);
+        for (size_t k = 1; k <= n; ++k) {
+            eytz.push_back(keys[rank[k]]);
+        }
+    }
+
+    /**
+     * the index in keys of the first key not less than key (Lower) or greater than key (!Lower).
+     * The search goes down the Eytzinger tree to a leaf, adding a bit to k at each level,
+     *   the answer is the last node where it went left, found by dropping the trailing ones of k.
+     */
+    template<bool Lower>
+    size_t search(const Key &key) const {
+        const size_t n = keys.size();
+        const Key* tree = eytz.data();
+        size_t k = 1;
+        while (k <= n) {
+            // the 16 nodes four levels below k are adjacent
+            __builtin_prefetch(tree + std::min(16 * k, n));
+            k = 2 * k + (Lower ? comp(tree[k], key) : !comp(key, tree[k]));
+        }
+        k >>= __builtin_ffsll(~static_cast<unsigned long long>(k));
+        return k ? rank[k] : n;
+    }
+
+    size_t find_index(const Key &key) const {
+        size_t i = search<true>(key);
+
+        return i < keys.size() && !comp(key, keys[i]) ? i : npos;
+    }
+
+public:
+
+	/**
+	 * Returns a reference to the mapped value
+	 * an exception of type `index_out_of_bound'
+	 */
+	T & at(const Key &key) {
+        size_t i = find_index(key);
+
+        if (i == npos) {
+            throw index_out_of_bound();
+        }
+
+        return values[i];
+    }
+	const T & at(const Key &key) const {
+        size_t i = find_index(key);
+
+        if (i == npos) {
+            throw index_out_of_bound();
+        }
+
+        return values[i];
+    }
+	/**
+	 * Returns a pointer to the mapped value, or nullptr if such key does not exist.
+	 *   It is valid until the next insertion or erasure.
+	 */
+	T * find_ptr(const Key &key) {
+        size_t i = find_index(key);
+
+        return i == npos ? nullptr : &values[i];
+    }
+	const T * find_ptr(const Key &key) const {
+        size_t i = find_index(key);
+
+        return i == npos ? nullptr : &values[i];
+    }
+
+	/**
+	 * access specified element
+	 *   performing an insertion if such key does not already exist.
+	 */
+	T & operator[](const Key &key) {
+        size_t i = search<true>(key);
+
+        if (i == keys.size() || comp(key, keys[i])) {
+            keys.insert(keys.begin() + i, key);
+            values.insert(values.begin() + i, T());
+            rebuild_index();
+        }
+
+        return values[i];
+    }
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const {
+        return at(key);
+    }
+
+	iterator begin() {
+        return iterator(this, 0);
+    }
+	const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+	const_iterator cbegin() const {
+        return const_iterator(this, 0);
+    }
+
+	iterator end() {
+        return iterator(this, keys.size());
+    }
+	const_iterator end() const {
+        return const_iterator(this, keys.size());
+    }
+	const_iterator cend() const {
+        return const_iterator(this, keys.size());
+    }
+
+	bool empty() const {
+        return keys.empty();
+    }
+
+	size_t size() const {
+        return keys.size();
+    }
+
+	void clear() {
+        keys.clear();
+        values.clear();
+        eytz.clear();
+        rank.clear();
+    }
+
+	/**
+	 * insert an element.
+	 * return a pair, the first of the pair is
+	 *   the iterator to the new element (or the element that prevented the insertion),
+	 *   the second one is true if insert successfully, or false.
+	 */
+	pair<iterator, bool> insert(value_type value) {
+        size_t i = search<true>(value.first);
+
+        if (i < keys.size() && !comp(value.first, keys[i])) {
+            return pair<iterator, bool>(iterator(this, i), false);
+        }
+
+        keys.insert(keys.begin() + i, value.first);
+        values.insert(values.begin() + i, std::move(value.second));
+        rebuild_index();
+        return pair<iterator, bool>(iterator(this, i), true);
+    }
+
+	/**
+	 * insert the elements of [first, last), each a pair of key and value, in O((n + m) log m)
+	 *   for m new elements: they are sorted, then merged with the present ones.
+	 * Like insert(), a key already present or earlier in the batch is not overwritten.
+	 */
+	template<class InputIt>
+	void insert(InputIt first, InputIt last) {
+        std::vector<Key> batch_keys;
+        std::vector<T> batch_values;
+        for (; first != last; ++first) {
+            batch_keys.push_back((*first).first);
+            batch_values.push_back((*first).second);
+        }
+
+        // stable, so the first of equal keys comes first
+        std::vector<size_t> order(batch_keys.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return comp(batch_keys[a], batch_keys[b]);
+        });
+
+        std::vector<Key> merged_keys;
+        std::vector<T> merged_values;
+        merged_keys.reserve(keys.size() + order.size());
+        merged_values.reserve(keys.size() + order.size());
+        size_t i = 0, j = 0;
+        while (i < keys.size() || j < order.size()) {
+            if (j == order.size() || (i < keys.size() && !comp(batch_keys[order[j]], keys[i]))) {
+                // keys[i] comes first, the batch elements equal to it are dropped
+                while (j < order.size() && !comp(keys[i], batch_keys[order[j]])) {
+                    ++j;
+                }
+                merged_keys.push_back(std::move(keys[i]));
+                merged_values.push_back(std::move(values[i]));
+                ++i;
+            } else {
+                size_t first_equal = order[j];
+                while (j < order.size() && !comp(batch_keys[first_equal], batch_keys[order[j]])) {
+                    ++j;
+                }
+                merged_keys.push_back(std::move(batch_keys[first_equal]));
+                merged_values.push_back(std::move(batch_values[first_equal]));
+            }
+        }
+        keys.swap(merged_keys);
+        values.swap(merged_values);
+        rebuild_index();
+    }
+
+	/**
+	 * erase the element at pos.
+	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+	 */
+	void erase(iterator pos) {
+        if (pos.this_map != this || pos.index >= keys.size()) {
+            throw index_out_of_bound();
+        }
+
+        keys.erase(keys.begin() + pos.index);
+        values.erase(values.begin() + pos.index);
+        rebuild_index();
+    }
+	/**
+	 * Returns the number of elements with key, either 1 or 0
+	 */
+	size_t count(const Key &key) const {
+        return find_index(key) == npos ? 0 : 1;
+    }
+	/**
+	 * Finds an element with key equivalent to key.
+	 *   If no such element is found, past-the-end (see end()) iterator is returned.
+	 */
+	iterator find(const Key &key) {
+        size_t i = find_index(key);
+
+        return iterator(this, i == npos ? keys.size() : i);
+    }
+	const_iterator find(const Key &key) const {
+        size_t i = find_index(key);
+
+        return const_iterator(this, i == npos ? keys.size() : i);
+    }
+	/**
+	 * the first element whose key is not less than key, or end().
+	 */
+	iterator lower_bound(const Key &key) {
+        return iterator(this, search<true>(key));
+    }
+	const_iterator lower_bound(const Key &key) const {
+        return const_iterator(this, search<true>(key));
+    }
+	/**
+	 * the first element whose key is greater than key, or end().
+	 */
+	iterator upper_bound(const Key &key) {
+        return iterator(this, search<false>(key));
+    }
+	const_iterator upper_bound(const Key &key) const {
+        return const_iterator(this, search<false>(key));
+    }
+};
+}
+
+#endif
@@ -7,6 +7,7 @@
 // only for std::less<T>
 #include <functional>
 #include <cstddef>
+#include "alloc_stats.hpp"
 #include "utility.hpp"
 #include "exceptions.hpp"
 
@@ -21,14 +22,15 @@ public:
     typedef pair<const Key, T> value_type;
 
 private:
-    struct node {
+    struct node : alloc_detail::counted<map> {
         node* left;
         node* right;
         node* parent;
         int height;
         value_type value;
-        node(node* p, const value_type& v):
-                left(nullptr), right(nullptr), parent(p), height(1), value(v) {}
+        template<class... Args, class = typename std::enable_if<std::is_constructible<value_type, Args&&...>::value>::type>
+        node(node* p, Args&&... args):
+                left(nullptr), right(nullptr), parent(p), height(1), value(std::forward<Args>(args)...) {}
         node(node* l, node* r, int h, const value_type& v):
             left(l), right(r), parent(nullptr), height(h), value(v) {};
 
@@ -96,6 +98,9 @@ private:
     node* root;
     Compare comp;
 
+    // the parallel algorithms of parallel.hpp split the tree into subtrees
+    friend struct parallel_access;
+
 public:
 	/**
 	 * see BidirectionalIterator at CppReference for help.
@@ -103,6 +108,7 @@ public:
 	 * if there is anything wrong throw invalid_iterator.
 	 *     like it = map.begin(); --it;
 	 *       or it = map.end(); ++end();
+	 * no check is done if SJTU_UNCHECKED is defined, see exceptions.hpp.
 	 */
 	class const_iterator;
 	class iterator {
@@ -116,7 +122,7 @@ public:
 		iterator(const iterator &other) = default;
 
 		iterator operator++(int) {
-            if (!this_node) {
+            if (checked_access && !this_node) {
                 throw invalid_iterator();
             }
 
@@ -134,7 +140,7 @@ public:
             return ret;
         }
 		iterator & operator++() {
-            if (!this_node) {
+            if (checked_access && !this_node) {
                 throw invalid_iterator();
             }
 
@@ -151,7 +157,7 @@ public:
         }
 
 		iterator operator--(int) {
-            if (*this == this_map->begin() ) {
+            if (checked_access && *this == this_map->begin()) {
                 throw invalid_iterator();
             }
 
@@ -181,7 +187,7 @@ public:
             return ret;
         }
 		iterator & operator--() {
-            if (*this == this_map->begin() ) {
+            if (checked_access && *this == this_map->begin()) {
                 throw invalid_iterator();
             }
 
@@ -247,7 +253,7 @@ public:
         }
 
         const_iterator operator++(int) {
-            if (!this_node) {
+            if (checked_access && !this_node) {
                 throw invalid_iterator();
             }
 
@@ -265,7 +271,7 @@ public:
             return ret;
         }
         const_iterator& operator++() {
-            if (!this_node) {
+            if (checked_access && !this_node) {
                 throw invalid_iterator();
             }
 
@@ -281,7 +287,7 @@ public:
         }
 
         const_iterator operator--(int) {
-            if (*this == this_map->cbegin() ) {
+            if (checked_access && *this == this_map->cbegin()) {
                 throw invalid_iterator();
             }
 
@@ -312,7 +318,7 @@ public:
         }
         const_iterator& operator--() {
 
-            if (*this == this_map->cbegin()) {
+            if (checked_access && *this == this_map->cbegin()) {
                 throw invalid_iterator();
             }
 
@@ -368,6 +374,10 @@ public:
         comp = other.comp;
         map_size = other.map_size;
     }
+	map(map &&other) : map_size(other.map_size), root(other.root), comp(other.comp) {
+        other.root = nullptr;
+        other.map_size = 0;
+    }
 
 	map & operator=(const map &other) {
         if (this == &other) {
@@ -380,6 +390,21 @@ public:
         comp = other.comp;
         map_size = other.map_size;
 
+        return *this;
+    }
+	map & operator=(map &&other) {
+        if (this == &other) {
+            return *this;
+        }
+
+        clear();
+
+        root = other.root;
+        comp = other.comp;
+        map_size = other.map_size;
+        other.root = nullptr;
+        other.map_size = 0;
+
         return *this;
     }
 
@@ -388,16 +413,18 @@ public:
     }
 
 private:
-    node* insert_helper(const value_type value) {
+    // the value is constructed in the new node from args, so nothing is copied if key is present
+    template<class... Args>
+    node* insert_helper(const Key &key, Args&&... args) {
         node* hot;
-        node* &to_insert = search_node(value.first, hot);
+        node* &to_insert = search_node(key, hot);
 
         if (to_insert) {
             return to_insert;
         }
 
         ++map_size;
-        auto ret = new node(hot, value);
+        auto ret = new node(hot, std::forward<Args>(args)...);
         // the value of to_insert might be set to something else during the rebalance
         // however, the address of the new node will not change
         to_insert = ret;
@@ -501,6 +528,10 @@ private:
     node* rotate(node* p) {
         node* c = p->taller_child();
         node* gc = c->taller_child();
+        // after an erase c's subtrees may be as high, then the one on c's side gives a single rotation
+        if (height(c->left) == height(c->right)) {
+            gc = c->is_lchild() ? c->left : c->right;
+        }
         node* ret;
         if (gc->is_lchild()) {
             if (c->is_lchild()) {
@@ -541,6 +572,216 @@ private:
         return b;
     }
 
+    // The trees below are detached: a root's parent pointer is not looked at and is set by whoever links it.
+
+    static int height(const node* t) {
+        return t ? t->height : 0;
+    }
+
+    // t with the subtrees l and r
+    static node* attach(node* t, node* l, node* r) {
+        t->left = l;
+        t->right = r;
+        if (l) l->parent = t;
+        if (r) r->parent = t;
+        t->update_height();
+        return t;
+    }
+
+    // restores the balance of t, whose subtrees are balanced and differ in height by at most 2
+    node* balance(node* t) {
+        int lh = height(t->left), rh = height(t->right);
+        if (lh > rh + 1) {
+            node* c = t->left;
+            if (height(c->left) >= height(c->right)) {
+                return connect34(c->left, c, t, c->left->left, c->left->right, c->right, t->right);
+            }
+            return connect34(c, c->right, t, c->left, c->right->left, c->right->right, t->right);
+        }
+        if (rh > lh + 1) {
+            node* c = t->right;
+            if (height(c->right) >= height(c->left)) {
+                return connect34(t, c, c->right, t->left, c->left, c->right->left, c->right->right);
+            }
+            return connect34(t, c->left, c, t->left, c->left->left, c->left->right, c->right);
+        }
+        t->update_height();
+        return t;
+    }
+
+    /**
+     * the tree of l, k and r, where the keys of l are less than k's and the keys of r greater.
+     * k goes down the spine of the taller tree to the height of the other one,
+     *   O(|height(l) - height(r)| + 1).
+     */
+    node* join(node* l, node* k, node* r) {
+        node* ret;
+        if (height(l) > height(r) + 1) {
+            ret = join_right(l, k, r);
+        } else if (height(r) > height(l) + 1) {
+            ret = join_left(l, k, r);
+        } else {
+            ret = attach(k, l, r);
+        }
+        ret->parent = nullptr;
+        return ret;
+    }
+
+    node* join_right(node* l, node* k, node* r) {
+        node* c = l->right;
+        c = height(c) <= height(r) + 1 ? attach(k, c, r) : join_right(c, k, r);
+        l->right = c;
+        c->parent = l;
+        return balance(l);
+    }
+
+    node* join_left(node* l, node* k, node* r) {
+        node* c = r->left;
+        c = height(c) <= height(l) + 1 ? attach(k, l, c) : join_left(l, k, c);
+        r->left = c;
+        c->parent = r;
+        return balance(r);
+    }
+
+    // join without a node in the middle, the smallest of r is taken out for it
+    node* join(node* l, node* r) {
+        if (!r) {
+            if (l) l->parent = nullptr;
+            return l;
+        }
+        node* min;
+        r = remove_min(r, min);
+        return join(l, min, r);
+    }
+
+    node* remove_min(node* t, node* &min) {
+        if (!t->left) {
+            min = t;
+            return t->right;
+        }
+        node* l = remove_min(t->left, min);
+        t->left = l;
+        if (l) l->parent = t;
+        return balance(t);
+    }
+
+    /**
+     * splits t into l, the keys less than key, r, the keys greater, and m, the node with key or nullptr.
+     * O(height(t)), as the joins on the way up add up to the height.
+     */
+    void split(node* t, const Key &key, node* &l, node* &m, node* &r) {
+        if (!t) {
+            l = m = r = nullptr;
+            return;
+        }
+        node* tl = t->left;
+        node* tr = t->right;
+        if (tl) tl->parent = nullptr;
+        if (tr) tr->parent = nullptr;
+        if (comp(key, t->value.first)) {
+            node* rl;
+            split(tl, key, l, m, rl);
+            r = join(rl, t, tr);
+        } else if (comp(t->value.first, key)) {
+            node* lr;
+            split(tr, key, lr, m, r);
+            l = join(tl, t, lr);
+        } else {
+            l = tl;
+            r = tr;
+            m = attach(t, nullptr, nullptr);
+            m->parent = nullptr;
+        }
+    }
+
+    // runs a() then b(), the parallel algorithms of parallel.hpp pass one that may run them at once
+    struct serial_fork {
+        template<class A, class B>
+        void operator()(int, const A &a, const B &b) const {
+            a();
+            b();
+        }
+    };
+
+    /**
+     * the union of a and b, whose nodes it takes, keeping a's node for a key in both
+     *   and moving b's one to the tree dups, n_dups nodes.
+     * b is split by the root of a, then the halves are united with a's subtrees and joined again,
+     *   O(m log(n / m + 1)) for trees of m and n >= m nodes.
+     */
+    template<class Fork>
+    node* union_trees(node* a, node* b, node* &dups, size_t &n_dups, const Fork &fork) {
+        if (!a || !b) {
+            dups = nullptr;
+            n_dups = 0;
+            return a ? a : b;
+        }
+        node* al = a->left;
+        node* ar = a->right;
+        if (al) al->parent = nullptr;
+        if (ar) ar->parent = nullptr;
+        node *bl, *bm, *br;
+        split(b, a->value.first, bl, bm, br);
+        node *l, *r, *dl, *dr;
+        size_t nl, nr;
+        fork(a->height, [&] { l = union_trees(al, bl, dl, nl, fork); },
+                        [&] { r = union_trees(ar, br, dr, nr, fork); });
+        n_dups = nl + nr + (bm ? 1 : 0);
+        dups = bm ? join(dl, bm, dr) : join(dl, dr);
+        return join(l, a, r);
+    }
+
+    template<class Fork>
+    void merge(map &other, const Fork &fork) {
+        if (&other == this) {
+            return;
+        }
+        node* dups;
+        size_t n_dups;
+        root = union_trees(root, other.root, dups, n_dups, fork);
+        map_size += other.map_size - n_dups;
+        other.root = dups;
+        other.map_size = n_dups;
+    }
+
+    /**
+     * a perfectly balanced tree of the values source(lo), ..., source(hi - 1), in increasing order of key, O(hi - lo).
+     * if one throws, the nodes made so far are deleted.
+     */
+    template<class Source, class Fork>
+    node* build_tree(const Source &source, size_t lo, size_t hi, const Fork &fork) {
+        if (lo == hi) {
+            return nullptr;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        int h = 0;
+        for (size_t n = hi - lo; n; n >>= 1) {
+            ++h;
+        }
+        node* left = nullptr;
+        node* right = nullptr;
+        try {
+            fork(h, [&] { left = build_tree(source, lo, mid, fork); },
+                    [&] { right = build_tree(source, mid + 1, hi, fork); });
+            node* ret = attach(new node(nullptr, source(mid)), left, right);
+            ret->parent = nullptr;
+            return ret;
+        } catch (...) {
+            clear(left);
+            clear(right);
+            throw;
+        }
+    }
+
+    // the number of nodes of t, or limit if there are at least that many, O(min(n, limit))
+    static size_t count_nodes(const node* t, size_t limit) {
+        size_t ret = 0;
+        for (; t && ret < limit; t = t->right) {
+            ret += 1 + count_nodes(t->left, limit - ret - 1);
+        }
+        return ret;
+    }
+
 public:
 
 	/**
@@ -567,6 +808,20 @@ public:
 
         return res->value.second;
     }
+	/**
+	 * Returns a pointer to the mapped value, or nullptr if such key does not exist.
+	 *   Unlike at(), a miss costs a branch instead of a throw.
+	 */
+	T * find_ptr(const Key &key) {
+        node* res = search_node(key);
+
+        return res ? &res->value.second : nullptr;
+    }
+	const T * find_ptr(const Key &key) const {
+        node* res = search_node(key);
+
+        return res ? &res->value.second : nullptr;
+    }
 
 	/**
 	 * access specified element
@@ -577,7 +832,7 @@ public:
         node* res = search_node(key);
 
         if (!res) {
-            res = insert_helper(value_type(key, T()));
+            res = insert_helper(key, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>());
         }
 
         return res->value.second;
@@ -631,6 +886,17 @@ public:
         return map_size;
     }
 
+	/**
+	 * the nodes allocated by all the maps of this type,
+	 *   all zero unless SJTU_COUNT_ALLOCATIONS is defined, see alloc_stats.hpp.
+	 */
+	static alloc_stats allocation_stats() {
+        return alloc_detail::counter<map>::stats();
+    }
+	static void reset_allocation_peak() {
+        alloc_detail::counter<map>::reset_peak();
+    }
+
 	void clear() {
         clear(root);
         map_size = 0;
@@ -650,7 +916,7 @@ public:
         if (res) {
             return pair<iterator, bool>(iterator(this, res), false);
         } else {
-            res = insert_helper(value);
+            res = insert_helper(value.first, std::move(value));
             return pair<iterator, bool>(iterator(this, res), true);
         }
     }
@@ -717,6 +983,79 @@ public:
                 hot = hot->parent;
             }
         }
+    }
+	/**
+	 * moves the elements of other whose keys are not in this map here, like std::map::merge,
+	 *   the others stay in other. The trees are split and joined rather than the elements inserted
+	 *   one by one, O(m log(n / m + 1)) for maps of m and n >= m elements, and nothing is copied.
+	 * Compare must not throw. Iterators to the moved elements are invalidated.
+	 */
+	void merge(map &other) {
+        merge(other, serial_fork());
+    }
+	/**
+	 * moves the elements with keys not less than key to the map returned,
+	 *   for sharding by key range or, with join(), erasing a range.
+	 * O(log n + min(k, n - k)) when k elements stay, the smaller part is counted for the sizes.
+	 * Iterators to the moved elements are invalidated.
+	 */
+	map split(const Key &key) {
+        node *l, *m, *r;
+        split(root, key, l, m, r);
+        map ret;
+        ret.comp = comp;
+        ret.root = m ? join(nullptr, m, r) : r;
+        root = l;
+        // both parts are counted up to the same limit, doubled until one of them is smaller
+        for (size_t limit = 1; ; limit *= 2) {
+            size_t left = count_nodes(root, limit);
+            if (left < limit) {
+                ret.map_size = map_size - left;
+                map_size = left;
+                break;
+            }
+            size_t right = count_nodes(ret.root, limit);
+            if (right < limit) {
+                ret.map_size = right;
+                map_size -= right;
+                break;
+            }
+        }
+        return ret;
+    }
+	/**
+	 * moves the elements of other here, where the keys of other must all be greater
+	 *   than the keys of this map, or all less, O(log n) without copying anything.
+	 * throw runtime_error, changing nothing, if the key ranges overlap.
+	 * Iterators to the moved elements are invalidated.
+	 */
+	void join(map &other) {
+        if (&other == this || !other.root) {
+            return;
+        }
+        if (root) {
+            node* max = root;
+            node* min = other.root;
+            while (max->right) max = max->right;
+            while (min->left) min = min->left;
+            if (comp(max->value.first, min->value.first)) {
+                root = join(root, other.root);
+            } else {
+                node* other_max = other.root;
+                node* this_min = root;
+                while (other_max->right) other_max = other_max->right;
+                while (this_min->left) this_min = this_min->left;
+                if (!comp(other_max->value.first, this_min->value.first)) {
+                    throw runtime_error();
+                }
+                root = join(other.root, root);
+            }
+        } else {
+            root = other.root;
+        }
+        map_size += other.map_size;
+        other.root = nullptr;
+        other.map_size = 0;
     }
 	/**
 	 * Returns the number of elements with key, either 1 or 0
@@ -0,0 +1,543 @@
+#ifndef SJTU_PARALLEL_HPP
+#define SJTU_PARALLEL_HPP
+
+#include "deque.hpp"
+#include "map.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sjtu {
+
+namespace parallel_detail {
+	// the elements of a deque or a sorted range one task handles at least
+	const size_t GRAIN = 4096;
+	// a map subtree this high, at most 2^12 - 1 nodes, is handled by one task
+	const int SUBTREE_HEIGHT = 12;
+
+	/**
+	 * runs a() in the pool and b() in this thread, returns when both have.
+	 * an exception of b() is rethrown rather than one of a().
+	 */
+	template<class A, class B>
+	void invoke(thread_pool &pool, const A &a, const B &b) {
+		thread_pool::task_group group(pool);
+		group.run(a);
+		b();
+		group.wait();
+	}
+
+	/**
+	 * body(i) for every i in [lo, hi), halving the range into tasks so a thief takes half of what is left.
+	 */
+	template<class F>
+	void for_range(thread_pool &pool, size_t lo, size_t hi, const F &body) {
+		if (hi - lo <= 1) {
+			if (lo < hi) {
+				body(lo);
+			}
+			return;
+		}
+		size_t mid = lo + (hi - lo) / 2;
+		invoke(pool, [&] { for_range(pool, mid, hi, body); }, [&] { for_range(pool, lo, mid, body); });
+	}
+
+	/**
+	 * moves the merge of the sorted [a, a_end) and [b, b_end) to out, stable,
+	 *   splitting the larger range at its middle and the other one at the same value.
+	 */
+	template<class It, class Out, class Compare>
+	void merge(thread_pool &pool, It a, It a_end, It b, It b_end, Out out, const Compare &comp) {
+		size_t na = a_end - a, nb = b_end - b;
+		if (na + nb <= GRAIN) {
+			std::merge(std::make_move_iterator(a), std::make_move_iterator(a_end),
+			           std::make_move_iterator(b), std::make_move_iterator(b_end), out, comp);
+			return;
+		}
+		It a_mid, b_mid;
+		if (na >= nb) {
+			a_mid = a + na / 2;
+			b_mid = std::lower_bound(b, b_end, *a_mid, comp);
+		} else {
+			b_mid = b + nb / 2;
+			a_mid = std::upper_bound(a, a_end, *b_mid, comp);
+		}
+		Out out_mid = out + ((a_mid - a) + (b_mid - b));
+		invoke(pool, [&] { merge(pool, a_mid, a_end, b_mid, b_end, out_mid, comp); },
+		       [&] { merge(pool, a, a_mid, b, b_mid, out, comp); });
+	}
+
+	/**
+	 * stable sort of [first, last) using buffer, as many elements, as scratch space.
+	 */
+	template<class It, class Buffer, class Compare>
+	void merge_sort(thread_pool &pool, It first, It last, Buffer buffer, const Compare &comp) {
+		size_t n = last - first;
+		if (n <= GRAIN) {
+			std::stable_sort(first, last, comp);
+			return;
+		}
+		It mid = first + n / 2;
+		Buffer buffer_mid = buffer + n / 2;
+		invoke(pool, [&] { merge_sort(pool, mid, last, buffer_mid, comp); },
+		       [&] { merge_sort(pool, first, mid, buffer, comp); });
+		merge(pool, first, mid, mid, last, buffer, comp);
+		for_range(pool, 0, (n + GRAIN - 1) / GRAIN, [&](size_t i) {
+			size_t lo = i * GRAIN, hi = std::min(n, lo + GRAIN);
+			std::move(buffer + lo, buffer + hi, first + lo);
+		});
+	}
+}
+
+/**
+ * The parts of the parallel algorithms that use the nodes of deque and map, both of which name it a friend.
+ * A deque is a list of nodes, cut into runs of GRAIN nodes: a task walks along the links
+ *   to the end of its run, hands the rest of the list to a new task and then handles its run,
+ *   whose nodes the walk has just brought into the cache.
+ * A map is cut into subtrees, the left one handled by a new task and the root and the right one
+ *   by the current task, down to SUBTREE_HEIGHT. Building and merging maps use map's own
+ *   recursions with pool_fork, which runs their two halves in parallel.
+ */
+struct parallel_access {
+	// body(first, last, i) for the i-th run [first, last) of the list from p to end
+	template<class Node, class F>
+	static void for_runs(thread_pool::task_group &group, Node* p, Node* end, size_t i, const F &body) {
+		Node* q = p;
+		for (size_t j = 0; j < parallel_detail::GRAIN && q != end; ++j) {
+			q = q->next;
+		}
+		if (q != end) {
+			group.run([&group, q, end, i, &body] { for_runs(group, q, end, i + 1, body); });
+		}
+		body(p, q, i);
+	}
+	template<class T, class F>
+	static void for_runs(thread_pool &pool, const deque<T> &d, const F &body) {
+		if (!d.curr_size) {
+			return;
+		}
+		thread_pool::task_group group(pool);
+		for_runs(group, d.dummy_head->next, d.dummy_tail, 0, body);
+		group.wait();
+	}
+	template<class T>
+	static size_t count_runs(const deque<T> &d) {
+		return (d.curr_size + parallel_detail::GRAIN - 1) / parallel_detail::GRAIN;
+	}
+
+	template<class T, class F>
+	static void for_each(thread_pool &pool, const deque<T> &d, F &f) {
+		typedef typename deque<T>::node node;
+		for_runs(pool, d, [&f](node* first, node* last, size_t) {
+			for (node* p = first; p != last; p = p->next) {
+				f(*p->object);
+			}
+		});
+	}
+
+	template<class T, class U, class F>
+	static void transform(thread_pool &pool, const deque<T> &in, deque<U> &out, F &f) {
+		typedef typename deque<T>::node node;
+		typedef typename deque<U>::node out_node;
+		size_t n = count_runs(in);
+		// every run builds its own list of results, linked together at the end
+		std::vector<out_node*> heads(n, nullptr), tails(n, nullptr);
+		try {
+			for_runs(pool, in, [&](node* first, node* last, size_t i) {
+				for (node* p = first; p != last; p = p->next) {
+					out_node* q = new out_node(tails[i], nullptr, f(*p->object));
+					if (tails[i]) {
+						tails[i]->next = q;
+					} else {
+						heads[i] = q;
+					}
+					tails[i] = q;
+				}
+			});
+		} catch (...) {
+			for (size_t i = 0; i < n; ++i) {
+				out_node* next;
+				for (out_node* q = heads[i]; q; q = next) {
+					next = q->next;
+					delete q;
+				}
+			}
+			throw;
+		}
+		// in may be out, it is not needed any more
+		size_t size = in.curr_size;
+		out.clear();
+		out_node* tail = out.dummy_head;
+		for (size_t i = 0; i < n; ++i) {
+			tail->next = heads[i];
+			heads[i]->prev = tail;
+			tail = tails[i];
+		}
+		tail->next = out.dummy_tail;
+		out.dummy_tail->prev = tail;
+		out.curr_size = size;
+	}
+
+	template<class T, class R, class Reduce, class F>
+	static R transform_reduce(thread_pool &pool, const deque<T> &d, const R &identity, Reduce &reduce, F &f) {
+		typedef typename deque<T>::node node;
+		std::vector<R> partial(count_runs(d), identity);
+		for_runs(pool, d, [&](node* first, node* last, size_t i) {
+			R acc = identity;
+			for (node* p = first; p != last; p = p->next) {
+				acc = reduce(std::move(acc), f(*p->object));
+			}
+			partial[i] = std::move(acc);
+		});
+		R ret = identity;
+		for (R &r : partial) {
+			ret = reduce(std::move(ret), std::move(r));
+		}
+		return ret;
+	}
+
+	// small trivial elements are copied out, sorted and copied back
+	template<class T, class Compare>
+	static void sort(thread_pool &pool, deque<T> &d, Compare &comp, std::true_type) {
+		typedef typename deque<T>::node node;
+		std::vector<T> values(d.curr_size), buffer(d.curr_size);
+		for_runs(pool, d, [&values](node* first, node* last, size_t i) {
+			T* out = values.data() + i * parallel_detail::GRAIN;
+			for (node* p = first; p != last; p = p->next) {
+				*out++ = *p->object;
+			}
+		});
+		parallel_detail::merge_sort(pool, values.begin(), values.end(), buffer.begin(), comp);
+		for_runs(pool, d, [&values](node* first, node* last, size_t i) {
+			const T* in = values.data() + i * parallel_detail::GRAIN;
+			for (node* p = first; p != last; p = p->next) {
+				*p->object = *in++;
+			}
+		});
+	}
+	// other elements stay where they are, the pointers to them are sorted and put back in the nodes
+	template<class T, class Compare>
+	static void sort(thread_pool &pool, deque<T> &d, Compare &comp, std::false_type) {
+		typedef typename deque<T>::node node;
+		std::vector<T*> objects(d.curr_size), buffer(d.curr_size);
+		for_runs(pool, d, [&objects](node* first, node* last, size_t i) {
+			T** out = objects.data() + i * parallel_detail::GRAIN;
+			for (node* p = first; p != last; p = p->next) {
+				*out++ = p->object;
+			}
+		});
+		parallel_detail::merge_sort(pool, objects.begin(), objects.end(), buffer.begin(), [&comp](T* a, T* b) {
+			return comp(*a, *b);
+		});
+		for_runs(pool, d, [&objects](node* first, node* last, size_t i) {
+			T* const* in = objects.data() + i * parallel_detail::GRAIN;
+			for (node* p = first; p != last; p = p->next) {
+				p->object = *in++;
+			}
+		});
+	}
+	template<class T, class Compare>
+	static void sort(thread_pool &pool, deque<T> &d, Compare &comp) {
+		sort(pool, d, comp, std::integral_constant<bool, std::is_trivial<T>::value && sizeof(T) <= 2 * sizeof(T*)>());
+	}
+
+	template<class Node, class F>
+	static void for_each(thread_pool &pool, Node* t, F &f) {
+		if (!t) {
+			return;
+		}
+		if (t->height <= parallel_detail::SUBTREE_HEIGHT) {
+			for_each(t->left, f);
+		} else {
+			thread_pool::task_group group(pool);
+			group.run([&] { for_each(pool, t->left, f); });
+			f(t->value);
+			for_each(pool, t->right, f);
+			group.wait();
+			return;
+		}
+		f(t->value);
+		for_each(t->right, f);
+	}
+	template<class Node, class F>
+	static void for_each(Node* t, F &f) {
+		for (; t; t = t->right) {
+			for_each(t->left, f);
+			f(t->value);
+		}
+	}
+
+	template<class Key, class T, class Compare, class F>
+	static void for_each(thread_pool &pool, const map<Key, T, Compare> &m, F &f) {
+		for_each(pool, m.root, f);
+	}
+
+	template<class Node>
+	static void destroy(Node* t) {
+		if (t) {
+			destroy(t->left);
+			destroy(t->right);
+			delete t;
+		}
+	}
+
+	// a copy of the subtree t with f(value) as the mapped values, of the same shape
+	template<class OutNode, class Node, class F>
+	static OutNode* transform(thread_pool &pool, const Node* t, F &f) {
+		if (!t) {
+			return nullptr;
+		}
+		OutNode* left = nullptr;
+		OutNode* right = nullptr;
+		try {
+			if (t->height > parallel_detail::SUBTREE_HEIGHT) {
+				parallel_detail::invoke(pool, [&] { left = transform<OutNode>(pool, t->left, f); },
+				                        [&] { right = transform<OutNode>(pool, t->right, f); });
+			} else {
+				left = transform<OutNode>(pool, t->left, f);
+				right = transform<OutNode>(pool, t->right, f);
+			}
+			OutNode* ret = new OutNode(nullptr, t->value.first, f(t->value));
+			ret->left = left;
+			ret->right = right;
+			ret->height = t->height;
+			if (left) left->parent = ret;
+			if (right) right->parent = ret;
+			return ret;
+		} catch (...) {
+			destroy(left);
+			destroy(right);
+			throw;
+		}
+	}
+
+	template<class Key, class T, class U, class Compare, class F>
+	static void transform(thread_pool &pool, const map<Key, T, Compare> &in, map<Key, U, Compare> &out, F &f) {
+		typedef typename map<Key, U, Compare>::node out_node;
+		out_node* root = transform<out_node>(pool, in.root, f);
+		// in may be out, it is not needed any more
+		size_t size = in.map_size;
+		Compare comp = in.comp;
+		out.clear();
+		out.root = root;
+		out.map_size = size;
+		out.comp = comp;
+	}
+
+	template<class Node, class R, class Reduce, class F>
+	static R transform_reduce(thread_pool &pool, const Node* t, const R &identity, Reduce &reduce, F &f) {
+		if (!t) {
+			return identity;
+		}
+		R left = identity, right = identity;
+		if (t->height > parallel_detail::SUBTREE_HEIGHT) {
+			parallel_detail::invoke(pool, [&] { left = transform_reduce(pool, t->left, identity, reduce, f); },
+			                        [&] { right = transform_reduce(pool, t->right, identity, reduce, f); });
+		} else {
+			left = transform_reduce(pool, t->left, identity, reduce, f);
+			right = transform_reduce(pool, t->right, identity, reduce, f);
+		}
+		return reduce(reduce(std::move(left), f(t->value)), std::move(right));
+	}
+
+	template<class Key, class T, class Compare, class R, class Reduce, class F>
+	static R transform_reduce(thread_pool &pool, const map<Key, T, Compare> &m, const R &identity, Reduce &reduce, F &f) {
+		return transform_reduce(pool, static_cast<const typename map<Key, T, Compare>::node*>(m.root), identity, reduce, f);
+	}
+
+	// map's serial_fork, but with the two calls in parallel for subtrees higher than SUBTREE_HEIGHT
+	struct pool_fork {
+		thread_pool &pool;
+
+		explicit pool_fork(thread_pool &_pool) : pool(_pool) {}
+		template<class A, class B>
+		void operator()(int height, const A &a, const B &b) const {
+			if (height > parallel_detail::SUBTREE_HEIGHT) {
+				parallel_detail::invoke(pool, a, b);
+			} else {
+				a();
+				b();
+			}
+		}
+	};
+
+	template<class Key, class T, class Compare>
+	static void merge(thread_pool &pool, map<Key, T, Compare> &into, map<Key, T, Compare> &from) {
+		into.merge(from, pool_fork(pool));
+	}
+
+	template<class Key, class T, class Compare, class It>
+	static void insert(thread_pool &pool, map<Key, T, Compare> &m, It first, It last) {
+		typedef pair<Key, T> entry;
+		const size_t GRAIN = parallel_detail::GRAIN;
+		size_t n = last - first, runs = (n + GRAIN - 1) / GRAIN;
+		std::vector<entry> batch(n);
+		parallel_detail::for_range(pool, 0, runs, [&](size_t i) {
+			for (size_t j = i * GRAIN; j < n && j < (i + 1) * GRAIN; ++j) {
+				batch[j] = entry(first[j].first, first[j].second);
+			}
+		});
+		const Compare &comp = m.comp;
+		{
+			std::vector<entry> buffer(n);
+			parallel_detail::merge_sort(pool, batch.begin(), batch.end(), buffer.begin(), [&comp](const entry &a, const entry &b) {
+				return comp(a.first, b.first);
+			});
+		}
+		// the sort is stable, so the first of the entries with the same key is kept
+		auto first_of_key = [&](size_t j) {
+			return j == 0 || comp(batch[j - 1].first, batch[j].first);
+		};
+		std::vector<size_t> offset(runs + 1, 0);
+		parallel_detail::for_range(pool, 0, runs, [&](size_t i) {
+			for (size_t j = i * GRAIN; j < n && j < (i + 1) * GRAIN; ++j) {
+				offset[i + 1] += first_of_key(j);
+			}
+		});
+		for (size_t i = 0; i < runs; ++i) {
+			offset[i + 1] += offset[i];
+		}
+		std::vector<size_t> kept(offset[runs]);
+		parallel_detail::for_range(pool, 0, runs, [&](size_t i) {
+			size_t k = offset[i];
+			for (size_t j = i * GRAIN; j < n && j < (i + 1) * GRAIN; ++j) {
+				if (first_of_key(j)) {
+					kept[k++] = j;
+				}
+			}
+		});
+		map<Key, T, Compare> built;
+		built.comp = comp;
+		built.root = built.build_tree([&](size_t i) -> entry && { return std::move(batch[kept[i]]); },
+		                              0, kept.size(), pool_fork(pool));
+		built.map_size = kept.size();
+		// the keys already in m keep their values, the entries for them are deleted with built
+		m.merge(built, pool_fork(pool));
+	}
+};
+
+/**
+ * Parallel versions of the usual algorithms over a whole deque or map, run in a thread_pool.
+ * The functions given are called from several threads at once, on different elements,
+ *   and an exception one of them throws is rethrown by the algorithm once the others have stopped.
+ * The container must not change meanwhile.
+ */
+namespace parallel {
+	/**
+	 * calls f(x) for every element x, in no particular order.
+	 */
+	template<class T, class F>
+	void for_each(thread_pool &pool, deque<T> &d, F f) {
+		parallel_access::for_each(pool, d, f);
+	}
+	template<class T, class F>
+	void for_each(thread_pool &pool, const deque<T> &d, F f) {
+		auto g = [&f](const T &x) { f(x); };
+		parallel_access::for_each(pool, d, g);
+	}
+	/**
+	 * calls f(x) for every value_type x, the key and the mapped value, in no particular order.
+	 */
+	template<class Key, class T, class Compare, class F>
+	void for_each(thread_pool &pool, map<Key, T, Compare> &m, F f) {
+		parallel_access::for_each(pool, m, f);
+	}
+	template<class Key, class T, class Compare, class F>
+	void for_each(thread_pool &pool, const map<Key, T, Compare> &m, F f) {
+		auto g = [&f](const typename map<Key, T, Compare>::value_type &x) { f(x); };
+		parallel_access::for_each(pool, m, g);
+	}
+
+	/**
+	 * replaces the elements of out by f(x) for every element x of in, in order.
+	 * in may be out. out is left unchanged if f throws.
+	 */
+	template<class T, class U, class F>
+	void transform(thread_pool &pool, const deque<T> &in, deque<U> &out, F f) {
+		parallel_access::transform(pool, in, out, f);
+	}
+	/**
+	 * replaces the elements of out by (x.first, f(x)) for every value_type x of in.
+	 * in may be out. out is left unchanged if f throws.
+	 */
+	template<class Key, class T, class U, class Compare, class F>
+	void transform(thread_pool &pool, const map<Key, T, Compare> &in, map<Key, U, Compare> &out, F f) {
+		parallel_access::transform(pool, in, out, f);
+	}
+
+	/**
+	 * reduce(... reduce(reduce(identity, f(x1)), f(x2)) ..., f(xn)) over the elements in order,
+	 *   with the parentheses anywhere: reduce must be associative and identity its identity,
+	 *   like 0 for +, since every task starts from it. It need not be commutative.
+	 */
+	template<class T, class R, class Reduce, class F>
+	R transform_reduce(thread_pool &pool, const deque<T> &d, R identity, Reduce reduce, F f) {
+		return parallel_access::transform_reduce(pool, d, identity, reduce, f);
+	}
+	template<class Key, class T, class Compare, class R, class Reduce, class F>
+	R transform_reduce(thread_pool &pool, const map<Key, T, Compare> &m, R identity, Reduce reduce, F f) {
+		return parallel_access::transform_reduce(pool, m, identity, reduce, f);
+	}
+	/**
+	 * transform_reduce with the elements themselves.
+	 */
+	template<class T, class R, class Reduce>
+	R reduce(thread_pool &pool, const deque<T> &d, R identity, Reduce op) {
+		auto f = [](const T &x) -> const T & { return x; };
+		return parallel_access::transform_reduce(pool, d, identity, op, f);
+	}
+
+	/**
+	 * inserts the elements of the random access range [first, last) of pairs whose keys are not in m,
+	 *   the first one of several with the same key, like inserting them one by one.
+	 * The batch is copied, sorted in parallel and deduplicated, built into a balanced tree in O(n)
+	 *   by parallel subtrees, then merged with m. Key and T must be default constructible.
+	 */
+	template<class Key, class T, class Compare, class It>
+	void insert(thread_pool &pool, map<Key, T, Compare> &m, It first, It last) {
+		parallel_access::insert(pool, m, first, last);
+	}
+	/**
+	 * map::merge with the subtrees united in parallel.
+	 */
+	template<class Key, class T, class Compare>
+	void merge(thread_pool &pool, map<Key, T, Compare> &into, map<Key, T, Compare> &from) {
+		parallel_access::merge(pool, into, from);
+	}
+
+	/**
+	 * stable sort of the elements. Small trivial ones are copied, the others are not moved or copied:
+	 *   the nodes swap them instead. d is left unchanged if comp throws.
+	 */
+	template<class T, class Compare>
+	void sort(thread_pool &pool, deque<T> &d, Compare comp) {
+		parallel_access::sort(pool, d, comp);
+	}
+	template<class T>
+	void sort(thread_pool &pool, deque<T> &d) {
+		std::less<T> comp;
+		parallel_access::sort(pool, d, comp);
+	}
+	/**
+	 * stable sort of a random access range of default constructible elements, with as many again as scratch space.
+	 */
+	template<class It, class Compare>
+	void sort(thread_pool &pool, It first, It last, Compare comp) {
+		std::vector<typename std::iterator_traits<It>::value_type> buffer(last - first);
+		parallel_detail::merge_sort(pool, first, last, buffer.begin(), comp);
+	}
+	template<class It>
+	void sort(thread_pool &pool, It first, It last) {
+		sort(pool, first, last, std::less<typename std::iterator_traits<It>::value_type>());
+	}
+}
+
+}
+
+#endif
@@ -0,0 +1,552 @@
+/**
+ * implement a container like std::map whose copies share their nodes
+ */
+#ifndef SJTU_PERSISTENT_MAP_HPP
+#define SJTU_PERSISTENT_MAP_HPP
+
+// only for std::less<T>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * AVL tree like sjtu::map, but copying it (or taking a snapshot()) is O(1):
+ *   the copies share the nodes, counting their references, and a modification
+ *   copies only the nodes it would change that are shared, the O(log n) nodes
+ *   on the path to the key plus the few a rotation moves.
+ * The nodes have no parent pointer, which could not be shared, the iterators keep
+ *   the path from the root instead. The iterators are read-only, at(), find_ptr() and
+ *   operator[] give mutable access and copy the path first if it is shared.
+ * Threads: the reference counts are atomic and a node reachable from more than
+ *   one map is never changed, so any number of threads may read their own copies
+ *   while another thread modifies the map they were taken from, without a lock.
+ *   As for the std:: containers, one map object must not be read and modified at once,
+ *   so a reader takes its snapshot from the writer (or under the writer's lock).
+ */
+template<
+	class Key,
+	class T,
+	class Compare = std::less<Key>
+> class persistent_map {
+public:
+    typedef pair<const Key, T> value_type;
+
+private:
+    struct node {
+        node* left;
+        node* right;
+        int height;
+        // the maps and the parents pointing to this node
+        std::atomic<size_t> refs;
+        value_type value;
+
+        template<class... Args, class = typename std::enable_if<std::is_constructible<value_type, Args&&...>::value>::type>
+        explicit node(Args&&... args):
+                left(nullptr), right(nullptr), height(1), refs(1), value(std::forward<Args>(args)...) {}
+        node(const node &other):
+                left(other.left), right(other.right), height(other.height), refs(1), value(other.value) {}
+    };
+
+    // an AVL tree of height 48 has at least 1.2e10 nodes
+    static const int MAX_HEIGHT = 48;
+
+    size_t map_size;
+    node* root;
+    Compare comp;
+
+    static int height(const node* t) {
+        return t ? t->height : 0;
+    }
+
+    static void update_height(node* t) {
+        int lh = height(t->left);
+        int rh = height(t->right);
+        t->height = (lh > rh ? lh : rh) + 1;
+    }
+
+    // drop one reference to t, freeing the nodes no map uses any more
+    static void release(node* t) {
+        // with a single reference nobody else can change the count
+        if (t && (t->refs.load(std::memory_order_acquire) == 1 || t->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)) {
+            release(t->left);
+            release(t->right);
+            delete t;
+        }
+    }
+
+    static void acquire(node* t) {
+        if (t) {
+            t->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * t, or a copy of it if it is shared, in place of the caller's reference to t.
+     * The children of a copy gain a reference, so they are copied in turn before a change.
+     */
+    static node* unique(node* t) {
+        if (t->refs.load(std::memory_order_acquire) == 1) {
+            return t;
+        }
+        node* ret = new node(*t);
+        acquire(ret->left);
+        acquire(ret->right);
+        release(t);
+        return ret;
+    }
+
+    node* search_node(const Key &key) const {
+        node* pos = root;
+
+        while (pos) {
+            if (comp(key, pos->value.first)) {
+                pos = pos->left;
+            } else if (comp(pos->value.first, key)) {
+                pos = pos->right;
+            } else {
+                break;
+            }
+        }
+
+        return pos;
+    }
+
+    // make the nodes down to key unshared, key must be present
+    node* unique_path(const Key &key) {
+        node** slot = &root;
+
+        while (true) {
+            node* this_node = *slot = unique(*slot);
+            if (comp(key, this_node->value.first)) {
+                slot = &this_node->left;
+            } else if (comp(this_node->value.first, key)) {
+                slot = &this_node->right;
+            } else {
+                return this_node;
+            }
+        }
+    }
+
+    node* connect34(node* a, node* b, node* c, node* t1, node* t2, node* t3, node* t4) {
+        a->left = t1;
+        a->right = t2;
+        update_height(a);
+
+        c->left = t3;
+        c->right = t4;
+        update_height(c);
+
+        b->left = a;
+        b->right = c;
+        update_height(b);
+
+        return b;
+    }
+
+    // p is unshared, its taller child and grandchild are made so before they move
+    node* rotate(node* p) {
+        if (height(p->left) > height(p->right)) {
+            node* c = p->left = unique(p->left);
+            if (height(c->left) >= height(c->right)) {
+                node* gc = c->left = unique(c->left);
+                return connect34(gc, c, p, gc->left, gc->right, c->right, p->right);
+            } else {
+                node* gc = c->right = unique(c->right);
+                return connect34(c, gc, p, c->left, gc->left, gc->right, p->right);
+            }
+        } else {
+            node* c = p->right = unique(p->right);
+            if (height(c->right) >= height(c->left)) {
+                node* gc = c->right = unique(c->right);
+                return connect34(p, c, gc, p->left, c->left, gc->left, gc->right);
+            } else {
+                node* gc = c->left = unique(c->left);
+                return connect34(p, gc, c, p->left, gc->left, gc->right, c->right);
+            }
+        }
+    }
+
+    node* rebalance(node* t) {
+        int lh = height(t->left);
+        int rh = height(t->right);
+        if (lh > rh + 1 || rh > lh + 1) {
+            return rotate(t);
+        }
+        t->height = (lh > rh ? lh : rh) + 1;
+        return t;
+    }
+
+    // the new subtree in place of t, key must be absent
+    template<class... Args>
+    node* insert_helper(node* t, const Key &key, node* &created, Args&&... args) {
+        if (!t) {
+            return created = new node(std::forward<Args>(args)...);
+        }
+
+        t = unique(t);
+        if (comp(key, t->value.first)) {
+            t->left = insert_helper(t->left, key, created, std::forward<Args>(args)...);
+        } else {
+            t->right = insert_helper(t->right, key, created, std::forward<Args>(args)...);
+        }
+        return rebalance(t);
+    }
+
+    // the new subtree in place of t without its leftmost node, which is unshared and returned in min
+    node* remove_min(node* t, node* &min) {
+        t = unique(t);
+        if (!t->left) {
+            min = t;
+            node* ret = t->right;
+            t->right = nullptr;
+            return ret;
+        }
+        t->left = remove_min(t->left, min);
+        return rebalance(t);
+    }
+
+    // the new subtree in place of t, key must be present
+    node* erase_helper(node* t, const Key &key) {
+        t = unique(t);
+        if (comp(key, t->value.first)) {
+            t->left = erase_helper(t->left, key);
+            return rebalance(t);
+        }
+        if (comp(t->value.first, key)) {
+            t->right = erase_helper(t->right, key);
+            return rebalance(t);
+        }
+
+        node* ret;
+        if (t->left && t->right) {
+            // the successor takes the place of t
+            t->right = remove_min(t->right, ret);
+            ret->left = t->left;
+            ret->right = t->right;
+            ret = rebalance(ret);
+        } else {
+            ret = t->left ? t->left : t->right;
+        }
+        t->left = t->right = nullptr;
+        release(t);
+        return ret;
+    }
+
+public:
+	/**
+	 * see BidirectionalIterator at CppReference for help.
+	 *
+	 * if there is anything wrong throw invalid_iterator.
+	 *     like it = map.begin(); --it;
+	 *       or it = map.end(); ++end();
+	 * no check is done if SJTU_UNCHECKED is defined, see exceptions.hpp.
+	 * Only valid until the map is modified, copies of the map are not affected.
+	 */
+	class const_iterator {
+        friend class persistent_map;
+		const persistent_map* this_map;
+        // path[depth - 1] is the element, depth is 0 at end()
+        const node* path[MAX_HEIGHT];
+        int depth;
+
+        void leftmost(const node* t) {
+            for (; t; t = t->left) {
+                path[depth++] = t;
+            }
+        }
+
+        void rightmost(const node* t) {
+            for (; t; t = t->right) {
+                path[depth++] = t;
+            }
+        }
+
+        void next() {
+            const node* this_node = path[depth - 1];
+            if (this_node->right) {
+                leftmost(this_node->right);
+            } else {
+                while (depth > 1 && path[depth - 2]->right == path[depth - 1]) {
+                    --depth;
+                }
+                --depth;
+            }
+        }
+
+        void prev() {
+            if (!depth) {
+                rightmost(this_map->root);
+                return;
+            }
+            const node* this_node = path[depth - 1];
+            if (this_node->left) {
+                rightmost(this_node->left);
+            } else {
+                while (depth > 1 && path[depth - 2]->left == path[depth - 1]) {
+                    --depth;
+                }
+                --depth;
+            }
+        }
+
+	public:
+		const_iterator(): this_map(nullptr), depth(0) {}
+        explicit const_iterator(const persistent_map* m): this_map(m), depth(0) {}
+		const_iterator(const const_iterator &other) {
+            this_map = other.this_map;
+            depth = other.depth;
+            for (int i = 0; i < depth; ++i) {
+                path[i] = other.path[i];
+            }
+        }
+		const_iterator & operator=(const const_iterator &other) {
+            this_map = other.this_map;
+            depth = other.depth;
+            for (int i = 0; i < depth; ++i) {
+                path[i] = other.path[i];
+            }
+            return *this;
+        }
+
+		const_iterator operator++(int) {
+            const_iterator ret(*this);
+            ++*this;
+            return ret;
+        }
+		const_iterator & operator++() {
+            if (checked_access && !depth) {
+                throw invalid_iterator();
+            }
+
+            next();
+            return *this;
+        }
+		const_iterator operator--(int) {
+            const_iterator ret(*this);
+            --*this;
+            return ret;
+        }
+		const_iterator & operator--() {
+            prev();
+            // stepped back from begin()
+            if (checked_access && !depth) {
+                *this = this_map->begin();
+                throw invalid_iterator();
+            }
+
+            return *this;
+        }
+
+		const value_type & operator*() const {
+            if (checked_access && !depth) {
+                throw invalid_iterator();
+            }
+
+            return path[depth - 1]->value;
+        }
+		const value_type* operator->() const noexcept {
+            return &path[depth - 1]->value;
+        }
+
+		bool operator==(const const_iterator &rhs) const {
+            return this_map == rhs.this_map && depth == rhs.depth
+                   && (!depth || path[depth - 1] == rhs.path[depth - 1]);
+        }
+		bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+	};
+	// the elements can only be changed through the map, which unshares them first
+	typedef const_iterator iterator;
+
+	persistent_map(): map_size(0), root(nullptr), comp() {}
+	/**
+	 * O(1), the nodes are shared until one of the maps modifies them.
+	 */
+	persistent_map(const persistent_map &other): map_size(other.map_size), root(other.root), comp(other.comp) {
+        acquire(root);
+    }
+	persistent_map & operator=(const persistent_map &other) {
+        acquire(other.root);
+        release(root);
+        root = other.root;
+        map_size = other.map_size;
+        comp = other.comp;
+
+        return *this;
+    }
+	~persistent_map() {
+        release(root);
+    }
+
+	/**
+	 * A read-only copy of the map as it is now, unchanged by the later modifications of the map, in O(1).
+	 */
+	persistent_map snapshot() const {
+        return *this;
+    }
+
+	/**
+	 * Returns a reference to the mapped value
+	 * an exception of type `index_out_of_bound'
+	 */
+	T & at(const Key &key) {
+        if (!search_node(key)) {
+            throw index_out_of_bound();
+        }
+
+        return unique_path(key)->value.second;
+    }
+	const T & at(const Key &key) const {
+        node* res = search_node(key);
+
+        if (!res) {
+            throw index_out_of_bound();
+        }
+
+        return res->value.second;
+    }
+	/**
+	 * Returns a pointer to the mapped value, or nullptr if such key does not exist.
+	 */
+	T * find_ptr(const Key &key) {
+        return search_node(key) ? &unique_path(key)->value.second : nullptr;
+    }
+	const T * find_ptr(const Key &key) const {
+        node* res = search_node(key);
+
+        return res ? &res->value.second : nullptr;
+    }
+
+	/**
+	 * access specified element
+	 *   performing an insertion if such key does not already exist.
+	 */
+	T & operator[](const Key &key) {
+        if (search_node(key)) {
+            return unique_path(key)->value.second;
+        }
+
+        node* res;
+        root = insert_helper(root, key, res, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>());
+        ++map_size;
+        return res->value.second;
+    }
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const {
+        return at(key);
+    }
+
+	const_iterator begin() const {
+        const_iterator ret(this);
+        ret.leftmost(root);
+        return ret;
+    }
+	const_iterator cbegin() const {
+        return begin();
+    }
+
+	const_iterator end() const {
+        return const_iterator(this);
+    }
+	const_iterator cend() const {
+        return end();
+    }
+
+	bool empty() const {
+        return !map_size;
+    }
+
+	size_t size() const {
+        return map_size;
+    }
+
+	void clear() {
+        release(root);
+        root = nullptr;
+        map_size = 0;
+    }
+
+	/**
+	 * insert an element.
+	 * return a pair, the first of the pair is
+	 *   the iterator to the new element (or the element that prevented the insertion),
+	 *   the second one is true if insert successfully, or false.
+	 */
+	pair<const_iterator, bool> insert(value_type value) {
+        if (search_node(value.first)) {
+            return pair<const_iterator, bool>(find(value.first), false);
+        }
+
+        node* res;
+        root = insert_helper(root, value.first, res, std::move(value));
+        ++map_size;
+        return pair<const_iterator, bool>(find(res->value.first), true);
+    }
+
+	/**
+	 * erase the element at pos.
+	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+	 */
+	void erase(const_iterator pos) {
+        if (pos.this_map != this || !pos.depth) {
+            throw index_out_of_bound();
+        }
+
+        // the node of pos may be copied and freed on the way down
+        Key key(pos->first);
+        root = erase_helper(root, key);
+        --map_size;
+    }
+	/**
+	 * erase the element with key, return the number of elements erased, either 1 or 0
+	 */
+	size_t erase(const Key &key) {
+        if (!search_node(key)) {
+            return 0;
+        }
+
+        root = erase_helper(root, key);
+        --map_size;
+        return 1;
+    }
+	/**
+	 * Returns the number of elements with key, either 1 or 0
+	 */
+	size_t count(const Key &key) const {
+        return search_node(key) ? 1 : 0;
+    }
+	/**
+	 * Finds an element with key equivalent to key.
+	 *   If no such element is found, past-the-end (see end()) iterator is returned.
+	 */
+	const_iterator find(const Key &key) const {
+        const_iterator ret(this);
+        const node* pos = root;
+
+        while (pos) {
+            ret.path[ret.depth++] = pos;
+            if (comp(key, pos->value.first)) {
+                pos = pos->left;
+            } else if (comp(pos->value.first, key)) {
+                pos = pos->right;
+            } else {
+                return ret;
+            }
+        }
+
+        return end();
+    }
+};
+}
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef SJTU_RING_QUEUE_HPP
+#define SJTU_RING_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+
+namespace queue_detail {
+	// head and tail on separate lines, so producers and consumers do not invalidate each other's
+	const size_t CACHE_LINE = 64;
+
+	inline size_t round_up_pow2(size_t n) {
+		size_t ret = 1;
+		while (ret < n) {
+			ret <<= 1;
+		}
+		return ret;
+	}
+}
+
+/**
+ * Bounded queue for any number of producer and consumer threads, without a lock,
+ *   to replace a sjtu::deque behind a mutex as a work queue (D. Vyukov's bounded MPMC queue).
+ * Every cell of the ring holds a sequence number telling the position it is ready for:
+ *   a producer claims the tail position once its cell is free by a CAS, a consumer the head
+ *   position once its cell is full, then each hands the cell over by advancing its sequence.
+ * The capacity is rounded up to a power of two. Nothing blocks: try_push() returns false
+ *   when the queue is full and try_pop() when it is empty, the caller decides whether to spin,
+ *   yield or sleep. The batch versions move several elements for one CAS.
+ * T must be nothrow move constructible, as a claimed cell cannot be given back.
+ */
+template<class T>
+class mpmc_queue {
+	static_assert(std::is_nothrow_move_constructible<T>::value, "mpmc_queue needs a nothrow move constructor");
+
+	struct cell {
+		std::atomic<size_t> seq;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+		T* object() {
+			return reinterpret_cast<T*>(&storage);
+		}
+	};
+
+	cell* cells;
+	size_t mask;
+	alignas(queue_detail::CACHE_LINE) std::atomic<size_t> tail;
+	alignas(queue_detail::CACHE_LINE) std::atomic<size_t> head;
+
+public:
+	explicit mpmc_queue(size_t capacity) : mask(queue_detail::round_up_pow2(capacity) - 1), tail(0), head(0) {
+		cells = new cell[mask + 1];
+		for (size_t i = 0; i <= mask; ++i) {
+			cells[i].seq.store(i, std::memory_order_relaxed);
+		}
+	}
+	mpmc_queue(const mpmc_queue &other) = delete;
+	mpmc_queue &operator=(const mpmc_queue &other) = delete;
+	/**
+	 * no other thread may be using the queue any more.
+	 */
+	~mpmc_queue() {
+		for (size_t pos = head.load(); pos != tail.load(); ++pos) {
+			cells[pos & mask].object()->~T();
+		}
+		delete[] cells;
+	}
+
+	/**
+	 * appends value,
+	 *     return false, leaving the queue untouched, when it is full.
+	 */
+	bool try_push(T &&value) {
+		return try_push_batch(std::make_move_iterator(&value), 1) == 1;
+	}
+	bool try_push(const T &value) {
+		// copied before a cell is claimed, in case the copy throws
+		T copy(value);
+		return try_push(std::move(copy));
+	}
+	/**
+	 * moves the first element into value and removes it
+	 *     return false, leaving value untouched, when the queue is empty.
+	 */
+	bool try_pop(T &value) {
+		return try_pop_batch(&value, 1) == 1;
+	}
+
+	/**
+	 * appends up to n elements from first, as many as there are free cells,
+	 *     return the number appended. They are consecutive in the queue.
+	 * Constructing T from *first must not throw, pass a std::move_iterator for the other types.
+	 */
+	template<class InputIt>
+	size_t try_push_batch(InputIt first, size_t n) {
+		static_assert(std::is_nothrow_constructible<T, decltype(*first)>::value, "the cells are claimed before the elements are constructed");
+		size_t pos = tail.load(std::memory_order_relaxed);
+		while (true) {
+			size_t k = 0;
+			for (; k < n; ++k) {
+				size_t seq = cells[(pos + k) & mask].seq.load(std::memory_order_acquire);
+				if (seq != pos + k) {
+					break;
+				}
+			}
+			if (!k) {
+				size_t seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+				if (static_cast<std::ptrdiff_t>(seq - pos) < 0) {
+					// the cell still holds the element of the previous lap
+					return 0;
+				}
+				// another producer claimed pos
+				pos = tail.load(std::memory_order_relaxed);
+				continue;
+			}
+			// no one else can change these k cells until they are claimed
+			if (tail.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+				for (size_t i = 0; i < k; ++i, ++first) {
+					cell &c = cells[(pos + i) & mask];
+					new (c.object()) T(*first);
+					c.seq.store(pos + i + 1, std::memory_order_release);
+				}
+				return k;
+			}
+		}
+	}
+	/**
+	 * moves up to n elements to out and removes them,
+	 *     return the number removed.
+	 */
+	template<class OutputIt>
+	size_t try_pop_batch(OutputIt out, size_t n) {
+		size_t pos = head.load(std::memory_order_relaxed);
+		while (true) {
+			size_t k = 0;
+			for (; k < n; ++k) {
+				size_t seq = cells[(pos + k) & mask].seq.load(std::memory_order_acquire);
+				if (seq != pos + k + 1) {
+					break;
+				}
+			}
+			if (!k) {
+				size_t seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+				if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0) {
+					// not pushed yet
+					return 0;
+				}
+				pos = head.load(std::memory_order_relaxed);
+				continue;
+			}
+			if (head.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+				for (size_t i = 0; i < k; ++i, ++out) {
+					cell &c = cells[(pos + i) & mask];
+					*out = std::move(*c.object());
+					c.object()->~T();
+					c.seq.store(pos + i + mask + 1, std::memory_order_release);
+				}
+				return k;
+			}
+		}
+	}
+
+	size_t capacity() const {
+		return mask + 1;
+	}
+	/**
+	 * only exact when no other thread is pushing or popping.
+	 */
+	size_t size() const {
+		size_t h = head.load(std::memory_order_relaxed);
+		size_t t = tail.load(std::memory_order_relaxed);
+		return t > h ? t - h : 0;
+	}
+	bool empty() const {
+		return !size();
+	}
+};
+
+/**
+ * Bounded queue for exactly one producer thread and one consumer thread, without a lock
+ *   or any read-modify-write: each side owns its index and only reads the other's,
+ *   keeping a cached copy of it so the shared line is read only when the cache says full or empty.
+ * Same interface as mpmc_queue, the batch versions publish all their elements with one store.
+ */
+template<class T>
+class spsc_queue {
+	static_assert(std::is_nothrow_move_constructible<T>::value, "spsc_queue needs a nothrow move constructor");
+
+	typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+	storage* slots;
+	size_t mask;
+	// written by the producer
+	alignas(queue_detail::CACHE_LINE) std::atomic<size_t> tail;
+	size_t head_cache;
+	// written by the consumer
+	alignas(queue_detail::CACHE_LINE) std::atomic<size_t> head;
+	size_t tail_cache;
+
+	T* object(size_t pos) {
+		return reinterpret_cast<T*>(&slots[pos & mask]);
+	}
+
+public:
+	explicit spsc_queue(size_t capacity) :
+			slots(new storage[queue_detail::round_up_pow2(capacity)]), mask(queue_detail::round_up_pow2(capacity) - 1),
+			tail(0), head_cache(0), head(0), tail_cache(0) {}
+	spsc_queue(const spsc_queue &other) = delete;
+	spsc_queue &operator=(const spsc_queue &other) = delete;
+	/**
+	 * no other thread may be using the queue any more.
+	 */
+	~spsc_queue() {
+		for (size_t pos = head.load(); pos != tail.load(); ++pos) {
+			object(pos)->~T();
+		}
+		delete[] slots;
+	}
+
+	/**
+	 * appends value,
+	 *     return false, leaving the queue untouched, when it is full.
+	 */
+	bool try_push(T &&value) {
+		return try_push_batch(std::make_move_iterator(&value), 1) == 1;
+	}
+	bool try_push(const T &value) {
+		return try_push_batch(&value, 1) == 1;
+	}
+	/**
+	 * moves the first element into value and removes it
+	 *     return false, leaving value untouched, when the queue is empty.
+	 */
+	bool try_pop(T &value) {
+		return try_pop_batch(&value, 1) == 1;
+	}
+
+	/**
+	 * appends up to n elements from first, as many as there are free slots,
+	 *     return the number appended. Only the producer thread may call it.
+	 */
+	template<class InputIt>
+	size_t try_push_batch(InputIt first, size_t n) {
+		size_t pos = tail.load(std::memory_order_relaxed);
+		if (pos + n - head_cache > mask + 1) {
+			head_cache = head.load(std::memory_order_acquire);
+			if (pos + n - head_cache > mask + 1) {
+				n = mask + 1 - (pos - head_cache);
+			}
+		}
+		size_t i = 0;
+		try {
+			for (; i < n; ++i, ++first) {
+				new (object(pos + i)) T(*first);
+			}
+		} catch (...) {
+			// the elements before the one that threw are kept
+			tail.store(pos + i, std::memory_order_release);
+			throw;
+		}
+		tail.store(pos + n, std::memory_order_release);
+		return n;
+	}
+	/**
+	 * moves up to n elements to out and removes them,
+	 *     return the number removed. Only the consumer thread may call it.
+	 */
+	template<class OutputIt>
+	size_t try_pop_batch(OutputIt out, size_t n) {
+		size_t pos = head.load(std::memory_order_relaxed);
+		if (tail_cache - pos < n) {
+			tail_cache = tail.load(std::memory_order_acquire);
+			if (tail_cache - pos < n) {
+				n = tail_cache - pos;
+			}
+		}
+		for (size_t i = 0; i < n; ++i, ++out) {
+			*out = std::move(*object(pos + i));
+			object(pos + i)->~T();
+		}
+		head.store(pos + n, std::memory_order_release);
+		return n;
+	}
+
+	size_t capacity() const {
+		return mask + 1;
+	}
+	/**
+	 * only exact when no other thread is pushing or popping.
+	 */
+	size_t size() const {
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+	bool empty() const {
+		return !size();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef SJTU_THREAD_POOL_HPP
+#define SJTU_THREAD_POOL_HPP
+
+#include "deque.hpp"
+#include "work_stealing_deque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sjtu {
+
+namespace pool_detail {
+	// an idle worker yields IDLE_SPINS times, then sleeps IDLE_SLEEP_MS at a time
+	const int IDLE_SPINS = 64;
+	const int IDLE_SLEEP_MS = 1;
+}
+
+/**
+ * Fixed set of worker threads running the tasks of task_group, for fork-join parallelism.
+ * Every worker owns a work_stealing_deque: the tasks a task creates go to the bottom of its
+ *   worker's deque and are run from there depth first, an idle worker steals the oldest
+ *   task of another, usually the largest part of the remaining work.
+ * Tasks created outside the workers wait in a shared sjtu::deque behind a mutex.
+ * The thread waiting for a group runs tasks meanwhile instead of blocking,
+ *   so recursive fork-join does not need more threads than the pool has.
+ * Idle workers yield, then sleep on a condition variable for at most IDLE_SLEEP_MS.
+ */
+class thread_pool {
+	struct task;
+
+public:
+	/**
+	 * A set of tasks to wait for together. Any thread may run() tasks in it, its own tasks included,
+	 *   one thread at a time may wait() for it.
+	 */
+	class task_group {
+		friend class thread_pool;
+
+		thread_pool &pool;
+		std::atomic<size_t> pending;
+		std::mutex error_lock;
+		std::exception_ptr error;
+
+	public:
+		explicit task_group(thread_pool &_pool) : pool(_pool), pending(0) {}
+		task_group(const task_group &other) = delete;
+		task_group &operator=(const task_group &other) = delete;
+		/**
+		 * waits for the tasks, an exception they threw is lost.
+		 */
+		~task_group() {
+			try {
+				wait();
+			} catch (...) {}
+		}
+
+		/**
+		 * runs f() in the pool.
+		 * if the task cannot be made or queued, throws and the group does not wait for it.
+		 */
+		template<class F>
+		void run(F f) {
+			std::unique_ptr<task> t(new task(std::function<void()>(std::move(f)), this));
+			// counted before it is queued, a worker may run it and count it down at once
+			pending.fetch_add(1, std::memory_order_relaxed);
+			try {
+				pool.schedule(t.get());
+			} catch (...) {
+				pending.fetch_sub(1, std::memory_order_relaxed);
+				throw;
+			}
+			t.release();
+		}
+		/**
+		 * returns when all the tasks run so far have finished, running tasks of the pool meanwhile.
+		 * rethrows the first exception thrown by one of them.
+		 */
+		void wait() {
+			while (pending.load(std::memory_order_acquire)) {
+				task* t = pool.find_task();
+				if (t) {
+					pool.execute(t);
+				} else {
+					std::this_thread::yield();
+				}
+			}
+			if (error) {
+				std::exception_ptr e = error;
+				error = nullptr;
+				std::rethrow_exception(e);
+			}
+		}
+	};
+
+private:
+	struct task {
+		std::function<void()> f;
+		task_group* group;
+		task(std::function<void()> &&_f, task_group* _group) : f(std::move(_f)), group(_group) {}
+	};
+
+	struct worker {
+		thread_pool* pool;
+		work_stealing_deque<task*> tasks;
+		std::thread thread;
+		explicit worker(thread_pool* _pool) : pool(_pool) {}
+	};
+
+	std::vector<std::unique_ptr<worker>> workers;
+	std::mutex injected_lock;
+	deque<task*> injected;
+	std::atomic<size_t> injected_size;
+	std::mutex sleep_lock;
+	std::condition_variable wake;
+	std::atomic<int> sleeping;
+	std::atomic<bool> stopping;
+
+	// the worker the calling thread is, of any pool
+	static worker* &current() {
+		static thread_local worker* self = nullptr;
+		return self;
+	}
+
+	worker* own_worker() {
+		worker* self = current();
+		return self && self->pool == this ? self : nullptr;
+	}
+
+	void schedule(task* t) {
+		worker* self = own_worker();
+		if (self) {
+			self->tasks.push(t);
+		} else {
+			std::lock_guard<std::mutex> guard(injected_lock);
+			injected.push_back(t);
+			injected_size.fetch_add(1, std::memory_order_release);
+		}
+		if (sleeping.load(std::memory_order_relaxed)) {
+			wake.notify_one();
+		}
+	}
+
+	task* find_task() {
+		task* t = nullptr;
+		worker* self = own_worker();
+		if (self && self->tasks.pop(t)) {
+			return t;
+		}
+		if (injected_size.load(std::memory_order_acquire)) {
+			std::lock_guard<std::mutex> guard(injected_lock);
+			if (injected.try_pop_front(t)) {
+				injected_size.fetch_sub(1, std::memory_order_relaxed);
+				return t;
+			}
+		}
+		// from a pseudo-random victim on, so the thieves do not all start at the same one
+		static thread_local size_t seed = std::hash<std::thread::id>()(std::this_thread::get_id());
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		size_t n = workers.size(), start = (seed >> 33) % n;
+		for (size_t i = 0; i < n; ++i) {
+			worker* victim = workers[(start + i) % n].get();
+			if (victim != self && victim->tasks.steal(t)) {
+				return t;
+			}
+		}
+		return nullptr;
+	}
+
+	void execute(task* t) {
+		task_group* group = t->group;
+		try {
+			t->f();
+		} catch (...) {
+			std::lock_guard<std::mutex> guard(group->error_lock);
+			if (!group->error) {
+				group->error = std::current_exception();
+			}
+		}
+		delete t;
+		// the group may be destroyed as soon as this reaches 0
+		group->pending.fetch_sub(1, std::memory_order_release);
+	}
+
+	void work(worker* self) {
+		current() = self;
+		int idle = 0;
+		while (!stopping.load(std::memory_order_relaxed)) {
+			task* t = find_task();
+			if (t) {
+				execute(t);
+				idle = 0;
+			} else if (++idle < pool_detail::IDLE_SPINS) {
+				std::this_thread::yield();
+			} else {
+				// a wakeup sent just before the wait is missed, hence the timeout
+				std::unique_lock<std::mutex> lock(sleep_lock);
+				sleeping.fetch_add(1);
+				wake.wait_for(lock, std::chrono::milliseconds(pool_detail::IDLE_SLEEP_MS));
+				sleeping.fetch_sub(1);
+				idle = 0;
+			}
+		}
+		current() = nullptr;
+	}
+
+public:
+	/**
+	 * n_threads = 0 means one per hardware thread.
+	 */
+	explicit thread_pool(size_t n_threads = 0) : injected_size(0), sleeping(0), stopping(false) {
+		if (!n_threads) {
+			n_threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		for (size_t i = 0; i < n_threads; ++i) {
+			workers.push_back(std::unique_ptr<worker>(new worker(this)));
+		}
+		for (size_t i = 0; i < n_threads; ++i) {
+			worker* w = workers[i].get();
+			w->thread = std::thread([this, w] { work(w); });
+		}
+	}
+	thread_pool(const thread_pool &other) = delete;
+	thread_pool &operator=(const thread_pool &other) = delete;
+	/**
+	 * all the task groups must have been waited for.
+	 */
+	~thread_pool() {
+		stopping.store(true);
+		wake.notify_all();
+		for (std::unique_ptr<worker> &w : workers) {
+			w->thread.join();
+		}
+	}
+
+	size_t size() const {
+		return workers.size();
+	}
+};
+
+}
+
+#endif
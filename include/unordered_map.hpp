@@ -0,0 +1,580 @@
+/**
+ * implement a container like std::unordered_map
+ */
+#ifndef SJTU_UNORDERED_MAP_HPP
+#define SJTU_UNORDERED_MAP_HPP
+
+// only for std::hash<T> and std::equal_to<T>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+namespace hash_detail {
+    /**
+     * One control byte per slot: the 7 low bits of the hash for a full slot,
+     *   or one of the negative markers below.
+     */
+    typedef signed char ctrl_t;
+    const ctrl_t EMPTY = -128;
+    const ctrl_t DELETED = -2;
+
+    // slots whose control bytes are matched at once, the capacity is a power of two multiple of it
+    const size_t GROUP_WIDTH = 16;
+
+    /**
+     * The control bytes of GROUP_WIDTH slots, each match returns a bitmask with bit i set
+     *   if slot i of the group matches, compared all at once with SSE2 where available.
+     */
+    struct group {
+#ifdef __SSE2__
+        __m128i ctrl;
+        explicit group(const ctrl_t *pos): ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+        unsigned match(ctrl_t h2) const {
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+        }
+        // EMPTY and DELETED are the only control bytes with the sign bit set
+        unsigned match_empty_or_deleted() const {
+            return _mm_movemask_epi8(ctrl);
+        }
+#else
+        const ctrl_t *ctrl;
+        explicit group(const ctrl_t *pos): ctrl(pos) {}
+
+        unsigned match(ctrl_t h2) const {
+            unsigned mask = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                mask |= static_cast<unsigned>(ctrl[i] == h2) << i;
+            }
+            return mask;
+        }
+        unsigned match_empty_or_deleted() const {
+            unsigned mask = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                mask |= static_cast<unsigned>(ctrl[i] < 0) << i;
+            }
+            return mask;
+        }
+#endif
+        unsigned match_empty() const {
+            return match(EMPTY);
+        }
+    };
+
+    inline size_t lowest_bit(unsigned mask) {
+        return __builtin_ctz(mask);
+    }
+
+    /**
+     * std::hash of integers is the identity in libstdc++, so the hash is mixed
+     *   before its low bits are split off as the control byte.
+     */
+    inline uint64_t mix(size_t h) {
+        uint64_t x = static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull;
+        return x ^ (x >> 32);
+    }
+}
+
+/**
+ * Open addressing hash map in the SwissTable layout: the slots hold the values themselves,
+ *   a separate array of control bytes is probed GROUP_WIDTH slots at a time,
+ *   so a lookup usually compares a single key and touches two cache lines.
+ * Unlike sjtu::map, the elements are in no particular order and inserting may move them:
+ *   a rehash invalidates all iterators and pointers, erasing invalidates only the erased one.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class KeyEqual = std::equal_to<Key>
+> class unordered_map {
+public:
+    typedef pair<const Key, T> value_type;
+
+private:
+    typedef hash_detail::ctrl_t ctrl_t;
+    static const size_t GROUP_WIDTH = hash_detail::GROUP_WIDTH;
+    static const size_t npos = static_cast<size_t>(-1);
+
+    ctrl_t* ctrl;
+    value_type* slots;
+    // a multiple of GROUP_WIDTH and a power of two, or 0 before the first insertion
+    size_t capacity;
+    size_t map_size;
+    // insertions into EMPTY slots left before a rehash, to keep the load factor under 7/8
+    size_t growth_left;
+    Hash hasher;
+    KeyEqual equal;
+
+public:
+	/**
+	 * see ForwardIterator at CppReference for help.
+	 *
+	 * if there is anything wrong throw invalid_iterator.
+	 *     like it = map.end(); ++it;
+	 * no check is done if SJTU_UNCHECKED is defined, see exceptions.hpp.
+	 */
+	class const_iterator;
+	class iterator {
+        friend class unordered_map;
+        friend class const_iterator;
+		const unordered_map* this_map;
+        size_t index;
+	public:
+		iterator():this_map(nullptr), index(0) {}
+        iterator(const unordered_map* m, size_t i): this_map(m), index(i) {}
+		iterator(const iterator &other) = default;
+
+		iterator operator++(int) {
+            iterator ret {*this};
+            ++*this;
+            return ret;
+        }
+		iterator & operator++() {
+            if (checked_access && (!this_map || index >= this_map->capacity)) {
+                throw invalid_iterator();
+            }
+
+            index = this_map->next_full(index + 1);
+            return *this;
+        }
+
+		value_type & operator*() const {
+            return this_map->slots[index];
+        }
+        value_type* operator->() const noexcept {
+            return &this_map->slots[index];
+        }
+
+		bool operator==(const iterator &rhs) const {
+            return this_map == rhs.this_map && index == rhs.index;
+        }
+		bool operator==(const const_iterator &rhs) const {
+            return rhs == *this;
+        }
+
+		bool operator!=(const iterator &rhs) const {
+            return this_map != rhs.this_map || index != rhs.index;
+        }
+		bool operator!=(const const_iterator &rhs) const {
+            return rhs != *this;
+        }
+	};
+	class const_iterator {
+    private:
+        const unordered_map* this_map;
+        size_t index;
+    public:
+        const_iterator():this_map(nullptr), index(0) {}
+        const_iterator(const unordered_map* m, size_t i): this_map(m), index(i) {}
+        const_iterator(const const_iterator &other) = default;
+        const_iterator(const iterator &other): this_map(other.this_map), index(other.index) {}
+
+        const_iterator operator++(int) {
+            const_iterator ret {*this};
+            ++*this;
+            return ret;
+        }
+        const_iterator& operator++() {
+            if (checked_access && (!this_map || index >= this_map->capacity)) {
+                throw invalid_iterator();
+            }
+
+            index = this_map->next_full(index + 1);
+            return *this;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return this_map == rhs.this_map && index == rhs.index;
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return this_map == rhs.this_map && index == rhs.index;
+        }
+
+        bool operator!=(const iterator &rhs) const {
+            return this_map != rhs.this_map || index != rhs.index;
+        }
+        bool operator!=(const const_iterator &rhs) const {
+            return this_map != rhs.this_map || index != rhs.index;
+        }
+
+        const value_type* operator->() const {
+            return &this_map->slots[index];
+        }
+        const value_type& operator*() const {
+            return this_map->slots[index];
+        }
+	};
+
+	unordered_map(): ctrl(nullptr), slots(nullptr), capacity(0), map_size(0), growth_left(0), hasher(), equal() {}
+	unordered_map(const unordered_map &other):
+            ctrl(nullptr), slots(nullptr), capacity(0), map_size(0), growth_left(0),
+            hasher(other.hasher), equal(other.equal) {
+        copy_from(other);
+    }
+
+	unordered_map & operator=(const unordered_map &other) {
+        if (this == &other) {
+            return *this;
+        }
+
+        destroy();
+        hasher = other.hasher;
+        equal = other.equal;
+        copy_from(other);
+
+        return *this;
+    }
+
+	~unordered_map() {
+        destroy();
+    }
+
+private:
+    static size_t max_load(size_t cap) {
+        return cap - cap / 8;
+    }
+
+    size_t next_full(size_t i) const {
+        while (i < capacity && ctrl[i] < 0) {
+            ++i;
+        }
+        return i;
+    }
+
+    /**
+     * The slot of key, or npos. The groups are probed in triangular order from the one
+     *   picked by the hash, which visits all of them since their number is a power of two,
+     *   and the search stops at the first group with an EMPTY slot.
+     */
+    size_t find_index(const Key &key, uint64_t h) const {
+        if (!capacity) {
+            return npos;
+        }
+
+        const size_t group_mask = capacity / GROUP_WIDTH - 1;
+        const ctrl_t h2 = static_cast<ctrl_t>(h & 0x7F);
+        size_t g = (h >> 7) & group_mask;
+        for (size_t step = 1; ; ++step) {
+            hash_detail::group grp(ctrl + g * GROUP_WIDTH);
+            for (unsigned mask = grp.match(h2); mask; mask &= mask - 1) {
+                size_t i = g * GROUP_WIDTH + hash_detail::lowest_bit(mask);
+                if (equal(slots[i].first, key)) {
+                    return i;
+                }
+            }
+            if (grp.match_empty()) {
+                return npos;
+            }
+            g = (g + step) & group_mask;
+        }
+    }
+
+    size_t find_index(const Key &key) const {
+        return find_index(key, hash_detail::mix(hasher(key)));
+    }
+
+    // the first EMPTY or DELETED slot in the probe sequence of h
+    size_t find_free(uint64_t h) const {
+        const size_t group_mask = capacity / GROUP_WIDTH - 1;
+        size_t g = (h >> 7) & group_mask;
+        for (size_t step = 1; ; ++step) {
+            unsigned mask = hash_detail::group(ctrl + g * GROUP_WIDTH).match_empty_or_deleted();
+            if (mask) {
+                return g * GROUP_WIDTH + hash_detail::lowest_bit(mask);
+            }
+            g = (g + step) & group_mask;
+        }
+    }
+
+    // the table is only replaced once both arrays are allocated, the caller frees the old one
+    void allocate(size_t cap) {
+        ctrl_t* new_ctrl = new ctrl_t[cap];
+        value_type* new_slots;
+        try {
+            new_slots = static_cast<value_type*>(::operator new(cap * sizeof(value_type)));
+        } catch (...) {
+            delete[] new_ctrl;
+            throw;
+        }
+        std::memset(new_ctrl, hash_detail::EMPTY, cap);
+        ctrl = new_ctrl;
+        slots = new_slots;
+        capacity = cap;
+        growth_left = max_load(cap);
+    }
+
+    void destroy() {
+        if (!capacity) {
+            return;
+        }
+
+        for (size_t i = 0; i < capacity; ++i) {
+            if (ctrl[i] >= 0) {
+                slots[i].~value_type();
+            }
+        }
+        delete[] ctrl;
+        ::operator delete(slots);
+        ctrl = nullptr;
+        slots = nullptr;
+        capacity = map_size = growth_left = 0;
+    }
+
+    void copy_from(const unordered_map &other) {
+        if (!other.map_size) {
+            return;
+        }
+
+        allocate(other.capacity);
+        try {
+            for (size_t i = 0; i < capacity; ++i) {
+                if (other.ctrl[i] >= 0) {
+                    new (slots + i) value_type(other.slots[i]);
+                    ctrl[i] = other.ctrl[i];
+                    ++map_size;
+                }
+            }
+        } catch (...) {
+            // the elements copied so far are marked, destroy() frees them
+            destroy();
+            throw;
+        }
+        // the DELETED markers too, the elements after them are found through them
+        std::memcpy(ctrl, other.ctrl, capacity);
+        growth_left = other.growth_left;
+    }
+
+    // move every element into a table of cap slots, dropping the DELETED markers
+    void rehash(size_t cap) {
+        ctrl_t* old_ctrl = ctrl;
+        value_type* old_slots = slots;
+        size_t old_capacity = capacity;
+
+        allocate(cap);
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (old_ctrl[i] >= 0) {
+                uint64_t h = hash_detail::mix(hasher(old_slots[i].first));
+                size_t j = find_free(h);
+                new (slots + j) value_type(std::move(old_slots[i]));
+                old_slots[i].~value_type();
+                ctrl[j] = static_cast<ctrl_t>(h & 0x7F);
+            }
+        }
+        growth_left -= map_size;
+
+        delete[] old_ctrl;
+        ::operator delete(old_slots);
+    }
+
+    // the value is constructed in a free slot from args, key must not be present
+    template<class... Args>
+    size_t insert_helper(uint64_t h, Args&&... args) {
+        size_t i = capacity ? find_free(h) : npos;
+        if (!capacity || (!growth_left && ctrl[i] == hash_detail::EMPTY)) {
+            // grow, unless most of the used slots are DELETED ones
+            if (!capacity) {
+                rehash(GROUP_WIDTH);
+            } else {
+                rehash(map_size + 1 > max_load(capacity) / 2 ? capacity * 2 : capacity);
+            }
+            i = find_free(h);
+        }
+
+        new (slots + i) value_type(std::forward<Args>(args)...);
+        growth_left -= ctrl[i] == hash_detail::EMPTY;
+        ctrl[i] = static_cast<ctrl_t>(h & 0x7F);
+        ++map_size;
+
+        return i;
+    }
+
+public:
+
+	/**
+	 * Returns a reference to the mapped value
+	 * an exception of type `index_out_of_bound'
+	 */
+	T & at(const Key &key) {
+        size_t i = find_index(key);
+
+        if (i == npos) {
+            throw index_out_of_bound();
+        }
+
+        return slots[i].second;
+    }
+	const T & at(const Key &key) const {
+        size_t i = find_index(key);
+
+        if (i == npos) {
+            throw index_out_of_bound();
+        }
+
+        return slots[i].second;
+    }
+	/**
+	 * Returns a pointer to the mapped value, or nullptr if such key does not exist.
+	 */
+	T * find_ptr(const Key &key) {
+        size_t i = find_index(key);
+
+        return i == npos ? nullptr : &slots[i].second;
+    }
+	const T * find_ptr(const Key &key) const {
+        size_t i = find_index(key);
+
+        return i == npos ? nullptr : &slots[i].second;
+    }
+
+	/**
+	 * access specified element
+	 *   performing an insertion if such key does not already exist.
+	 */
+	T & operator[](const Key &key) {
+        uint64_t h = hash_detail::mix(hasher(key));
+        size_t i = find_index(key, h);
+
+        if (i == npos) {
+            i = insert_helper(h, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>());
+        }
+
+        return slots[i].second;
+    }
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const {
+        return at(key);
+    }
+
+	iterator begin() const {
+        return iterator(this, next_full(0));
+    }
+	const_iterator cbegin() const {
+        return const_iterator(this, next_full(0));
+    }
+
+	iterator end() const {
+        return iterator(this, capacity);
+    }
+	const_iterator cend() const {
+        return const_iterator(this, capacity);
+    }
+
+	bool empty() const {
+        return !map_size;
+    }
+
+	size_t size() const {
+        return map_size;
+    }
+
+	/**
+	 * removes all the elements but keeps the slots allocated.
+	 */
+	void clear() {
+        for (size_t i = 0; i < capacity; ++i) {
+            if (ctrl[i] >= 0) {
+                slots[i].~value_type();
+            }
+        }
+        if (capacity) {
+            std::memset(ctrl, hash_detail::EMPTY, capacity);
+        }
+        map_size = 0;
+        growth_left = max_load(capacity);
+    }
+
+	/**
+	 * allocates the slots for n elements at once, so the next n insertions do not rehash.
+	 */
+	void reserve(size_t n) {
+        size_t cap = GROUP_WIDTH;
+        while (max_load(cap) < n) {
+            cap *= 2;
+        }
+        if (cap > capacity) {
+            rehash(cap);
+        }
+    }
+
+	/**
+	 * the number of slots, size() / bucket_count() is the load factor.
+	 */
+	size_t bucket_count() const {
+        return capacity;
+    }
+
+	/**
+	 * insert an element.
+	 * return a pair, the first of the pair is
+	 *   the iterator to the new element (or the element that prevented the insertion),
+	 *   the second one is true if insert successfully, or false.
+	 */
+	pair<iterator, bool> insert(value_type value) {
+        uint64_t h = hash_detail::mix(hasher(value.first));
+        size_t i = find_index(value.first, h);
+
+        if (i != npos) {
+            return pair<iterator, bool>(iterator(this, i), false);
+        } else {
+            i = insert_helper(h, std::move(value));
+            return pair<iterator, bool>(iterator(this, i), true);
+        }
+    }
+
+	/**
+	 * erase the element at pos.
+	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+	 */
+	void erase(iterator pos) {
+        if (pos.this_map != this || pos.index >= capacity || ctrl[pos.index] < 0) {
+            throw index_out_of_bound();
+        }
+
+        size_t i = pos.index;
+        slots[i].~value_type();
+        // a lookup stops at a group with an EMPTY slot, so if this group has one
+        //   no probe sequence goes on past it and the slot can be EMPTY again
+        if (hash_detail::group(ctrl + i / GROUP_WIDTH * GROUP_WIDTH).match_empty()) {
+            ctrl[i] = hash_detail::EMPTY;
+            ++growth_left;
+        } else {
+            ctrl[i] = hash_detail::DELETED;
+        }
+        --map_size;
+    }
+	/**
+	 * Returns the number of elements with key, either 1 or 0
+	 */
+	size_t count(const Key &key) const {
+        return find_index(key) == npos ? 0 : 1;
+    }
+	/**
+	 * Finds an element with key equivalent to key.
+	 *   If no such element is found, past-the-end (see end()) iterator is returned.
+	 */
+	iterator find(const Key &key) {
+        size_t i = find_index(key);
+
+        return iterator(this, i == npos ? capacity : i);
+    }
+	const_iterator find(const Key &key) const {
+        size_t i = find_index(key);
+
+        return const_iterator(this, i == npos ? capacity : i);
+    }
+};
+}
+
+#endif
@@ -1,27 +1,64 @@
 #ifndef SJTU_UTILITY_HPP
 #define SJTU_UTILITY_HPP
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace sjtu {
-    
+
+    namespace detail {
+        // std::index_sequence is C++14
+        template<std::size_t... I>
+        struct index_sequence {};
+
+        template<std::size_t N, std::size_t... I>
+        struct make_index_sequence : make_index_sequence<N - 1, N - 1, I...> {};
+
+        template<std::size_t... I>
+        struct make_index_sequence<0, I...> : index_sequence<I...> {};
+    }
+
     template<class T1, class T2>
     class pair {
     public:
+        typedef T1 first_type;
+        typedef T2 second_type;
+
         T1 first;
         T2 second;
         constexpr pair() : first(), second() {}
+        // all defaulted, so a pair of trivially copyable types is trivially copyable
         pair(const pair &other) = default;
         pair(pair &&other) = default;
+        pair &operator=(const pair &other) = default;
+        pair &operator=(pair &&other) = default;
         pair(const T1 &x, const T2 &y) : first(x), second(y) {}
-        template<class U1, class U2>
-        pair(U1 &&x, U2 &&y) : first(x), second(y) {}
+        template<class U1, class U2, class = typename std::enable_if<
+                std::is_constructible<T1, U1 &&>::value && std::is_constructible<T2, U2 &&>::value>::type>
+        pair(U1 &&x, U2 &&y) : first(std::forward<U1>(x)), second(std::forward<U2>(y)) {}
         template<class U1, class U2>
         pair(const pair<U1, U2> &other) : first(other.first), second(other.second) {}
         template<class U1, class U2>
-        pair(pair<U1, U2> &&other) : first(other.first), second(other.second) {}
+        pair(pair<U1, U2> &&other) : first(std::forward<U1>(other.first)), second(std::forward<U2>(other.second)) {}
+        /**
+         * construct first and second in place from the arguments packed in each tuple,
+         *   e.g. pair<const Key, T>(std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>())
+         */
+        template<class... Args1, class... Args2>
+        pair(std::piecewise_construct_t, std::tuple<Args1...> args1, std::tuple<Args2...> args2)
+            : pair(args1, args2, detail::make_index_sequence<sizeof...(Args1)>(),
+                   detail::make_index_sequence<sizeof...(Args2)>()) {}
+
+    private:
+        template<class... Args1, class... Args2, std::size_t... I1, std::size_t... I2>
+        pair(std::tuple<Args1...> &args1, std::tuple<Args2...> &args2,
+             detail::index_sequence<I1...>, detail::index_sequence<I2...>)
+            : first(std::forward<Args1>(std::get<I1>(args1))...),
+              second(std::forward<Args2>(std::get<I2>(args2))...) {}
     };
-    
+
 }
 
 #endif
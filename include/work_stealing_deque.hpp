@@ -0,0 +1,148 @@
+#ifndef SJTU_WORK_STEALING_DEQUE_HPP
+#define SJTU_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace sjtu {
+
+/**
+ * Chase-Lev work-stealing deque (Chase and Lev, "Dynamic Circular Work-Stealing Deque",
+ *   with the memory orders of Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models").
+ * One owner thread pushes and pops at the bottom, like a stack, while any number
+ *   of thieves steal from the top, the oldest elements. Only a steal, and a pop racing
+ *   one for the last element, take a CAS, so the owner's common path is a few plain stores.
+ * The circular array doubles when full. Thieves may still read the old one, so it is
+ *   kept until the deque is destroyed, at most as much memory again as the final array.
+ * T is copied racily by the thieves that then lose the CAS, so it must be trivially copyable,
+ *   typically a pointer to the task.
+ */
+template<class T>
+class work_stealing_deque {
+	static_assert(std::is_trivially_copyable<T>::value, "work_stealing_deque needs a trivially copyable type");
+
+	struct ring {
+		std::ptrdiff_t mask;
+		std::atomic<T>* slots;
+
+		explicit ring(std::ptrdiff_t capacity) : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+		~ring() {
+			delete[] slots;
+		}
+
+		T get(std::ptrdiff_t i) const {
+			return slots[i & mask].load(std::memory_order_relaxed);
+		}
+		void put(std::ptrdiff_t i, const T &value) {
+			slots[i & mask].store(value, std::memory_order_relaxed);
+		}
+	};
+
+	std::atomic<std::ptrdiff_t> top;
+	// top is written by the thieves, bottom by the owner, kept a cache line apart
+	char padding[64 - sizeof(std::atomic<std::ptrdiff_t>)];
+	std::atomic<std::ptrdiff_t> bottom;
+	std::atomic<ring*> array;
+	// the arrays replaced by a larger one, only touched by the owner
+	std::vector<ring*> retired;
+
+public:
+	/**
+	 * capacity is the initial one, a power of two.
+	 */
+	explicit work_stealing_deque(std::ptrdiff_t capacity = 64) : top(0), bottom(0), array(new ring(capacity)) {}
+	work_stealing_deque(const work_stealing_deque &other) = delete;
+	work_stealing_deque &operator=(const work_stealing_deque &other) = delete;
+	/**
+	 * no other thread may be using the deque any more.
+	 */
+	~work_stealing_deque() {
+		delete array.load();
+		for (ring* r : retired) {
+			delete r;
+		}
+	}
+
+	/**
+	 * adds value at the bottom, only the owner may call it.
+	 */
+	void push(const T &value) {
+		std::ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+		std::ptrdiff_t t = top.load(std::memory_order_acquire);
+		ring* a = array.load(std::memory_order_relaxed);
+		if (b - t > a->mask) {
+			// nothing changes if the allocations throw
+			std::unique_ptr<ring> bigger(new ring(2 * (a->mask + 1)));
+			for (std::ptrdiff_t i = t; i < b; ++i) {
+				bigger->put(i, a->get(i));
+			}
+			retired.push_back(a);
+			a = bigger.release();
+			array.store(a, std::memory_order_release);
+		}
+		a->put(b, value);
+		bottom.store(b + 1, std::memory_order_release);
+	}
+	/**
+	 * moves the bottom element, the last pushed, into value and removes it, only the owner may call it.
+	 *     return false, leaving value untouched, when the deque is empty.
+	 */
+	bool pop(T &value) {
+		std::ptrdiff_t b = bottom.load(std::memory_order_relaxed) - 1;
+		ring* a = array.load(std::memory_order_relaxed);
+		// seq_cst: the thieves must see the new bottom before this thread reads top
+		bottom.store(b, std::memory_order_seq_cst);
+		std::ptrdiff_t t = top.load(std::memory_order_seq_cst);
+		if (t > b) {
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+		T ret = a->get(b);
+		if (t == b) {
+			// the last element, a thief may be taking it too
+			bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			if (!won) {
+				return false;
+			}
+		}
+		value = ret;
+		return true;
+	}
+	/**
+	 * moves the top element, the oldest, into value and removes it, any thread may call it.
+	 *     return false, leaving value untouched, when the deque is empty or another thread took the element.
+	 */
+	bool steal(T &value) {
+		std::ptrdiff_t t = top.load(std::memory_order_seq_cst);
+		std::ptrdiff_t b = bottom.load(std::memory_order_seq_cst);
+		if (t >= b) {
+			return false;
+		}
+		T ret = array.load(std::memory_order_acquire)->get(t);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return false;
+		}
+		value = ret;
+		return true;
+	}
+
+	/**
+	 * only exact when no other thread is using the deque.
+	 */
+	size_t size() const {
+		std::ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+		std::ptrdiff_t t = top.load(std::memory_order_relaxed);
+		return b > t ? b - t : 0;
+	}
+	bool empty() const {
+		return !size();
+	}
+};
+
+}
+
+#endif
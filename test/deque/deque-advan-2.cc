@@ -1498,7 +1498,11 @@ static CheckerPair TEST_B[] = {
 };
 
 #define __CORRECT_TEST
+#ifdef __BENCHMARK
+#define __SPEED_TEST
+#else
 #define __OFFICAL
+#endif
 
 int main() {
 #ifndef __OFFICAL
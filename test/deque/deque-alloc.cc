@@ -0,0 +1,98 @@
+#include "deque.hpp"
+#include "alloc-counter.hpp"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+
+// built with SJTU_COUNT_ALLOCATIONS and linked with the global operator new and delete hooks
+
+static const int N = 3000;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+typedef sjtu::deque<long> Deque;
+
+std::pair<bool, double> pushChecker() {
+    sjtu::alloc_stats start = Deque::allocation_stats();
+    Bench::AllocScope scope;
+    Deque a;
+    for (int i = 0; i < N; i++) {
+        if (i % 2) a.push_back(i); else a.push_front(i);
+    }
+    // a node and an element for each, and the two dummy nodes, nothing else
+    sjtu::alloc_stats now = Deque::allocation_stats();
+    bool ok = now.allocations - start.allocations == 2 * N + 2 && scope.Allocations() == 2 * N + 2;
+    ok = ok && now.live - start.live == now.bytes - start.bytes && now.peak >= now.live;
+    return std::make_pair(ok && now.deallocations == start.deallocations, 0);
+}
+
+std::pair<bool, double> freeChecker() {
+    sjtu::alloc_stats start = Deque::allocation_stats();
+    Bench::AllocScope scope;
+    {
+        Deque a;
+        for (int i = 0; i < N; i++) a.push_back(i);
+        Deque b(a);
+        for (int i = 0; i < N / 2; i++) {
+            a.pop_back();
+            b.erase(b.begin());
+        }
+        a.clear();
+    }
+    sjtu::alloc_stats now = Deque::allocation_stats();
+    return std::make_pair(now.allocations - start.allocations == now.deallocations - start.deallocations &&
+            now.live == start.live && scope.Leaked() == 0, 0);
+}
+
+std::pair<bool, double> peakChecker() {
+    Deque a;
+    for (int i = 0; i < N; i++) a.push_back(i);
+    sjtu::alloc_stats full = Deque::allocation_stats();
+    while (!a.empty()) a.pop_front();
+    Deque::reset_allocation_peak();
+    sjtu::alloc_stats empty = Deque::allocation_stats();
+    a.push_back(0);
+    sjtu::alloc_stats one = Deque::allocation_stats();
+    // one element is a node and a long, a little of what N of them were
+    return std::make_pair(full.peak >= full.live && empty.peak == empty.live &&
+            one.peak == one.live && one.live - empty.live == (full.live - empty.live) / N, 0);
+}
+
+std::pair<bool, double> typeChecker() {
+    // other instantiations count on their own
+    size_t before = Deque::allocation_stats().allocations;
+    sjtu::deque<std::string> a;
+    a.push_back("a");
+    return std::make_pair(Deque::allocation_stats().allocations == before &&
+            sjtu::deque<std::string>::allocation_stats().allocations == 4, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Allocations -> push_back/push_front testing...", pushChecker),
+    std::make_pair("Allocations -> copy, pop, erase and clear testing...", freeChecker),
+    std::make_pair("Allocations -> peak testing...", peakChecker),
+    std::make_pair("Allocations -> instantiations testing...", typeChecker),
+};
+
+int main() {
+    puts("Deque Allocations CheckTool Offical Version");
+    puts("");
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+    return 0;
+}
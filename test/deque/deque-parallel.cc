@@ -0,0 +1,270 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+static const int N = 100000;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+typedef std::pair<unsigned long long, unsigned long long> Affine;
+
+static sjtu::thread_pool pool(4);
+
+// x -> a * x + b, then the other one, associative but not commutative
+Affine compose(const Affine &f, const Affine &g) {
+    return Affine(g.first * f.first, g.first * f.second + g.second);
+}
+
+bool sameDeque(const sjtu::deque<long> &d, const std::vector<long> &v) {
+    if (d.size() != v.size()) return false;
+    sjtu::deque<long>::const_iterator it = d.cbegin();
+    for (size_t i = 0; i < v.size(); ++i, ++it) {
+        if (*it != v[i]) return false;
+    }
+    if (it != d.cend()) return false;
+    // the links back must be right too
+    for (size_t i = v.size(); i > 0; --i) {
+        if (*--it != v[i - 1]) return false;
+    }
+    return true;
+}
+
+std::pair<bool, double> dequeForEachChecker() {
+    sjtu::deque<long> d, empty;
+    std::vector<long> expected;
+    for (int i = 0; i < N; ++i) {
+        d.push_back(i);
+        expected.push_back(3 * i);
+    }
+    sjtu::parallel::for_each(pool, d, [](long &x) { x *= 3; });
+    sjtu::parallel::for_each(pool, empty, [](long &x) { x = -1; });
+    std::atomic<long> sum(0);
+    const sjtu::deque<long> &cd = d;
+    sjtu::parallel::for_each(pool, cd, [&sum](const long &x) { sum += x; });
+    return std::make_pair(sameDeque(d, expected) && empty.empty() && sum == 3L * N * (N - 1) / 2, 0);
+}
+
+std::pair<bool, double> dequeTransformChecker() {
+    sjtu::deque<int> d;
+    sjtu::deque<long> out, empty;
+    std::vector<long> expected;
+    for (int i = 0; i < N; ++i) {
+        d.push_back(i);
+        expected.push_back((long)i * i);
+    }
+    out.push_back(-1);
+    sjtu::parallel::transform(pool, d, out, [](int x) { return (long)x * x; });
+    bool ok = sameDeque(out, expected);
+    // in place
+    sjtu::parallel::transform(pool, out, out, [](long x) { return x + 1; });
+    for (long &x : expected) ++x;
+    ok = ok && sameDeque(out, expected);
+    sjtu::parallel::transform(pool, sjtu::deque<int>(), out, [](int x) { return (long)x; });
+    ok = ok && out.empty();
+    out.push_back(7);
+    out.push_back(8);
+    return std::make_pair(ok && out.size() == 2 && out.front() == 7 && out.back() == 8, 0);
+}
+
+std::pair<bool, double> dequeReduceChecker() {
+    sjtu::deque<long> d;
+    Affine serial(1, 0);
+    for (int i = 0; i < N; ++i) {
+        d.push_back(i % 1000);
+        serial = compose(serial, Affine(3, i % 1000));
+    }
+    long sum = sjtu::parallel::reduce(pool, d, 0L, [](long a, long b) { return a + b; });
+    Affine composed = sjtu::parallel::transform_reduce(pool, d, Affine(1, 0), compose, [](long x) {
+        return Affine(3, x);
+    });
+    long none = sjtu::parallel::reduce(pool, sjtu::deque<long>(), 5L, [](long a, long b) { return a + b; });
+    return std::make_pair(sum == 100L * 499500 && composed == serial && none == 5, 0);
+}
+
+std::pair<bool, double> dequeSortChecker() {
+    // few keys so the stability shows, the second member is the position before sorting
+    std::mt19937 rng(2017);
+    sjtu::deque<std::pair<int, int>> d;
+    std::vector<std::pair<int, int>> v;
+    for (int i = 0; i < N; ++i) {
+        std::pair<int, int> x((int)(rng() % 100), i);
+        d.push_back(x);
+        v.push_back(x);
+    }
+    auto by_key = [](const std::pair<int, int> &a, const std::pair<int, int> &b) { return a.first < b.first; };
+    std::pair<int, int> *first = &*d.begin();
+    sjtu::parallel::sort(pool, d, by_key);
+    std::stable_sort(v.begin(), v.end(), by_key);
+    bool ok = d.size() == v.size();
+    sjtu::deque<std::pair<int, int>>::iterator it = d.begin();
+    bool moved = false;
+    for (size_t i = 0; ok && i < v.size(); ++i, ++it) {
+        ok = *it == v[i];
+        // the element first pointed to is still in the deque, not a copy of it
+        moved = moved || &*it == first;
+    }
+    // ints are sorted by value
+    sjtu::deque<int> ints, none;
+    for (int i = 0; i < N; ++i) ints.push_back(N - 1 - i);
+    sjtu::parallel::sort(pool, ints);
+    sjtu::parallel::sort(pool, none);
+    int expected = 0;
+    for (sjtu::deque<int>::iterator i = ints.begin(); i != ints.end(); ++i) ok = ok && *i == expected++;
+    // a plain range
+    std::vector<int> values;
+    for (int i = 0; i < N; ++i) values.push_back((int)(rng() % 1000000));
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    sjtu::parallel::sort(pool, values.begin(), values.end());
+    return std::make_pair(ok && moved && expected == N && none.empty() && values == sorted, 0);
+}
+
+std::pair<bool, double> mapChecker() {
+    sjtu::map<int, int> m;
+    std::mt19937 rng(2018);
+    Affine serial(1, 0);
+    std::vector<int> keys;
+    for (int i = 0; i < N; ++i) keys.push_back(i);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (int key : keys) m[key] = key;
+    for (int i = 0; i < N; ++i) serial = compose(serial, Affine(3, 2 * i));
+    sjtu::parallel::for_each(pool, m, [](sjtu::pair<const int, int> &x) { x.second *= 2; });
+    // in key order
+    Affine composed = sjtu::parallel::transform_reduce(pool, m, Affine(1, 0), compose,
+            [](const sjtu::pair<const int, int> &x) { return Affine(3, x.second); });
+    sjtu::map<int, long> out;
+    out[-1] = -1;
+    sjtu::parallel::transform(pool, m, out, [](const sjtu::pair<const int, int> &x) { return (long)x.first + x.second; });
+    bool ok = composed == serial && out.size() == (size_t)N && !out.count(-1);
+    int expected = 0;
+    for (sjtu::map<int, long>::const_iterator it = out.cbegin(); ok && it != out.cend(); ++it, ++expected) {
+        ok = it->first == expected && it->second == 3L * expected;
+    }
+    // the copy is a working map
+    out.erase(out.find(N / 2));
+    out[N] = 0;
+    ok = ok && expected == N && out.size() == (size_t)N && !out.count(N / 2) && out.at(N) == 0;
+    sjtu::parallel::transform(pool, m, m, [](const sjtu::pair<const int, int> &x) { return x.second + 1; });
+    std::atomic<long> sum(0);
+    const sjtu::map<int, int> &cm = m;
+    sjtu::parallel::for_each(pool, cm, [&sum](const sjtu::pair<const int, int> &x) { sum += x.second; });
+    return std::make_pair(ok && sum == (long)N * (N - 1) + N && m.at(7) == 15, 0);
+}
+
+std::pair<bool, double> mapBuildChecker() {
+    // a batch with repeated keys into a map holding some of them already
+    std::mt19937 rng(2019);
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < N; ++i) batch.push_back(std::make_pair((int)(rng() % (N / 2)), i));
+    sjtu::map<int, int> m, serial;
+    for (int i = 0; i < N / 2; i += 7) {
+        m[i] = -1;
+        serial[i] = -1;
+    }
+    for (const std::pair<int, int> &x : batch) serial.insert(sjtu::pair<const int, int>(x.first, x.second));
+    sjtu::parallel::insert(pool, m, batch.begin(), batch.end());
+    bool ok = m.size() == serial.size();
+    sjtu::map<int, int>::const_iterator it = m.cbegin();
+    for (sjtu::map<int, int>::const_iterator jt = serial.cbegin(); ok && jt != serial.cend(); ++it, ++jt) {
+        ok = it->first == jt->first && it->second == jt->second;
+    }
+    ok = ok && it == m.cend();
+    // an empty batch, and into an empty map
+    sjtu::parallel::insert(pool, m, batch.begin(), batch.begin());
+    sjtu::map<int, int> fresh, serial_fresh;
+    sjtu::parallel::insert(pool, fresh, batch.begin(), batch.end());
+    for (const std::pair<int, int> &x : batch) serial_fresh.insert(sjtu::pair<const int, int>(x.first, x.second));
+    ok = ok && m.size() == serial.size() && fresh.size() == serial_fresh.size();
+    for (it = fresh.cbegin(); ok && it != fresh.cend(); ++it) ok = it->second == serial_fresh.at(it->first);
+    // merging the two
+    sjtu::map<int, int> odd;
+    for (int i = 1; i < N; i += 2) odd[i] = i;
+    sjtu::parallel::merge(pool, m, odd);
+    size_t expected = serial.size();
+    for (int i = 1; i < N; i += 2) expected += !serial.count(i);
+    ok = ok && m.size() == expected && odd.size() == (size_t)N / 2 - (expected - serial.size());
+    int previous = -1;
+    for (it = m.cbegin(); ok && it != m.cend(); ++it) {
+        ok = it->first > previous && (!serial.count(it->first) || it->second == serial.at(it->first));
+        previous = it->first;
+    }
+    return std::make_pair(ok, 0);
+}
+
+std::pair<bool, double> exceptionChecker() {
+    sjtu::deque<int> d;
+    for (int i = 0; i < N; ++i) d.push_back(i);
+    sjtu::deque<int> out;
+    out.push_back(42);
+    bool caught = false;
+    try {
+        sjtu::parallel::transform(pool, d, out, [](int x) {
+            if (x == N / 3) throw std::runtime_error("bad element");
+            return x;
+        });
+    } catch (std::runtime_error &) {
+        caught = true;
+    }
+    bool ok = caught && out.size() == 1 && out.front() == 42;
+    sjtu::map<int, int> m, m_out;
+    for (int i = 0; i < N; ++i) m[i] = i;
+    m_out[1] = 1;
+    caught = false;
+    try {
+        sjtu::parallel::transform(pool, m, m_out, [](const sjtu::pair<const int, int> &x) {
+            if (x.first == N / 3) throw std::runtime_error("bad element");
+            return x.second;
+        });
+    } catch (std::runtime_error &) {
+        caught = true;
+    }
+    ok = ok && caught && m_out.size() == 1 && m_out.at(1) == 1;
+    caught = false;
+    try {
+        sjtu::parallel::sort(pool, d, [](int a, int b) {
+            if (a == N / 2) throw std::runtime_error("bad comparison");
+            return a > b;
+        });
+    } catch (std::runtime_error &) {
+        caught = true;
+    }
+    return std::make_pair(ok && caught && d.front() == 0 && d.back() == N - 1, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Parallel -> deque for_each testing...", dequeForEachChecker),
+    std::make_pair("Parallel -> deque transform testing...", dequeTransformChecker),
+    std::make_pair("Parallel -> deque reduce testing...", dequeReduceChecker),
+    std::make_pair("Parallel -> deque and range stable sort testing...", dequeSortChecker),
+    std::make_pair("Parallel -> map for_each/transform/reduce testing...", mapChecker),
+    std::make_pair("Parallel -> map bulk insert and merge testing...", mapBuildChecker),
+    std::make_pair("Parallel -> exceptions testing...", exceptionChecker),
+};
+
+int main() {
+    puts("Deque Parallel CheckTool Offical Version");
+    puts("");
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "ring_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static const int N = 200000;
+static const int THREADS = 4;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+template<class Queue>
+std::pair<bool, double> singleThreadChecker() {
+    Queue q(100);
+    int value = -1;
+    if (q.capacity() != 128 || !q.empty() || q.try_pop(value) || value != -1) return std::make_pair(false, 0);
+    // many laps around the ring, with the queue half full
+    int next_push = 0, next_pop = 0;
+    for (int round = 0; round < 1000; ++round) {
+        while (q.try_push(next_push)) ++next_push;
+        if (q.size() != 128) return std::make_pair(false, 0);
+        for (int i = 0; i < 64 + round % 64; ++i) {
+            if (!q.try_pop(value) || value != next_pop++) return std::make_pair(false, 0);
+        }
+    }
+    // the batches stop at the free cells and at the elements present
+    std::vector<int> batch(300);
+    for (int i = 0; i < 300; ++i) batch[i] = next_push + i;
+    size_t pushed = q.try_push_batch(batch.begin(), 300);
+    next_push += pushed;
+    if (q.size() != 128) return std::make_pair(false, 0);
+    std::vector<int> out(300, -1);
+    size_t popped = q.try_pop_batch(out.begin(), 300);
+    if (popped != 128 || q.try_pop_batch(out.begin(), 5) || !q.empty()) return std::make_pair(false, 0);
+    for (size_t i = 0; i < popped; ++i) {
+        if (out[i] != next_pop++) return std::make_pair(false, 0);
+    }
+    return std::make_pair(next_pop == next_push, 0);
+}
+
+std::pair<bool, double> mpmcChecker() {
+    sjtu::mpmc_queue<int> q(64);
+    std::atomic<int> popped(0), disordered(0);
+    std::atomic<long> sum(0);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < THREADS; ++p) {
+        threads.push_back(std::thread([&q, p] {
+            // producer p pushes p, p + THREADS, ..., half of them in batches of 8
+            int batch[8];
+            for (int i = p; i < N; ) {
+                if (i / THREADS % 2) {
+                    int n = 0;
+                    for (; n < 8 && i + n * THREADS < N; ++n) batch[n] = i + n * THREADS;
+                    int done = q.try_push_batch(batch, n);
+                    i += done * THREADS;
+                    if (!done) std::this_thread::yield();
+                } else if (q.try_push(i)) {
+                    i += THREADS;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    for (int c = 0; c < THREADS; ++c) {
+        threads.push_back(std::thread([&q, &popped, &disordered, &sum, c] {
+            // every consumer sees the elements of each producer in order
+            std::vector<int> last(THREADS, -1);
+            int out[5];
+            while (popped < N) {
+                int n = c % 2 ? static_cast<int>(q.try_pop_batch(out, 5)) : q.try_pop(out[0]);
+                if (!n) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                popped += n;
+                for (int i = 0; i < n; ++i) {
+                    disordered += out[i] <= last[out[i] % THREADS];
+                    last[out[i] % THREADS] = out[i];
+                    sum += out[i];
+                }
+            }
+        }));
+    }
+    for (std::thread &t : threads) t.join();
+    return std::make_pair(popped == N && !disordered && sum == 1L * N * (N - 1) / 2 && q.empty(), 0);
+}
+
+std::pair<bool, double> spscChecker() {
+    sjtu::spsc_queue<int> q(256);
+    bool ordered = true;
+    std::thread consumer([&q, &ordered] {
+        int expected = 0, out[7];
+        while (expected < N) {
+            size_t n = expected % 3 ? q.try_pop_batch(out, 7) : q.try_pop(out[0]);
+            if (!n) std::this_thread::yield();
+            for (size_t i = 0; i < n; ++i) ordered = ordered && out[i] == expected++;
+        }
+    });
+    std::vector<int> batch(33);
+    for (int i = 0; i < N; ) {
+        size_t done;
+        if (i % 2) {
+            for (int j = 0; j < 33; ++j) batch[j] = i + j;
+            done = q.try_push_batch(batch.begin(), std::min(33, N - i));
+        } else {
+            done = q.try_push(i);
+        }
+        i += done;
+        if (!done) std::this_thread::yield();
+    }
+    consumer.join();
+    return std::make_pair(ordered && q.empty(), 0);
+}
+
+template<class Queue>
+std::pair<bool, double> moveOnlyChecker() {
+    // the elements left in the queue are destroyed with it, checked by the sanitizers
+    Queue q(16);
+    std::vector<std::unique_ptr<int>> batch;
+    for (int i = 0; i < 10; ++i) batch.push_back(std::unique_ptr<int>(new int(i)));
+    if (q.try_push_batch(std::make_move_iterator(batch.begin()), 10) != 10 || batch[0]) return std::make_pair(false, 0);
+    if (!q.try_push(std::unique_ptr<int>(new int(10)))) return std::make_pair(false, 0);
+    std::unique_ptr<int> value;
+    std::vector<std::unique_ptr<int>> out(4);
+    if (!q.try_pop(value) || *value != 0 || q.try_pop_batch(out.begin(), 4) != 4 || *out[3] != 4) return std::make_pair(false, 0);
+    return std::make_pair(q.size() == 6, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Ring Queue -> mpmc_queue single thread testing...", singleThreadChecker<sjtu::mpmc_queue<int>>),
+    std::make_pair("Ring Queue -> spsc_queue single thread testing...", singleThreadChecker<sjtu::spsc_queue<int>>),
+    std::make_pair("Ring Queue -> mpmc_queue 4x4 threads testing...", mpmcChecker),
+    std::make_pair("Ring Queue -> spsc_queue 2 threads testing...", spscChecker),
+    std::make_pair("Ring Queue -> mpmc_queue move-only elements testing...", moveOnlyChecker<sjtu::mpmc_queue<std::unique_ptr<int>>>),
+    std::make_pair("Ring Queue -> spsc_queue move-only elements testing...", moveOnlyChecker<sjtu::spsc_queue<std::unique_ptr<int>>>),
+};
+
+int main() {
+    puts("Deque Ring Queue CheckTool Offical Version");
+    puts("");
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+    return 0;
+}
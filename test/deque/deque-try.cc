@@ -0,0 +1,210 @@
+#include "deque.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <string>
+#include <utility>
+
+static const int N = 3000;
+static const int N_SPEED = 1000000;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+class Timer{
+private:
+    long dfnStart, dfnEnd;
+
+public:
+    void init() {
+        dfnEnd = dfnStart = clock();
+    }
+    void stop() {
+        dfnEnd = clock();
+    }
+    double getTime() {
+        return 1.0 * (dfnEnd - dfnStart) / CLOCKS_PER_SEC;
+    }
+
+};
+
+Timer timer;
+
+std::pair<bool, double> tryAtChecker() {
+    sjtu::deque<int> a;
+    const sjtu::deque<int> &ca = a;
+    if (a.try_at(0) || ca.try_at(0)) return std::make_pair(false, 0);
+    for (int i = 0; i < N; i++) {
+        a.push_back(i);
+    }
+    for (int i = 0; i < N; i++) {
+        int *p = a.try_at(i);
+        const int *cp = ca.try_at(i);
+        if (!p || !cp || *p != i || *cp != i || p != &a.at(i)) return std::make_pair(false, 0);
+    }
+    *a.try_at(7) = -7;
+    if (a[7] != -7) return std::make_pair(false, 0);
+    if (a.try_at(N) || ca.try_at(N + 100) || a.try_at(-1)) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> tryPopChecker() {
+    sjtu::deque<std::string> a;
+    std::deque<std::string> b;
+    std::string value = "untouched";
+    if (a.try_pop_front() || a.try_pop_back() || a.try_pop_front(value) || a.try_pop_back(value)) {
+        return std::make_pair(false, 0);
+    }
+    if (value != "untouched") return std::make_pair(false, 0);
+    for (int i = 0; i < N; i++) {
+        std::string s = std::to_string(rand());
+        if (rand() % 2) {
+            a.push_back(s), b.push_back(s);
+        } else {
+            a.push_front(s), b.push_front(s);
+        }
+    }
+    while (!b.empty()) {
+        int op = rand() % 4;
+        if (op == 0) {
+            if (!a.try_pop_front(value) || value != b.front()) return std::make_pair(false, 0);
+            b.pop_front();
+        } else if (op == 1) {
+            if (!a.try_pop_back(value) || value != b.back()) return std::make_pair(false, 0);
+            b.pop_back();
+        } else if (op == 2) {
+            if (!a.try_pop_front()) return std::make_pair(false, 0);
+            b.pop_front();
+        } else {
+            if (!a.try_pop_back()) return std::make_pair(false, 0);
+            b.pop_back();
+        }
+        if (a.size() != b.size() || (!b.empty() && (a.front() != b.front() || a.back() != b.back()))) {
+            return std::make_pair(false, 0);
+        }
+    }
+    return std::make_pair(a.empty() && !a.try_pop_front(value) && !a.try_pop_back(), 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Lookup Series -> try_at testing...", tryAtChecker),
+    std::make_pair("Lookup Series -> try_pop_front/back testing...", tryPopChecker),
+};
+
+std::pair<bool, double> atMissTimer() {
+    sjtu::deque<int> a;
+    for (int i = 0; i < 8; i++) a.push_back(i);
+    long sum = 0;
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        try { sum += a.at(i % 16); } catch (...) {}
+    }
+    timer.stop();
+    return std::make_pair(sum == 28L * N_SPEED / 16, timer.getTime());
+}
+
+std::pair<bool, double> tryAtMissTimer() {
+    sjtu::deque<int> a;
+    for (int i = 0; i < 8; i++) a.push_back(i);
+    long sum = 0;
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        if (int *p = a.try_at(i % 16)) sum += *p;
+    }
+    timer.stop();
+    return std::make_pair(sum == 28L * N_SPEED / 16, timer.getTime());
+}
+
+std::pair<bool, double> popEmptyTimer() {
+    sjtu::deque<int> a;
+    int popped = 0;
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        if (i % 2) a.push_back(i);
+        try { a.pop_front(); popped++; } catch (...) {}
+    }
+    timer.stop();
+    return std::make_pair(popped == N_SPEED / 2, timer.getTime());
+}
+
+std::pair<bool, double> tryPopEmptyTimer() {
+    sjtu::deque<int> a;
+    int popped = 0;
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        if (i % 2) a.push_back(i);
+        if (a.try_pop_front()) popped++;
+    }
+    timer.stop();
+    return std::make_pair(popped == N_SPEED / 2, timer.getTime());
+}
+
+#ifdef __BENCHMARK
+static CheckerPair TEST_B[] = {
+    std::make_pair("at() in try/catch, half misses", atMissTimer),
+    std::make_pair("try_at(), half misses", tryAtMissTimer),
+    std::make_pair("pop_front() in try/catch, half empty", popEmptyTimer),
+    std::make_pair("try_pop_front(), half empty", tryPopEmptyTimer),
+};
+#endif
+
+#define __CORRECT_TEST
+#ifdef __BENCHMARK
+#define __SPEED_TEST
+#else
+#define __OFFICAL
+#endif
+
+int main() {
+#ifndef __OFFICAL
+    puts("Deque Lookup CheckTool");
+#else
+    puts("Deque Lookup CheckTool Offical Version");
+#endif
+    puts("");
+#ifdef __CORRECT_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#ifdef __SPEED_TEST
+    puts("");
+#endif
+#endif
+
+#ifdef __SPEED_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone B: Miss-heavy lookup speed Testing...");
+        printf("Test Size: %d operations\n", N_SPEED);
+        int n = sizeof(TEST_B) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_B[i].first);
+            std::pair<bool, double> result = TEST_B[i].second();
+#ifndef __OFFICAL
+            printf("%.3f\n", result.second);
+#else
+            puts(result.first ? "PASSED" : "FAILED");
+#endif
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#endif
+    return 0;
+}
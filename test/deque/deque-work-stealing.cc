@@ -0,0 +1,197 @@
+#include "work_stealing_deque.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static const int N = 200000;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+std::pair<bool, double> singleThreadChecker() {
+    sjtu::work_stealing_deque<int> d(4);
+    int value = -1;
+    if (!d.empty() || d.pop(value) || d.steal(value) || value != -1) return std::make_pair(false, 0);
+    // grows from 4 slots, pop is LIFO and steal FIFO
+    for (int i = 0; i < 1000; ++i) d.push(i);
+    if (d.size() != 1000) return std::make_pair(false, 0);
+    for (int i = 0; i < 300; ++i) {
+        if (!d.steal(value) || value != i) return std::make_pair(false, 0);
+    }
+    for (int i = 999; i >= 300; --i) {
+        if (!d.pop(value) || value != i) return std::make_pair(false, 0);
+    }
+    if (d.pop(value) || d.steal(value) || !d.empty()) return std::make_pair(false, 0);
+    // many laps around the array without growing
+    for (int i = 0; i < N; ++i) {
+        d.push(i);
+        d.push(i);
+        if (!d.steal(value) || value != i || !d.pop(value) || value != i) return std::make_pair(false, 0);
+    }
+    return std::make_pair(d.empty(), 0);
+}
+
+std::pair<bool, double> stealChecker() {
+    // the owner pushes and pops while 3 thieves steal, every element is taken exactly once
+    sjtu::work_stealing_deque<int> d(8);
+    std::vector<std::atomic<int>> taken(N);
+    for (std::atomic<int> &t : taken) t = 0;
+    std::atomic<bool> done(false);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.push_back(std::thread([&] {
+            int value;
+            while (!done || !d.empty()) {
+                if (d.steal(value)) {
+                    ++taken[value];
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    int value;
+    for (int i = 0; i < N; ++i) {
+        d.push(i);
+        if (i % 3 == 0 && d.pop(value)) ++taken[value];
+    }
+    while (d.pop(value)) ++taken[value];
+    done = true;
+    for (std::thread &t : thieves) t.join();
+    int once = 0;
+    for (std::atomic<int> &t : taken) once += t == 1;
+    return std::make_pair(once == N, 0);
+}
+
+long fib(sjtu::thread_pool &pool, int n) {
+    if (n < 15) {
+        return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    }
+    long a, b;
+    sjtu::thread_pool::task_group group(pool);
+    group.run([&] { a = fib(pool, n - 1); });
+    b = fib(pool, n - 2);
+    group.wait();
+    return a + b;
+}
+
+std::pair<bool, double> forkJoinChecker() {
+    bool ok = true;
+    for (size_t threads : {1, 2, 4}) {
+        sjtu::thread_pool pool(threads);
+        ok = ok && pool.size() == threads && fib(pool, 27) == 196418;
+    }
+    return std::make_pair(ok, 0);
+}
+
+std::pair<bool, double> manyGroupsChecker() {
+    // several outside threads each waiting for their own groups in one pool
+    sjtu::thread_pool pool(3);
+    std::atomic<long> total(0);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < 4; ++c) {
+        clients.push_back(std::thread([&pool, &total, c] {
+            for (int round = 0; round < 20; ++round) {
+                std::atomic<long> sum(0);
+                sjtu::thread_pool::task_group group(pool);
+                for (int i = 0; i < 100; ++i) {
+                    group.run([&sum, i, c] {
+                        sum += i + c;
+                    });
+                }
+                group.wait();
+                total += sum;
+            }
+        }));
+    }
+    for (std::thread &t : clients) t.join();
+    return std::make_pair(total == 20L * (4 * 4950 + 100 * 6), 0);
+}
+
+std::pair<bool, double> exceptionChecker() {
+    sjtu::thread_pool pool(2);
+    sjtu::thread_pool::task_group group(pool);
+    std::atomic<int> ran(0);
+    for (int i = 0; i < 50; ++i) {
+        group.run([&ran, i] {
+            ++ran;
+            if (i % 10 == 3) throw std::runtime_error("task failed");
+        });
+    }
+    bool caught = false;
+    try {
+        group.wait();
+    } catch (std::runtime_error &) {
+        caught = true;
+    }
+    // the group can be used again afterwards
+    group.run([&ran] { ++ran; });
+    group.wait();
+    return std::make_pair(caught && ran == 51, 0);
+}
+
+// a task that cannot be copied into the pool, as when running out of memory
+struct UncopyableTask {
+    std::atomic<int> &ran;
+    explicit UncopyableTask(std::atomic<int> &_ran) : ran(_ran) {}
+    UncopyableTask(const UncopyableTask &other) : ran(other.ran) {
+        throw std::bad_alloc();
+    }
+    void operator()() const {
+        ++ran;
+    }
+};
+
+std::pair<bool, double> failedRunChecker() {
+    sjtu::thread_pool pool(2);
+    sjtu::thread_pool::task_group group(pool);
+    std::atomic<int> ran(0);
+    bool caught = false;
+    try {
+        group.run(UncopyableTask(ran));
+    } catch (std::bad_alloc &) {
+        caught = true;
+    }
+    // the task that was not run is not waited for
+    group.wait();
+    group.run([&ran] { ++ran; });
+    group.wait();
+    return std::make_pair(caught && ran == 1, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Work Stealing -> push/pop/steal single thread testing...", singleThreadChecker),
+    std::make_pair("Work Stealing -> owner and 3 thieves testing...", stealChecker),
+    std::make_pair("Work Stealing -> thread_pool fork-join testing...", forkJoinChecker),
+    std::make_pair("Work Stealing -> thread_pool 4 client threads testing...", manyGroupsChecker),
+    std::make_pair("Work Stealing -> thread_pool exceptions testing...", exceptionChecker),
+    std::make_pair("Work Stealing -> thread_pool failed run testing...", failedRunChecker),
+};
+
+int main() {
+    puts("Deque Work Stealing CheckTool Offical Version");
+    puts("");
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+    return 0;
+}
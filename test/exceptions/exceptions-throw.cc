@@ -0,0 +1,207 @@
+#include "exceptions.hpp"
+#include "map.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+static const int N = 1000;
+static const int N_SPEED = 1000000;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+class Timer{
+private:
+    long dfnStart, dfnEnd;
+
+public:
+    void init() {
+        dfnEnd = dfnStart = clock();
+    }
+    void stop() {
+        dfnEnd = clock();
+    }
+    double getTime() {
+        return 1.0 * (dfnEnd - dfnStart) / CLOCKS_PER_SEC;
+    }
+
+};
+
+Timer timer;
+
+// every operator new of the program is counted
+static long allocations = 0;
+
+void *operator new(std::size_t size) {
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    free(p);
+}
+
+static_assert(std::is_base_of<std::exception, sjtu::index_out_of_bound>::value, "sjtu exceptions derive from std::exception");
+static_assert(noexcept(sjtu::invalid_iterator().what()), "what() is noexcept");
+
+std::pair<bool, double> messageChecker() {
+    if (strcmp(sjtu::index_out_of_bound().what(), "error : index out of bound.") != 0) return std::make_pair(false, 0);
+    if (strcmp(sjtu::runtime_error().what(), "error : runtime error.") != 0) return std::make_pair(false, 0);
+    if (strcmp(sjtu::invalid_iterator().what(), "error : invalid iterator.") != 0) return std::make_pair(false, 0);
+    if (strcmp(sjtu::container_is_empty("pop").what(), "error : container is empty.") != 0) return std::make_pair(false, 0);
+    if (strcmp(sjtu::container_is_empty("pop").where(), "pop") != 0) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> hierarchyChecker() {
+    int caught = 0;
+    try { throw sjtu::index_out_of_bound(); } catch (std::exception &e) { caught++; }
+    try { throw sjtu::invalid_iterator(); } catch (sjtu::exception &e) { caught++; }
+    // copied into a base, as the map tests catch by value, the message survives the slicing
+    try { throw sjtu::container_is_empty(); } catch (const sjtu::exception &e) {
+        sjtu::exception error = e;
+        if (strcmp(error.what(), "error : container is empty.") == 0) caught++;
+    }
+    return std::make_pair(caught == 3, 0);
+}
+
+std::pair<bool, double> allocationChecker() {
+    long before = allocations;
+    for (int i = 0; i < N; i++) {
+        try { throw sjtu::index_out_of_bound("at"); } catch (sjtu::exception &e) {}
+        sjtu::runtime_error e("copy");
+        sjtu::exception copy = e;
+        if (copy.what()[0] != 'e') return std::make_pair(false, 0);
+    }
+    // the exception object itself is allocated by the runtime, not through operator new
+    return std::make_pair(allocations == before, 0);
+}
+
+std::pair<bool, double> mapAtChecker() {
+    sjtu::map<int, int> map;
+    for (int i = 0; i < N; i += 2) map[i] = i;
+    int misses = 0;
+    for (int i = 0; i < N; i++) {
+        try { map.at(i); } catch (sjtu::index_out_of_bound &e) { misses++; }
+    }
+    return std::make_pair(misses == N / 2, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Exception Series -> what() testing...", messageChecker),
+    std::make_pair("Exception Series -> hierarchy testing...", hierarchyChecker),
+    std::make_pair("Exception Series -> no allocation testing...", allocationChecker),
+    std::make_pair("Exception Series -> map::at miss testing...", mapAtChecker),
+};
+
+std::pair<bool, double> sjtuThrowTimer() {
+    int caught = 0;
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        try { throw sjtu::index_out_of_bound(); } catch (sjtu::exception &e) { caught++; }
+    }
+    timer.stop();
+    return std::make_pair(caught == N_SPEED, timer.getTime());
+}
+
+std::pair<bool, double> stdThrowTimer() {
+    int caught = 0;
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        try { throw std::out_of_range(std::string("error : index out of bound.")); } catch (std::exception &e) { caught++; }
+    }
+    timer.stop();
+    return std::make_pair(caught == N_SPEED, timer.getTime());
+}
+
+std::pair<bool, double> mapAtTimer() {
+    sjtu::map<int, int> map;
+    for (int i = 0; i < 1000; i += 2) map[i] = i;
+    int misses = 0;
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        try { map.at(i % 1000); } catch (sjtu::exception &e) { misses++; }
+    }
+    timer.stop();
+    return std::make_pair(misses == N_SPEED / 2, timer.getTime());
+}
+
+#ifdef __BENCHMARK
+static CheckerPair TEST_B[] = {
+    std::make_pair("throw/catch sjtu::index_out_of_bound", sjtuThrowTimer),
+    std::make_pair("throw/catch std::out_of_range with a message", stdThrowTimer),
+    std::make_pair("map::at, half of the keys missing", mapAtTimer),
+};
+#endif
+
+#define __CORRECT_TEST
+#ifdef __BENCHMARK
+#define __SPEED_TEST
+#else
+#define __OFFICAL
+#endif
+
+int main() {
+#ifndef __OFFICAL
+    puts("Exceptions CheckTool");
+#else
+    puts("Exceptions CheckTool Offical Version");
+#endif
+    puts("");
+#ifdef __CORRECT_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#ifdef __SPEED_TEST
+    puts("");
+#endif
+#endif
+
+#ifdef __SPEED_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone B: Throw/catch speed Testing...");
+        printf("Test Size: %d throws\n", N_SPEED);
+        int n = sizeof(TEST_B) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_B[i].first);
+            std::pair<bool, double> result = TEST_B[i].second();
+#ifndef __OFFICAL
+            printf("%.3f\n", result.second);
+#else
+            puts(result.first ? "PASSED" : "FAILED");
+#endif
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#endif
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "map.hpp"
+#include "alloc-counter.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+
+//	built with SJTU_COUNT_ALLOCATIONS and linked with the global operator new and delete hooks
+typedef sjtu::map<int, long> Map;
+
+//	the allocations of the maps since start
+size_t allocated(const sjtu::alloc_stats &start) {
+	return Map::allocation_stats().allocations - start.allocations;
+}
+size_t freed(const sjtu::alloc_stats &start) {
+	return Map::allocation_stats().deallocations - start.deallocations;
+}
+
+void tester(void) {
+	sjtu::alloc_stats start = Map::allocation_stats();
+	Bench::AllocScope scope;
+	//	test: a node per new key, nothing for a key already there, and no other heap block
+	Map map;
+	for (int i = 0; i < 1000; ++i) {
+		map[i] = i;
+	}
+	for (int i = 0; i < 1000; ++i) {
+		map.insert(sjtu::pair<const int, long>(i, -1));
+	}
+	std::cout << allocated(start) << " " << scope.Allocations() << std::endl;
+	//	test: the bytes are those of the nodes, the peak is all of them
+	sjtu::alloc_stats now = Map::allocation_stats();
+	size_t node_bytes = (now.bytes - start.bytes) / 1000;
+	assert(node_bytes >= sizeof(sjtu::pair<const int, long>) && node_bytes * 1000 == now.bytes - start.bytes);
+	std::cout << (now.live - start.live == node_bytes * 1000) << " " << (now.peak >= now.live) << std::endl;
+	//	test: copies allocate a node per element, erase and clear free them
+	Map copy(map);
+	for (int i = 0; i < 1000; i += 2) {
+		copy.erase(copy.find(i));
+	}
+	std::cout << allocated(start) << " " << freed(start) << " " << copy.size() << std::endl;
+	copy.clear();
+	map.clear();
+	now = Map::allocation_stats();
+	std::cout << allocated(start) << " " << freed(start) << " " << (now.live == start.live) << " " << scope.Leaked() << std::endl;
+	//	test: the peak restarts from the live bytes
+	Map::reset_allocation_peak();
+	assert(Map::allocation_stats().peak == start.live);
+	map[0] = 0;
+	std::cout << (Map::allocation_stats().peak - start.live == node_bytes) << std::endl;
+	//	test: other instantiations count on their own
+	sjtu::map<int, std::string> strings;
+	strings[1] = "one";
+	std::cout << sjtu::map<int, std::string>::allocation_stats().allocations << " " << allocated(start) << std::endl;
+}
+
+int main(void) {
+	tester();
+}
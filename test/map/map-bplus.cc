@@ -0,0 +1,150 @@
+#include "bplus_map.hpp"
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <random>
+#include <string>
+
+class Integer {
+public:
+	static int counter;
+	int val;
+
+	Integer(int val) : val(val) {
+		counter++;
+	}
+
+	Integer(const Integer &rhs) {
+		val = rhs.val;
+		counter++;
+	}
+
+	Integer& operator = (const Integer &rhs) = delete;
+
+	~Integer() {
+		counter--;
+	}
+};
+
+int Integer::counter = 0;
+
+class Compare {
+public:
+	bool operator () (const Integer &lhs, const Integer &rhs) const {
+		return lhs.val < rhs.val;
+	}
+};
+
+template<class Map>
+bool same(const Map &a, const std::map<int, int> &b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	typename Map::const_iterator it = a.cbegin();
+	for (std::map<int, int>::const_iterator jt = b.begin(); jt != b.end(); ++jt, ++it) {
+		if (it->first != jt->first || it->second != jt->second) {
+			return false;
+		}
+	}
+	return it == a.cend();
+}
+
+void tester(void) {
+	//	test: random operations against std::map, enough to split and merge nodes at every level
+	sjtu::bplus_map<int, int> map;
+	std::map<int, int> ref;
+	std::mt19937 rng(2017);
+	for (int i = 0; i < 300000; ++i) {
+		int key = rng() % 20000, op = rng() % 3;
+		if (op == 0) {
+			bool inserted = map.insert(sjtu::pair<int, int>(key, i)).second;
+			bool ref_inserted = ref.insert(std::make_pair(key, i)).second;
+			assert(inserted == ref_inserted);
+			(void)inserted, (void)ref_inserted;
+		} else if (op == 1) {
+			map[key] += i;
+			ref[key] += i;
+		} else {
+			assert(map.count(key) == ref.count(key));
+			if (ref.count(key)) {
+				assert(map.at(key) == ref[key] && *map.find_ptr(key) == ref[key]);
+				map.erase(map.find(key));
+				ref.erase(key);
+			}
+		}
+	}
+	std::cout << map.size() << " " << same(map, ref) << std::endl;
+	//	test: lower_bound(), upper_bound() and a range scan
+	long sum = 0;
+	for (auto it = map.lower_bound(5000); it != map.upper_bound(6000); ++it) {
+		sum += it->second;
+	}
+	long ref_sum = 0;
+	for (auto it = ref.lower_bound(5000); it != ref.upper_bound(6000); ++it) {
+		ref_sum += it->second;
+	}
+	long bounds = 0;
+	for (int key = -1; key <= 20001; key += 7) {
+		auto lb = map.lower_bound(key), ub = map.upper_bound(key);
+		auto rlb = ref.lower_bound(key), rub = ref.upper_bound(key);
+		bounds += (lb == map.end() ? rlb == ref.end() : lb->first == rlb->first);
+		bounds += (ub == map.end() ? rub == ref.end() : ub->first == rub->first);
+	}
+	std::cout << sum << " " << ref_sum << " " << bounds << std::endl;
+	//	test: iterating backwards, --end()
+	auto it = map.end();
+	auto rit = ref.end();
+	size_t backwards = 0;
+	while (rit != ref.begin()) {
+		--it;
+		--rit;
+		backwards += it->first == rit->first;
+	}
+	assert(it == map.begin());
+	std::cout << backwards << std::endl;
+	try {
+		--it;
+		assert(false);
+	} catch (sjtu::invalid_iterator &) {}
+	//	test: copy constructor, operator=, erase everything
+	sjtu::bplus_map<int, int> copy(map), assigned;
+	assigned = copy;
+	assigned = assigned;
+	while (!map.empty()) {
+		map.erase(map.begin());
+	}
+	assert(map.begin() == map.end() && map.size() == 0);
+	std::cout << same(copy, ref) << same(assigned, ref) << std::endl;
+	try {
+		map.erase(map.end());
+		assert(false);
+	} catch (sjtu::index_out_of_bound &) {}
+	try {
+		map.erase(copy.begin());
+		assert(false);
+	} catch (sjtu::index_out_of_bound &) {}
+	std::cout << copy.size() << " " << assigned.size() << std::endl;
+	//	test: keys without default constructor and assignment, no element leaked
+	{
+		sjtu::bplus_map<Integer, std::string, Compare> strings;
+		for (int i = 0; i < 50000; ++i) {
+			strings[Integer(i * 7919 % 50000)] = std::to_string(i);
+		}
+		for (int i = 0; i < 50000; i += 2) {
+			strings.erase(strings.find(Integer(i)));
+		}
+		sjtu::bplus_map<Integer, std::string, Compare> other(strings);
+		int last = -1, ordered = 0;
+		for (auto it = other.cbegin(); it != other.cend(); ++it) {
+			ordered += it->first.val > last && it->first.val % 2 == 1;
+			last = it->first.val;
+		}
+		std::cout << ordered << std::endl;
+		std::cout << strings.size() << " " << other.at(Integer(4999)) << std::endl;
+	}
+	std::cout << Integer::counter << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,155 @@
+#include "concurrent_map.hpp"
+#include <iostream>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int THREADS = 8;
+const int N = 40000;
+
+template<class F>
+void parallel(F f) {
+	std::vector<std::thread> threads;
+	for (int t = 0; t < THREADS; ++t) {
+		threads.push_back(std::thread(f, t));
+	}
+	for (std::thread &t : threads) {
+		t.join();
+	}
+}
+
+void tester(void) {
+	//	test: concurrent inserts of interleaved keys, each key inserted by two threads
+	sjtu::concurrent_map<int, int> map;
+	std::atomic<int> inserted(0);
+	parallel([&](int t) {
+		for (int i = t % (THREADS / 2); i < N; i += THREADS / 2) {
+			inserted += map.insert(i, i * 3);
+		}
+	});
+	int last = -1, ordered = 0;
+	long sum = 0;
+	map.for_each([&](int key, int value) {
+		ordered += key == last + 1 && value == key * 3;
+		last = key;
+		sum += value;
+	});
+	std::cout << inserted << " " << map.size() << " " << ordered << " " << sum << std::endl;
+	//	test: erase the even keys while other threads look up the odd ones, which must stay present
+	std::atomic<int> erased(0), found(0), lost(0);
+	parallel([&](int t) {
+		if (t % 2) {
+			for (int i = t / 2 * 2; i < N; i += THREADS) {
+				erased += map.erase(i);
+				erased += map.erase(i);
+			}
+		} else {
+			for (int round = 0; round < 4; ++round) {
+				for (int i = 1; i < N; i += 2) {
+					int value = -1;
+					if (map.find(i, value) && value == i * 3) {
+						++found;
+					} else {
+						++lost;
+					}
+				}
+			}
+		}
+	});
+	size_t even = 0;
+	for (int i = 0; i < N; i += 2) {
+		even += map.count(i);
+	}
+	std::cout << erased << " " << found << " " << lost << " " << even << " " << map.size() << std::endl;
+	//	test: range() while keys are inserted and erased around it sees every stable key in order
+	std::atomic<bool> done(false);
+	std::atomic<int> bad_scans(0);
+	std::thread writer([&] {
+		for (int round = 0; round < 20; ++round) {
+			for (int i = 0; i < N; i += 2) {
+				map.insert(i, i * 3);
+			}
+			for (int i = 0; i < N; i += 2) {
+				map.erase(i);
+			}
+		}
+		done = true;
+	});
+	int scans = 0;
+	while (!done || scans < 10) {
+		int prev = 999, odd = 0;
+		bool sorted = true;
+		map.range(1000, 3000, [&](int key, int) {
+			sorted = sorted && key > prev && key < 3000;
+			prev = key;
+			odd += key % 2;
+		});
+		bad_scans += !sorted || odd != 1000;
+		++scans;
+	}
+	writer.join();
+	std::cout << bad_scans << " " << map.size() << std::endl;
+	//	test: erase and look up from inside for_each while another thread churns the map
+	std::atomic<bool> scanned(false);
+	std::thread churner([&] {
+		while (!scanned) {
+			for (int i = 0; i < N; i += 2) {
+				map.insert(i, i * 3);
+			}
+			for (int i = 0; i < N; i += 2) {
+				map.erase(i);
+			}
+		}
+	});
+	int visited = 0, removed = 0, missing = 0;
+	for (int round = 0; round < 20; ++round) {
+		map.for_each([&](int key, int value) {
+			if (key % 2 == 0) {
+				return;
+			}
+			++visited;
+			int next = -1;
+			missing += value != key * 3 || (key + 2 < N && key % 4 == 1 && !map.find(key + 2, next));
+			if (round == 0 && key % 4 == 1) {
+				removed += map.erase(key);
+			}
+			//	enough erases for the reclamation to run, it must not free the node the scan is on
+			if (round == 0 && key % 400 == 1) {
+				for (int i = N; i < N + 200; ++i) {
+					map.insert(i, i);
+					map.erase(i);
+				}
+			}
+		});
+	}
+	scanned = true;
+	churner.join();
+	std::cout << visited << " " << removed << " " << missing << " " << map.size() << std::endl;
+	//	test: string values, keys erased and inserted again by many threads, nothing leaked or lost
+	sjtu::concurrent_map<std::string, std::string> strings;
+	parallel([&](int t) {
+		for (int round = 0; round < 50; ++round) {
+			for (int i = 0; i < 200; ++i) {
+				std::string key = std::to_string(i);
+				if ((i + round + t) % 3) {
+					strings.insert(key, key + "!");
+				} else {
+					strings.erase(key);
+				}
+			}
+		}
+	});
+	size_t good = 0, total = 0;
+	strings.for_each([&](const std::string &key, const std::string &value) {
+		good += value == key + "!";
+		++total;
+	});
+	std::cout << (good == total) << " " << (strings.size() == total) << " " << strings.empty() << std::endl;
+	std::string value;
+	std::cout << strings.find("not there", value) << " " << strings.count("not there") << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+//	the test walks the nodes to check the heights, the standard headers are included before this
+#define private public
+#include "map.hpp"
+#undef private
+
+typedef sjtu::map<int, int> Map;
+
+//	the height of t, or -1 if a parent link, a stored height or the balance of a node is wrong
+int checked_height(Map::node* t, Map::node* parent) {
+	if (!t) {
+		return 0;
+	}
+	int l = checked_height(t->left, t), r = checked_height(t->right, t);
+	if (l < 0 || r < 0 || t->parent != parent || l > r + 1 || r > l + 1 || t->height != 1 + (l > r ? l : r)) {
+		return -1;
+	}
+	return t->height;
+}
+
+bool balanced(Map &map) {
+	return checked_height(map.root, nullptr) >= 0;
+}
+
+//	insert keys in order and erase some, then check the tree and the rest of the keys in order
+bool erase_some(std::initializer_list<int> keys, std::initializer_list<int> erased) {
+	Map map;
+	for (int k : keys) {
+		map[k] = k;
+	}
+	for (int k : erased) {
+		map.erase(map.find(k));
+	}
+	bool ok = balanced(map) && map.size() == keys.size() - erased.size();
+	int prev = -1;
+	for (Map::iterator it = map.begin(); it != map.end(); ++it) {
+		ok = ok && it->first > prev && !std::count(erased.begin(), erased.end(), it->first);
+		prev = it->first;
+	}
+	return ok;
+}
+
+void tester(void) {
+	//	test: erasing from the shorter side leaves a taller child whose subtrees are as high,
+	//	its inner one with subtrees of different heights, a single rotation on either side is needed
+	std::cout << erase_some({5, 2, 7, 1, 3, 6, 0, 4}, {6}) << " " << erase_some({5, 8, 3, 9, 7, 4, 10, 6}, {4}) << std::endl;
+	//	test: the same below the root of a bigger tree
+	std::cout << erase_some({20, 5, 30, 2, 7, 25, 35, 1, 3, 6, 40, 0, 4}, {6}) << " "
+		<< erase_some({25, 40, 15, 43, 38, 20, 10, 44, 42, 39, 5, 45, 41}, {39}) << std::endl;
+	//	test: random inserts and erases, the tree is checked after each erase
+	std::mt19937 rng(3);
+	int unbalanced = 0;
+	for (int round = 0; round < 100; ++round) {
+		Map map;
+		for (int i = 0; i < 1000; ++i) {
+			map[rng() % 2000] = i;
+		}
+		for (int i = 0; i < 1000; ++i) {
+			int key = rng() % 2000;
+			if (map.count(key)) {
+				map.erase(map.find(key));
+				unbalanced += !balanced(map);
+			} else {
+				map[key] = i;
+			}
+		}
+	}
+	std::cout << "unbalanced after erase: " << unbalanced << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,48 @@
+#include "map.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+
+void tester(void) {
+	sjtu::map<int, std::string> map;
+	const sjtu::map<int, std::string> &cmap = map;
+	//	test: find_ptr() on an empty map
+	assert(!map.find_ptr(0) && !cmap.find_ptr(0));
+	for (int i = 0; i < 10000; i += 2) {
+		map[i] = std::to_string(i);
+	}
+	//	test: find_ptr() hits point at the mapped value, misses are nullptr
+	int hits = 0, misses = 0;
+	for (int i = -100; i < 10100; ++i) {
+		std::string *p = map.find_ptr(i);
+		const std::string *cp = cmap.find_ptr(i);
+		assert(p == cp);
+		if (p) {
+			assert(*p == std::to_string(i) && p == &map.at(i));
+			++hits;
+		} else {
+			assert(map.count(i) == 0);
+			++misses;
+		}
+	}
+	std::cout << hits << " " << misses << std::endl;
+	//	test: writing through the pointer
+	*map.find_ptr(42) = "forty-two";
+	std::cout << map.at(42) << std::endl;
+	//	test: the pointer stays valid while other keys are inserted and erased
+	std::string *p = map.find_ptr(5000);
+	for (int i = 1; i < 10000; i += 2) {
+		map[i] = "odd";
+	}
+	for (int i = 0; i < 10000; i += 3) {
+		if (i != 5000) {
+			map.erase(map.find(i));
+		}
+	}
+	assert(p == map.find_ptr(5000) && *p == "5000");
+	std::cout << map.size() << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,111 @@
+#include "flat_map.hpp"
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+template<class Map>
+bool same(const Map &a, const std::map<int, int> &b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	typename Map::const_iterator it = a.cbegin();
+	for (std::map<int, int>::const_iterator jt = b.begin(); jt != b.end(); ++jt, ++it) {
+		if (it->first != jt->first || it->second != jt->second) {
+			return false;
+		}
+	}
+	return it == a.cend();
+}
+
+void tester(void) {
+	//	test: lookups on an empty map
+	sjtu::flat_map<int, int> map;
+	std::cout << map.empty() << map.count(0) << (map.find(0) == map.end()) << (map.lower_bound(0) == map.end()) << std::endl;
+	//	test: building from a batch with duplicated keys, the first one wins
+	std::mt19937 rng(2017);
+	std::vector<std::pair<int, int>> batch;
+	std::map<int, int> ref;
+	for (int i = 0; i < 100000; ++i) {
+		int key = rng() % 150000;
+		batch.push_back(std::make_pair(key, i));
+		ref.insert(std::make_pair(key, i));
+	}
+	map.insert(batch.begin(), batch.end());
+	std::cout << map.size() << " " << same(map, ref) << std::endl;
+	//	test: find(), count(), at(), find_ptr(), lower_bound() and upper_bound() for every key around
+	long hits = 0, bounds = 0;
+	for (int key = -1; key <= 150001; ++key) {
+		std::map<int, int>::iterator expect = ref.find(key);
+		const int *p = map.find_ptr(key);
+		if (expect == ref.end()) {
+			bounds += !p && map.count(key) == 0 && map.find(key) == map.end();
+		} else {
+			hits += p && *p == expect->second && map.at(key) == expect->second && map.find(key)->second == expect->second;
+		}
+		std::map<int, int>::iterator rlb = ref.lower_bound(key), rub = ref.upper_bound(key);
+		sjtu::flat_map<int, int>::iterator lb = map.lower_bound(key), ub = map.upper_bound(key);
+		bounds += (lb == map.end() ? rlb == ref.end() : lb->first == rlb->first);
+		bounds += (ub == map.end() ? rub == ref.end() : ub->first == rub->first);
+	}
+	std::cout << hits << " " << bounds << std::endl;
+	//	test: merging a second batch into the map, present keys are not overwritten
+	batch.clear();
+	for (int i = 0; i < 50000; ++i) {
+		int key = rng() % 300000;
+		batch.push_back(std::make_pair(key, -i));
+		ref.insert(std::make_pair(key, -i));
+	}
+	map.insert(batch.begin(), batch.end());
+	std::cout << map.size() << " " << same(map, ref) << std::endl;
+	//	test: insert(), operator[], erase() one at a time, writing through the iterator
+	for (int i = 0; i < 2000; ++i) {
+		int key = rng() % 300000;
+		if (i % 3 == 0) {
+			bool inserted = map.insert(sjtu::pair<int, int>(key, i)).second;
+			std::cout << (inserted == ref.insert(std::make_pair(key, i)).second);
+		} else if (i % 3 == 1) {
+			map[key] += i;
+			ref[key] += i;
+		} else if (ref.count(key)) {
+			map.erase(map.find(key));
+			ref.erase(key);
+		}
+	}
+	std::cout << std::endl;
+	for (sjtu::flat_map<int, int>::iterator it = map.begin(); it != map.end(); ++it) {
+		it->second += 1;
+		(*it).second -= 1;
+	}
+	std::cout << map.size() << " " << same(map, ref) << std::endl;
+	//	test: copies, iterating backwards, exceptions
+	const sjtu::flat_map<int, int> copy(map);
+	sjtu::flat_map<int, int>::const_iterator it = copy.cend();
+	std::map<int, int>::reverse_iterator rit = ref.rbegin();
+	size_t backwards = 0;
+	while (it != copy.cbegin()) {
+		--it;
+		backwards += it->first == rit->first;
+		++rit;
+	}
+	std::cout << backwards << std::endl;
+	int thrown = 0;
+	try { --it; } catch (sjtu::invalid_iterator &) { ++thrown; }
+	try { copy.at(-1); } catch (sjtu::index_out_of_bound &) { ++thrown; }
+	try { copy[-1]; } catch (sjtu::index_out_of_bound &) { ++thrown; }
+	try { map.erase(map.end()); } catch (sjtu::index_out_of_bound &) { ++thrown; }
+	map.clear();
+	std::cout << thrown << " " << map.size() << " " << copy.size() << std::endl;
+	//	test: string keys
+	sjtu::flat_map<std::string, int> strings;
+	for (int i = 0; i < 1000; ++i) {
+		strings[std::to_string(i)] = i;
+	}
+	std::cout << strings.begin()->first << " " << strings.at("999") << " " << strings.lower_bound("5")->second << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,359 @@
+#include "unordered_map.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+static const int N = 100000;
+static const int N_SPEED = 1000000;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+class Timer{
+private:
+    long dfnStart, dfnEnd;
+
+public:
+    void init() {
+        dfnEnd = dfnStart = clock();
+    }
+    void stop() {
+        dfnEnd = clock();
+    }
+    double getTime() {
+        return 1.0 * (dfnEnd - dfnStart) / CLOCKS_PER_SEC;
+    }
+
+};
+
+Timer timer;
+
+template<class Map, class StdMap>
+bool equals(const Map &a, const StdMap &b) {
+    if (a.size() != b.size()) return false;
+    size_t n = 0;
+    for (typename Map::const_iterator it = a.cbegin(); it != a.cend(); ++it, ++n) {
+        typename StdMap::const_iterator found = b.find(it->first);
+        if (found == b.end() || found->second != it->second) return false;
+    }
+    return n == b.size();
+}
+
+std::pair<bool, double> randomChecker() {
+    sjtu::unordered_map<int, int> a;
+    std::unordered_map<int, int> b;
+    std::mt19937 rng(2017);
+    for (int i = 0; i < N; i++) {
+        int key = rng() % 5000, op = rng() % 4;
+        if (op == 0) {
+            bool inserted = a.insert(sjtu::pair<const int, int>(key, i)).second;
+            if (inserted != b.insert(std::make_pair(key, i)).second) return std::make_pair(false, 0);
+        } else if (op == 1) {
+            a[key] += i;
+            b[key] += i;
+        } else if (op == 2) {
+            if (a.count(key) != b.count(key)) return std::make_pair(false, 0);
+            if (b.count(key)) {
+                a.erase(a.find(key));
+                b.erase(key);
+            }
+        } else {
+            const int *p = a.find_ptr(key);
+            if ((p != nullptr) != (b.count(key) == 1)) return std::make_pair(false, 0);
+            if (p && (*p != b[key] || &a.at(key) != p)) return std::make_pair(false, 0);
+        }
+    }
+    return std::make_pair(equals(a, b), 0);
+}
+
+std::pair<bool, double> churnChecker() {
+    // a sliding window of keys leaves DELETED slots everywhere, the table must not fill up with them
+    sjtu::unordered_map<int, int> a;
+    for (int i = 0; i < N; i++) {
+        a[i] = i;
+        if (i >= 1000) {
+            if (a.find(i - 1000) == a.end()) return std::make_pair(false, 0);
+            a.erase(a.find(i - 1000));
+        }
+        if (a.size() != static_cast<size_t>(i < 1000 ? i + 1 : 1000)) return std::make_pair(false, 0);
+    }
+    for (int i = 0; i < N; i++) {
+        if (a.count(i) != (i >= N - 1000 ? 1u : 0u)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(a.bucket_count() <= 4096, 0);
+}
+
+std::pair<bool, double> iteratorChecker() {
+    sjtu::unordered_map<int, long> a;
+    const sjtu::unordered_map<int, long> &ca = a;
+    if (a.begin() != a.end() || ca.cbegin() != ca.cend()) return std::make_pair(false, 0);
+    long sum = 0;
+    for (int i = 0; i < N; i += 3) {
+        a[i] = i;
+        sum += i;
+    }
+    long iterated = 0;
+    size_t n = 0;
+    for (sjtu::unordered_map<int, long>::iterator it = a.begin(); it != a.end(); it++) {
+        iterated += it->second;
+        (*it).second = -it->first;
+        ++n;
+    }
+    if (iterated != sum || n != a.size()) return std::make_pair(false, 0);
+    for (sjtu::unordered_map<int, long>::const_iterator it = ca.cbegin(); it != ca.cend(); ++it) {
+        if (it->second != -it->first) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> copyChecker() {
+    sjtu::unordered_map<std::string, std::string> a;
+    for (int i = 0; i < 3000; i++) {
+        a[std::to_string(i)] = std::string(i % 50, 'x');
+    }
+    for (int i = 0; i < 3000; i += 2) {
+        a.erase(a.find(std::to_string(i)));
+    }
+    sjtu::unordered_map<std::string, std::string> b(a), c;
+    c = a;
+    c = c;
+    a.clear();
+    if (!a.empty() || a.find("1") != a.end()) return std::make_pair(false, 0);
+    for (int i = 0; i < 3000; i++) {
+        const std::string *p = b.find_ptr(std::to_string(i)), *q = c.find_ptr(std::to_string(i));
+        if ((i % 2 == 1) != (p != nullptr) || (i % 2 == 1) != (q != nullptr)) return std::make_pair(false, 0);
+        if (p && (*p != std::string(i % 50, 'x') || *q != *p)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(b.size() == 1500 && c.size() == 1500, 0);
+}
+
+std::pair<bool, double> exceptionChecker() {
+    sjtu::unordered_map<int, int> a;
+    const sjtu::unordered_map<int, int> &ca = a;
+    int thrown = 0;
+    try { a.at(1); } catch (sjtu::index_out_of_bound &) { thrown++; }
+    try { ca[1]; } catch (sjtu::index_out_of_bound &) { thrown++; }
+    try { a.erase(a.end()); } catch (sjtu::index_out_of_bound &) { thrown++; }
+    a[1] = 1;
+    sjtu::unordered_map<int, int> b(a);
+    try { a.erase(b.begin()); } catch (sjtu::index_out_of_bound &) { thrown++; }
+    sjtu::unordered_map<int, int>::iterator it = a.end();
+    try { ++it; } catch (sjtu::invalid_iterator &) { thrown++; }
+    return std::make_pair(thrown == 5 && a.size() == 1, 0);
+}
+
+struct BadHash {
+    size_t operator()(int) const {
+        return 42;
+    }
+};
+
+std::pair<bool, double> collisionChecker() {
+    // every key in the same probe sequence
+    sjtu::unordered_map<int, int, BadHash> a;
+    for (int i = 0; i < 2000; i++) {
+        a[i] = i * 2;
+    }
+    for (int i = 0; i < 2000; i += 3) {
+        a.erase(a.find(i));
+    }
+    for (int i = 0; i < 2000; i++) {
+        const int *p = a.find_ptr(i);
+        if ((i % 3 != 0) != (p != nullptr) || (p && *p != i * 2)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(a.size() == 1333, 0);
+}
+
+class Integer {
+public:
+    static int counter;
+    // the copy after that many throws, if not negative
+    static int copies_left;
+    int val;
+    Integer(int val) : val(val) { counter++; }
+    Integer(const Integer &rhs) : val(rhs.val) {
+        if (copies_left >= 0 && copies_left-- == 0) throw std::runtime_error("copy failed");
+        counter++;
+    }
+    ~Integer() { counter--; }
+};
+
+int Integer::counter = 0;
+int Integer::copies_left = -1;
+
+std::pair<bool, double> lifetimeChecker() {
+    {
+        sjtu::unordered_map<int, Integer> a;
+        for (int i = 0; i < 5000; i++) {
+            a.insert(sjtu::pair<const int, Integer>(i, Integer(i)));
+        }
+        for (int i = 0; i < 5000; i += 2) {
+            a.erase(a.find(i));
+        }
+        sjtu::unordered_map<int, Integer> b(a);
+        if (Integer::counter != 5000) return std::make_pair(false, 0);
+        b.clear();
+        if (Integer::counter != 2500) return std::make_pair(false, 0);
+        // a copy failing halfway destroys the elements copied so far
+        int thrown = 0;
+        Integer::copies_left = 1000;
+        try { sjtu::unordered_map<int, Integer> c(a); } catch (std::runtime_error &) { thrown++; }
+        Integer::copies_left = 1000;
+        try { b = a; } catch (std::runtime_error &) { thrown++; }
+        if (thrown != 2 || !b.empty() || Integer::counter != 2500) return std::make_pair(false, 0);
+    }
+    return std::make_pair(Integer::counter == 0, 0);
+}
+
+std::pair<bool, double> reserveChecker() {
+    sjtu::unordered_map<int, int> a;
+    a.reserve(N);
+    size_t buckets = a.bucket_count();
+    for (int i = 0; i < N; i++) {
+        a[i] = i;
+    }
+    return std::make_pair(buckets >= static_cast<size_t>(N) && a.bucket_count() == buckets, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Hash Series -> random operations against std testing...", randomChecker),
+    std::make_pair("Hash Series -> erase churn testing...", churnChecker),
+    std::make_pair("Hash Series -> iterator testing...", iteratorChecker),
+    std::make_pair("Hash Series -> copy and clear testing...", copyChecker),
+    std::make_pair("Hash Series -> exception testing...", exceptionChecker),
+    std::make_pair("Hash Series -> colliding hash testing...", collisionChecker),
+    std::make_pair("Hash Series -> element lifetime testing...", lifetimeChecker),
+    std::make_pair("Hash Series -> reserve testing...", reserveChecker),
+};
+
+static std::vector<int> speedKeys() {
+    std::vector<int> keys(N_SPEED);
+    std::mt19937 rng(2017);
+    for (int i = 0; i < N_SPEED; i++) {
+        keys[i] = rng();
+    }
+    return keys;
+}
+
+template<class Map>
+std::pair<bool, double> insertTimer() {
+    std::vector<int> keys = speedKeys();
+    timer.init();
+    Map a;
+    for (int i = 0; i < N_SPEED; i++) {
+        a[keys[i]] = i;
+    }
+    timer.stop();
+    return std::make_pair(a.size() > 0, timer.getTime());
+}
+
+template<class Map>
+std::pair<bool, double> findTimer() {
+    std::vector<int> keys = speedKeys();
+    Map a;
+    for (int i = 0; i < N_SPEED; i += 2) {
+        a[keys[i]] = i;
+    }
+    timer.init();
+    size_t found = 0;
+    for (int i = 0; i < N_SPEED; i++) {
+        found += a.find(keys[i]) != a.end();
+    }
+    timer.stop();
+    return std::make_pair(found >= static_cast<size_t>(N_SPEED / 2), timer.getTime());
+}
+
+template<class Map>
+std::pair<bool, double> eraseTimer() {
+    std::vector<int> keys = speedKeys();
+    Map a;
+    for (int i = 0; i < N_SPEED; i++) {
+        a[keys[i]] = i;
+    }
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        typename Map::iterator it = a.find(keys[i]);
+        if (it != a.end()) {
+            a.erase(it);
+        }
+    }
+    timer.stop();
+    return std::make_pair(a.empty(), timer.getTime());
+}
+
+#ifdef __BENCHMARK
+static CheckerPair TEST_B[] = {
+    std::make_pair("std::unordered_map operator[]", insertTimer<std::unordered_map<int, int>>),
+    std::make_pair("sjtu::unordered_map operator[]", insertTimer<sjtu::unordered_map<int, int>>),
+    std::make_pair("std::unordered_map find, half misses", findTimer<std::unordered_map<int, int>>),
+    std::make_pair("sjtu::unordered_map find, half misses", findTimer<sjtu::unordered_map<int, int>>),
+    std::make_pair("std::unordered_map erase", eraseTimer<std::unordered_map<int, int>>),
+    std::make_pair("sjtu::unordered_map erase", eraseTimer<sjtu::unordered_map<int, int>>),
+};
+#endif
+
+#define __CORRECT_TEST
+#ifdef __BENCHMARK
+#define __SPEED_TEST
+#else
+#define __OFFICAL
+#endif
+
+int main() {
+#ifndef __OFFICAL
+    puts("Unordered Map CheckTool");
+#else
+    puts("Unordered Map CheckTool Offical Version");
+#endif
+    puts("");
+#ifdef __CORRECT_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#ifdef __SPEED_TEST
+    puts("");
+#endif
+#endif
+
+#ifdef __SPEED_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone B: Speed Testing against std::unordered_map...");
+        printf("Test Size: %d random keys\n", N_SPEED);
+        int n = sizeof(TEST_B) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_B[i].first);
+            std::pair<bool, double> result = TEST_B[i].second();
+#ifndef __OFFICAL
+            printf("%.3f\n", result.second);
+#else
+            puts(result.first ? "PASSED" : "FAILED");
+#endif
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#endif
+    return 0;
+}
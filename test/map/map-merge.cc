@@ -0,0 +1,105 @@
+#include "map.hpp"
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <random>
+#include <string>
+
+typedef sjtu::map<int, std::string> Map;
+
+//	the same elements as expected, in order both ways, which needs the parent links to be right
+bool same(Map &map, const std::map<int, std::string> &expected) {
+	if (map.size() != expected.size()) {
+		return false;
+	}
+	Map::iterator it = map.begin();
+	for (const auto &x : expected) {
+		if (it == map.end() || it->first != x.first || it->second != x.second) {
+			return false;
+		}
+		++it;
+	}
+	if (it != map.end()) {
+		return false;
+	}
+	for (auto x = expected.rbegin(); x != expected.rend(); ++x) {
+		--it;
+		if (it->first != x->first) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void check(int n_into, int n_from, int range, std::mt19937 &rng) {
+	Map into, from;
+	std::map<int, std::string> expected_into, expected_from;
+	for (int i = 0; i < n_into; ++i) {
+		int key = rng() % range;
+		into[key] = "into";
+		expected_into[key] = "into";
+	}
+	for (int i = 0; i < n_from; ++i) {
+		int key = rng() % range;
+		from[key] = "from";
+		expected_from[key] = "from";
+	}
+	//	the keys of from that are in into stay in from
+	for (auto x = expected_from.begin(); x != expected_from.end(); ) {
+		if (expected_into.count(x->first)) {
+			++x;
+		} else {
+			expected_into.insert(*x);
+			x = expected_from.erase(x);
+		}
+	}
+	into.merge(from);
+	assert(same(into, expected_into) && same(from, expected_from));
+	//	both are still working maps
+	for (int i = 0; i < 1000; ++i) {
+		int key = rng() % range;
+		Map &map = i % 2 ? into : from;
+		std::map<int, std::string> &expected = i % 2 ? expected_into : expected_from;
+		if (expected.count(key)) {
+			map.erase(map.find(key));
+			expected.erase(key);
+		} else {
+			map[key] = "new";
+			expected[key] = "new";
+		}
+	}
+	assert(same(into, expected_into) && same(from, expected_from));
+	std::cout << into.size() << " " << from.size() << std::endl;
+}
+
+void tester(void) {
+	std::mt19937 rng(2017);
+	//	test: maps of about the same size, then very different sizes both ways
+	check(20000, 20000, 50000, rng);
+	check(50000, 100, 1000000, rng);
+	check(100, 50000, 1000000, rng);
+	//	test: all the keys in both, none moves
+	check(5000, 5000, 100, rng);
+	//	test: disjoint ranges, a single join
+	Map low, high;
+	for (int i = 0; i < 1000; ++i) {
+		low[i] = "low";
+		high[i + 1000] = "high";
+	}
+	high.merge(low);
+	int expected = 0;
+	for (Map::iterator it = high.begin(); it != high.end() && it->first == expected; ++it) {
+		++expected;
+	}
+	std::cout << expected << " " << high.size() << " " << low.size() << " " << low.empty() << std::endl;
+	//	test: empty maps and merging a map into itself
+	Map empty;
+	high.merge(empty);
+	empty.merge(high);
+	empty.merge(empty);
+	std::cout << high.size() << " " << empty.size() << " " << empty.at(1999) << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,114 @@
+#include "map.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+class Tracked {
+public:
+	static int copies;
+	static int moves;
+	int val;
+
+	Tracked(int val) : val(val) {}
+
+	Tracked(int a, int b) : val(a * b) {}
+
+	Tracked(const Tracked &rhs) : val(rhs.val) {
+		copies++;
+	}
+
+	Tracked(Tracked &&rhs) : val(rhs.val) {
+		moves++;
+	}
+
+	Tracked& operator = (const Tracked &rhs) {
+		val = rhs.val;
+		copies++;
+		return *this;
+	}
+
+	static void reset() {
+		copies = moves = 0;
+	}
+};
+
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+class Compare {
+public:
+	bool operator () (const Tracked &lhs, const Tracked &rhs) const {
+		return lhs.val < rhs.val;
+	}
+};
+
+static_assert(std::is_trivially_copyable<sjtu::pair<int, double>>::value, "pair of scalars should be trivially copyable");
+static_assert(!std::is_trivially_copyable<sjtu::pair<int, std::string>>::value, "pair of std::string is not trivially copyable");
+
+void report(const char *what) {
+	std::cout << what << ": " << Tracked::copies << " copies, " << Tracked::moves << " moves" << std::endl;
+}
+
+void tester(void) {
+	typedef sjtu::map<Tracked, Tracked, Compare> Map;
+	Map map;
+	//	test: forwarding constructor
+	Tracked::reset();
+	sjtu::pair<Tracked, Tracked> p(Tracked(1), Tracked(2));
+	report("pair(rvalue, rvalue)");
+	assert(Tracked::copies == 0 && Tracked::moves == 2);
+	//	test: converting move constructor
+	Tracked::reset();
+	Map::value_type q(std::move(p));
+	report("pair<const K, V>(pair<K, V> &&)");
+	assert(Tracked::copies == 0 && Tracked::moves == 2);
+	//	test: piecewise constructor
+	Tracked::reset();
+	sjtu::pair<Tracked, Tracked> r(std::piecewise_construct, std::forward_as_tuple(3), std::forward_as_tuple(4, 5));
+	report("pair(piecewise_construct, ...)");
+	assert(Tracked::copies == 0 && Tracked::moves == 0 && r.first.val == 3 && r.second.val == 20);
+	//	test: insert(value_type) copies only the const key, into the node
+	Tracked::reset();
+	for (int i = 0; i < 1000; ++i) {
+		auto result = map.insert(Map::value_type(Tracked(i), Tracked(-i)));
+		assert(result.second);
+	}
+	report("1000 x insert(value_type)");
+	assert(Tracked::copies == 1000);
+	//	test: insert(pair<K, V>)
+	Tracked::reset();
+	for (int i = 1000; i < 2000; ++i) {
+		auto result = map.insert(sjtu::pair<Tracked, Tracked>(Tracked(i), Tracked(-i)));
+		assert(result.second);
+	}
+	report("1000 x insert(pair<K, V>)");
+	assert(Tracked::copies == 1000);
+	//	test: failed insert copies nothing
+	Tracked::reset();
+	for (int i = 0; i < 1000; ++i) {
+		auto result = map.insert(Map::value_type(Tracked(i), Tracked(i)));
+		assert(!result.second && result.first->second.val == -i);
+	}
+	report("1000 x insert(value_type) of present keys");
+	assert(Tracked::copies == 0);
+	//	test: operator[] copies the key once, never the mapped value
+	sjtu::map<Tracked, std::string, Compare> names;
+	Tracked::reset();
+	for (int i = 0; i < 1000; ++i) {
+		Tracked key(i);
+		names[key] = "x";
+	}
+	report("1000 x operator[] of new keys");
+	assert(Tracked::copies == 1000 && names.size() == 1000);
+	//	test: copy assignment of a pair
+	sjtu::pair<int, double> a(1, 2.5), b;
+	b = a;
+	assert(b.first == 1 && b.second == 2.5);
+	std::cout << map.size() << std::endl;
+}
+
+int main(void) {
+	tester();
+}
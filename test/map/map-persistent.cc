@@ -0,0 +1,210 @@
+#include "persistent_map.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Integer {
+public:
+	static std::atomic<int> counter;
+	int val;
+
+	Integer(int val) : val(val) {
+		counter++;
+	}
+
+	Integer(const Integer &rhs) {
+		val = rhs.val;
+		counter++;
+	}
+
+	Integer& operator = (const Integer &rhs) = delete;
+
+	~Integer() {
+		counter--;
+	}
+};
+
+std::atomic<int> Integer::counter(0);
+
+class Compare {
+public:
+	bool operator () (const Integer &lhs, const Integer &rhs) const {
+		return lhs.val < rhs.val;
+	}
+};
+
+template<class Map>
+bool same(const Map &a, const std::map<int, int> &b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	typename Map::const_iterator it = a.cbegin();
+	for (std::map<int, int>::const_iterator jt = b.begin(); jt != b.end(); ++jt, ++it) {
+		if (it->first != jt->first || it->second != jt->second) {
+			return false;
+		}
+	}
+	return it == a.cend();
+}
+
+void tester(void) {
+	//	test: random operations against std::map, with snapshots that must not change afterwards
+	sjtu::persistent_map<int, int> map;
+	std::map<int, int> ref;
+	std::vector<sjtu::persistent_map<int, int>> snapshots;
+	std::vector<std::map<int, int>> ref_snapshots;
+	std::mt19937 rng(2017);
+	for (int i = 0; i < 200000; ++i) {
+		int key = rng() % 10000, op = rng() % 4;
+		if (op == 0) {
+			bool inserted = map.insert(sjtu::pair<const int, int>(key, i)).second;
+			bool ref_inserted = ref.insert(std::make_pair(key, i)).second;
+			assert(inserted == ref_inserted);
+			(void)inserted, (void)ref_inserted;
+		} else if (op == 1) {
+			map[key] += i;
+			ref[key] += i;
+		} else if (op == 2) {
+			if (map.find_ptr(key)) {
+				map.at(key) -= 1;
+				ref[key] -= 1;
+			}
+		} else {
+			size_t erased = map.erase(key);
+			size_t ref_erased = ref.erase(key);
+			assert(erased == ref_erased);
+			(void)erased, (void)ref_erased;
+		}
+		if (i % 5000 == 0) {
+			snapshots.push_back(map.snapshot());
+			ref_snapshots.push_back(ref);
+		}
+	}
+	int unchanged = 0;
+	for (size_t i = 0; i < snapshots.size(); ++i) {
+		unchanged += same(snapshots[i], ref_snapshots[i]);
+	}
+	std::cout << map.size() << " " << same(map, ref) << " " << snapshots.size() << " " << unchanged << std::endl;
+	//	test: the copies are independent, whichever of them is modified
+	sjtu::persistent_map<int, int> copy(map), assigned;
+	assigned = copy;
+	assigned = assigned;
+	for (int key = 0; key < 10000; key += 3) {
+		copy[key] = -1;
+		assigned.erase(key);
+	}
+	size_t minus = 0;
+	for (auto it = copy.begin(); it != copy.end(); ++it) {
+		minus += it->second == -1;
+	}
+	std::cout << same(map, ref) << " " << minus << " " << copy.size() << " " << assigned.size() << std::endl;
+	//	test: iterating backwards, --end(), the checks of the iterators
+	auto it = map.end();
+	auto rit = ref.end();
+	size_t backwards = 0;
+	while (rit != ref.begin()) {
+		--it;
+		--rit;
+		backwards += it->first == rit->first;
+	}
+	assert(it == map.begin());
+	std::cout << backwards << std::endl;
+	try {
+		--it;
+		assert(false);
+	} catch (sjtu::invalid_iterator &) {}
+	std::cout << (it == map.begin()) << " " << (map.find(-5) == map.end()) << " " << map.find(ref.begin()->first)->second << std::endl;
+	try {
+		map.erase(map.end());
+		assert(false);
+	} catch (sjtu::index_out_of_bound &) {}
+	try {
+		map.erase(copy.begin());
+		assert(false);
+	} catch (sjtu::index_out_of_bound &) {}
+	try {
+		map.at(-5);
+		assert(false);
+	} catch (sjtu::index_out_of_bound &) {}
+	while (!map.empty()) {
+		map.erase(map.begin());
+	}
+	std::cout << map.size() << " " << (map.begin() == map.end()) << " " << same(snapshots.back(), ref_snapshots.back()) << std::endl;
+	//	test: readers scanning snapshots while a writer keeps changing the map
+	{
+		const int N = 2000, STEPS = 20000;
+		sjtu::persistent_map<int, long> shared;
+		for (int key = 0; key < N; ++key) {
+			shared[key] = key;
+		}
+		shared[-1] = 0;
+		std::mutex lock;
+		sjtu::persistent_map<int, long> latest = shared;
+		std::atomic<bool> done(false);
+		std::atomic<int> scans(0), inconsistent(0);
+		// a version v holds the keys v..v+N-1 and -1 -> v
+		std::thread writer([&] {
+			for (int v = 0; v < STEPS; ++v) {
+				shared.erase(v);
+				shared[v + N] = v + N;
+				shared.at(-1) = v + 1;
+				if (v % 16 == 0) {
+					std::lock_guard<std::mutex> guard(lock);
+					latest = shared.snapshot();
+				}
+			}
+			done = true;
+		});
+		std::vector<std::thread> readers;
+		for (int t = 0; t < 3; ++t) {
+			readers.push_back(std::thread([&] {
+				do {
+					sjtu::persistent_map<int, long> view;
+					{
+						std::lock_guard<std::mutex> guard(lock);
+						view = latest;
+					}
+					long v = view.at(-1), sum = 0;
+					for (auto it = view.begin(); it != view.end(); ++it) {
+						sum += it->first == -1 ? 0 : it->second;
+					}
+					inconsistent += view.size() != N + 1 || sum != N * v + 1L * N * (N - 1) / 2;
+					++scans;
+				} while (!done);
+			}));
+		}
+		writer.join();
+		for (std::thread &t : readers) {
+			t.join();
+		}
+		std::cout << inconsistent << " " << (scans > 0) << " " << shared.size() << " " << shared.at(-1) << std::endl;
+	}
+	//	test: keys without default constructor and assignment, no element leaked
+	{
+		sjtu::persistent_map<Integer, std::string, Compare> strings;
+		for (int i = 0; i < 30000; ++i) {
+			strings[Integer(i * 7919 % 30000)] = std::to_string(i);
+		}
+		sjtu::persistent_map<Integer, std::string, Compare> before(strings);
+		for (int i = 0; i < 30000; i += 2) {
+			strings.erase(strings.find(Integer(i)));
+		}
+		int last = -1, ordered = 0;
+		for (auto it = strings.cbegin(); it != strings.cend(); ++it) {
+			ordered += it->first.val > last && it->first.val % 2 == 1;
+			last = it->first.val;
+		}
+		std::cout << ordered << " " << strings.size() << " " << before.size() << " " << before.at(Integer(4998)) << std::endl;
+	}
+	std::cout << Integer::counter << std::endl;
+}
+
+int main(void) {
+	tester();
+}
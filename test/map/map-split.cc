@@ -0,0 +1,99 @@
+#include "map.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <string>
+
+typedef sjtu::map<int, std::string> Map;
+
+//	the keys in [lo, hi) with the given step, in order both ways, which needs the parent links to be right
+bool holds(Map &map, int lo, int hi, int step) {
+	Map::iterator it = map.begin();
+	for (int key = lo; key < hi; key += step, ++it) {
+		if (it == map.end() || it->first != key || it->second != std::to_string(key)) {
+			return false;
+		}
+	}
+	if (it != map.end()) {
+		return false;
+	}
+	for (int key = hi - 1 - (hi - 1 - lo) % step; key >= lo; key -= step) {
+		if ((--it)->first != key) {
+			return false;
+		}
+	}
+	return map.size() == (size_t)((hi - lo + step - 1) / step);
+}
+
+void fill(Map &map, int lo, int hi, int step) {
+	for (int key = lo; key < hi; key += step) {
+		map[key] = std::to_string(key);
+	}
+}
+
+void tester(void) {
+	Map map;
+	fill(map, 0, 100000, 2);
+	//	test: split at a key in the map and at one not in it, the key goes right
+	Map right = map.split(50000);
+	assert(holds(map, 0, 50000, 2) && holds(right, 50000, 100000, 2));
+	Map middle = map.split(25001);
+	assert(holds(map, 0, 25001, 2) && holds(middle, 25002, 50000, 2));
+	std::cout << map.size() << " " << middle.size() << " " << right.size() << std::endl;
+	//	test: split below and above every key
+	Map all = map.split(-1);
+	Map none = all.split(1000000);
+	std::cout << map.size() << " " << map.empty() << " " << all.size() << " " << none.size() << std::endl;
+	//	test: join back in both orders, then the maps still work
+	all.join(none);
+	right.join(middle);
+	right.join(all);
+	assert(holds(right, 0, 100000, 2));
+	for (int key = 1; key < 100000; key += 2) {
+		right[key] = std::to_string(key);
+	}
+	for (int key = 0; key < 100000; key += 2) {
+		right.erase(right.find(key));
+	}
+	assert(holds(right, 1, 100000, 2));
+	std::cout << right.size() << " " << all.size() << " " << middle.size() << std::endl;
+	//	test: overlapping key ranges are refused and nothing changes
+	Map other;
+	fill(other, 50001, 50002, 1);
+	try {
+		right.join(other);
+		std::cout << "joined" << std::endl;
+	} catch (sjtu::runtime_error &) {
+		std::cout << "overlap" << std::endl;
+	}
+	assert(holds(right, 1, 100000, 2) && holds(other, 50001, 50002, 1));
+	//	test: erasing a range, the keys in [lo, hi)
+	Map tail = right.split(30000);
+	Map rest = tail.split(70000);
+	right.join(rest);
+	assert(right.size() == 15000 + 15000 && right.count(29999) && !right.count(30001) && right.count(70001));
+	std::cout << right.size() << " " << tail.size() << std::endl;
+	//	test: random splits and joins of maps of random sizes
+	std::mt19937 rng(2017);
+	int failures = 0;
+	for (int round = 0; round < 200; ++round) {
+		int n = rng() % 2000, key = rng() % 2100 - 50;
+		Map m;
+		fill(m, 0, n, 1);
+		Map r = m.split(key);
+		int cut = key < 0 ? 0 : key > n ? n : key;
+		failures += !holds(m, 0, cut, 1) || !holds(r, cut, n, 1);
+		if (round % 2) {
+			r.join(m);
+			failures += !holds(r, 0, n, 1);
+		} else {
+			m.join(r);
+			failures += !holds(m, 0, n, 1);
+		}
+	}
+	std::cout << "random splits failed: " << failures << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,251 @@
+#include "class-matrix.hpp"
+#include "class-fixed-matrix.hpp"
+#include "class-matrix-batch.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <utility>
+
+static const int N = 3000;
+static const int N_SPEED = 200000;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+class Timer{
+private:
+    long dfnStart, dfnEnd;
+
+public:
+    void init() {
+        dfnEnd = dfnStart = clock();
+    }
+    void stop() {
+        dfnEnd = clock();
+    }
+    double getTime() {
+        return 1.0 * (dfnEnd - dfnStart) / CLOCKS_PER_SEC;
+    }
+
+};
+
+Timer timer;
+
+Diamond::Matrix<double> randomMatrix(size_t n, size_t m) {
+    Diamond::Matrix<double> a(n, m);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < m; j++) {
+            a[i][j] = rand() % 19 - 9;
+        }
+    }
+    return a;
+}
+
+std::vector<Diamond::Matrix<double>> randomBatch(size_t count, size_t n, size_t m) {
+    std::vector<Diamond::Matrix<double>> res;
+    for (size_t t = 0; t < count; t++) {
+        res.push_back(randomMatrix(n, m));
+    }
+    return res;
+}
+
+std::pair<bool, double> packChecker() {
+    std::vector<Diamond::Matrix<double>> a = randomBatch(37, 3, 5);
+    Diamond::MatrixBatch<double> batch(a);
+    if (batch.BatchSize() != 37 || batch.RowSize() != 3 || batch.ColSize() != 5) return std::make_pair(false, 0);
+    for (size_t t = 0; t < a.size(); t++) {
+        if (!(batch[t] == a[t]) || batch.At(t, 2, 4) != a[t][2][4]) return std::make_pair(false, 0);
+    }
+    std::vector<Diamond::Matrix<double>> b = batch.Unpack();
+    for (size_t t = 0; t < a.size(); t++) {
+        if (!(b[t] == a[t])) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+bool multiplyCase(size_t count, size_t n, size_t k, size_t m, size_t threads) {
+    std::vector<Diamond::Matrix<double>> a = randomBatch(count, n, k), b = randomBatch(count, k, m);
+    std::vector<Diamond::Matrix<double>> c = Diamond::BatchMultiply(a, b, threads);
+    if (c.size() != count) return false;
+    for (size_t t = 0; t < count; t++) {
+        if (!(c[t] == a[t] * b[t])) return false;
+    }
+    return true;
+}
+
+std::pair<bool, double> smallBatchChecker() {
+    return std::make_pair(multiplyCase(1, 3, 3, 3, 0) && multiplyCase(7, 4, 4, 4, 0) && multiplyCase(0, 3, 3, 3, 0), 0);
+}
+
+std::pair<bool, double> shapeChecker() {
+    return std::make_pair(multiplyCase(300, 2, 5, 3, 1) && multiplyCase(257, 1, 7, 1, 1) && multiplyCase(513, 6, 1, 6, 1), 0);
+}
+
+std::pair<bool, double> threadChecker() {
+    for (size_t threads : {1, 2, 3, 8}) {
+        if (!multiplyCase(N, 3, 3, 3, threads) || !multiplyCase(N + 77, 4, 2, 4, threads)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> packedChecker() {
+    std::vector<Diamond::Matrix<double>> a = randomBatch(N, 4, 4), b = randomBatch(N, 4, 4);
+    Diamond::MatrixBatch<double> c = Diamond::BatchMultiply(Diamond::MatrixBatch<double>(a), Diamond::MatrixBatch<double>(b), 4);
+    for (size_t t = 0; t < c.BatchSize(); t++) {
+        if (!(c[t] == a[t] * b[t])) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> errorChecker() {
+    int caught = 0;
+    std::vector<Diamond::Matrix<double>> a = randomBatch(5, 3, 3), b = randomBatch(4, 3, 3), c = randomBatch(5, 2, 3);
+    try { Diamond::BatchMultiply(a, b); } catch (std::invalid_argument &) { caught++; }
+    try { Diamond::BatchMultiply(c, c); } catch (std::invalid_argument &) { caught++; }
+    a.push_back(randomMatrix(3, 4));
+    try { Diamond::MatrixBatch<double> batch(a); } catch (std::invalid_argument &) { caught++; }
+    try { Diamond::MatrixBatch<double> batch((std::vector<Diamond::Matrix<double>>())); } catch (std::invalid_argument &) { caught++; }
+    return std::make_pair(caught == 4, 0);
+}
+
+std::pair<bool, double> moveChecker() {
+    // the batches move their members around, a matrix moved from is 0 x 0
+    Diamond::Matrix<double> a = randomMatrix(3, 4), copy(a);
+    Diamond::Matrix<double> b(std::move(a));
+    bool ok = a.RowSize() == 0 && a.ColSize() == 0 && b == copy;
+    a = std::move(b);
+    ok = ok && b.RowSize() == 0 && b.ColSize() == 0 && a == copy;
+    Diamond::Matrix<double> &same = a;
+    a = std::move(same);
+    return std::make_pair(ok && a == copy, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Batch Series -> pack and unpack testing...", packChecker),
+    std::make_pair("Batch Series -> small batch testing...", smallBatchChecker),
+    std::make_pair("Batch Series -> rectangular members testing...", shapeChecker),
+    std::make_pair("Batch Series -> multi-threaded batch testing...", threadChecker),
+    std::make_pair("Batch Series -> packed batch testing...", packedChecker),
+    std::make_pair("Robustness Series -> mismatched batches testing...", errorChecker),
+    std::make_pair("Robustness Series -> moved-from matrix testing...", moveChecker),
+};
+
+template<size_t S>
+std::pair<bool, double> pairwiseTimer() {
+    std::vector<Diamond::Matrix<double>> a = randomBatch(N_SPEED, S, S), b = randomBatch(N_SPEED, S, S), c;
+    c.reserve(N_SPEED);
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        c.push_back(a[i] * b[i]);
+    }
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+template<size_t S>
+std::pair<bool, double> containerTimer() {
+    std::vector<Diamond::Matrix<double>> a = randomBatch(N_SPEED, S, S), b = randomBatch(N_SPEED, S, S);
+    timer.init();
+    std::vector<Diamond::Matrix<double>> c = Diamond::BatchMultiply(a, b);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+template<size_t S>
+std::pair<bool, double> packedTimer() {
+    Diamond::MatrixBatch<double> a(randomBatch(N_SPEED, S, S)), b(randomBatch(N_SPEED, S, S));
+    timer.init();
+    Diamond::MatrixBatch<double> c = Diamond::BatchMultiply(a, b);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+template<size_t S>
+std::pair<bool, double> fixedTimer() {
+    std::vector<Diamond::FixedMatrix<double, S, S>> a, b, c;
+    for (int i = 0; i < N_SPEED; i++) {
+        a.push_back(Diamond::FixedMatrix<double, S, S>(randomMatrix(S, S)));
+        b.push_back(Diamond::FixedMatrix<double, S, S>(randomMatrix(S, S)));
+    }
+    c.reserve(N_SPEED);
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        c.push_back(a[i] * b[i]);
+    }
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+#ifdef __BENCHMARK
+static CheckerPair TEST_B[] = {
+    std::make_pair("3x3 operator * per pair", pairwiseTimer<3>),
+    std::make_pair("3x3 BatchMultiply on containers", containerTimer<3>),
+    std::make_pair("3x3 BatchMultiply on packed batches", packedTimer<3>),
+    std::make_pair("3x3 FixedMatrix per pair", fixedTimer<3>),
+    std::make_pair("4x4 operator * per pair", pairwiseTimer<4>),
+    std::make_pair("4x4 BatchMultiply on containers", containerTimer<4>),
+    std::make_pair("4x4 BatchMultiply on packed batches", packedTimer<4>),
+    std::make_pair("4x4 FixedMatrix per pair", fixedTimer<4>),
+};
+#endif
+
+#define __CORRECT_TEST
+#ifdef __BENCHMARK
+#define __SPEED_TEST
+#else
+#define __OFFICAL
+#endif
+
+int main() {
+#ifndef __OFFICAL
+    puts("Matrix Batch CheckTool");
+#else
+    puts("Matrix Batch CheckTool Offical Version");
+#endif
+    puts("");
+#ifdef __CORRECT_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#ifdef __SPEED_TEST
+    puts("");
+#endif
+#endif
+
+#ifdef __SPEED_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone B: Operation speed individually Testing...");
+        printf("Test Size: %d Product(s)\n", N_SPEED);
+        int n = sizeof(TEST_B) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_B[i].first);
+            std::pair<bool, double> result = TEST_B[i].second();
+#ifndef __OFFICAL
+            printf("%.3f\n", result.second);
+#else
+            puts("PASSED");
+#endif
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#endif
+    return 0;
+}
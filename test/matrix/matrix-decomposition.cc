@@ -0,0 +1,308 @@
+#include "class-matrix.hpp"
+#include "class-matrix-decomposition.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <utility>
+#include <vector>
+
+static const int N = 150;
+static const int N_SPEED = 500;
+static const double EPS = 1e-8;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+class Timer{
+private:
+    long dfnStart, dfnEnd;
+
+public:
+    void init() {
+        dfnEnd = dfnStart = clock();
+    }
+    void stop() {
+        dfnEnd = clock();
+    }
+    double getTime() {
+        return 1.0 * (dfnEnd - dfnStart) / CLOCKS_PER_SEC;
+    }
+
+};
+
+Timer timer;
+
+Diamond::Matrix<double> randomMatrix(size_t n, size_t m) {
+    Diamond::Matrix<double> a(n, m);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < m; j++) {
+            a[i][j] = 1.0 * (rand() % 2001 - 1000) / 1000;
+        }
+    }
+    return a;
+}
+
+Diamond::Matrix<double> randomSPD(size_t n) {
+    Diamond::Matrix<double> b = randomMatrix(n, n);
+    return b * Diamond::Transpose(b) + Diamond::I<double>(n) * static_cast<double>(n);
+}
+
+// max |a - b| relative to max |b|
+bool close(const Diamond::Matrix<double> &a, const Diamond::Matrix<double> &b) {
+    if (a.RowSize() != b.RowSize() || a.ColSize() != b.ColSize()) return false;
+    double diff = 0, scale = 1;
+    for (size_t i = 0; i < a.RowSize(); i++) {
+        for (size_t j = 0; j < a.ColSize(); j++) {
+            diff = std::max(diff, std::fabs(a[i][j] - b[i][j]));
+            scale = std::max(scale, std::fabs(b[i][j]));
+        }
+    }
+    return diff <= EPS * scale;
+}
+
+// the textbook elimination the factorizations replace
+Diamond::Matrix<double> gaussSolve(Diamond::Matrix<double> a, Diamond::Matrix<double> b) {
+    size_t n = a.RowSize(), m = b.ColSize();
+    for (size_t j = 0; j < n; j++) {
+        size_t p = j;
+        for (size_t i = j + 1; i < n; i++) {
+            if (std::fabs(a[i][j]) > std::fabs(a[p][j])) p = i;
+        }
+        for (size_t k = 0; k < n; k++) std::swap(a[p][k], a[j][k]);
+        for (size_t k = 0; k < m; k++) std::swap(b[p][k], b[j][k]);
+        for (size_t i = 0; i < n; i++) {
+            if (i == j) continue;
+            double f = a[i][j] / a[j][j];
+            for (size_t k = j; k < n; k++) a[i][k] -= f * a[j][k];
+            for (size_t k = 0; k < m; k++) b[i][k] -= f * b[j][k];
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        for (size_t k = 0; k < m; k++) b[i][k] /= a[i][i];
+    }
+    return b;
+}
+
+std::pair<bool, double> luFactorChecker() {
+    for (size_t n : {1, 5, 64, 65, N}) {
+        Diamond::Matrix<double> a = randomMatrix(n, n);
+        Diamond::LU<double> lu(a);
+        Diamond::Matrix<double> pa(n, n);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                pa[i][j] = a[lu.Permutation()[i]][j];
+            }
+        }
+        if (!close(lu.L() * lu.U(), pa)) return std::make_pair(false, 0);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < i; j++) {
+                if (std::fabs(lu.L()[i][j]) > 1) return std::make_pair(false, 0);
+            }
+        }
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> luSolveChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N);
+    Diamond::Matrix<double> x = randomMatrix(N, 7);
+    Diamond::Matrix<double> b = a * x;
+    if (!close(Diamond::LU<double>(a).Solve(b), x)) return std::make_pair(false, 0);
+    if (!close(Diamond::Solve(a, b), x)) return std::make_pair(false, 0);
+    if (!close(Diamond::Solve(a.View(), b.Col(3)), Diamond::Matrix<double>(x.Col(3)))) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> determinantChecker() {
+    Diamond::Matrix<double> a(3, 3, 0);
+    a[0][1] = 2, a[1][0] = 3, a[2][2] = 5;
+    if (std::fabs(Diamond::Determinant(a) + 30) > EPS) return std::make_pair(false, 0);
+    // det(AB) = det(A) det(B), det(A^T) = det(A)
+    Diamond::Matrix<double> b = randomMatrix(N / 2, N / 2), c = randomMatrix(N / 2, N / 2);
+    double db = Diamond::Determinant(b), dc = Diamond::Determinant(c);
+    if (std::fabs(Diamond::Determinant(b * c) - db * dc) > 1e-6 * std::fabs(db * dc)) return std::make_pair(false, 0);
+    if (std::fabs(Diamond::Determinant(Diamond::Transpose(b)) - db) > 1e-6 * std::fabs(db)) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> inverseChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N);
+    Diamond::Matrix<double> inv = Diamond::Inverse(a);
+    if (!close(a * inv, Diamond::I<double>(N)) || !close(inv * a, Diamond::I<double>(N))) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> singularChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N);
+    for (size_t i = 0; i < N; i++) {
+        a[i][N - 1] = a[i][0] - a[i][1];
+    }
+    Diamond::Matrix<double> z(4, 4, 0);
+    z[0][0] = 1;
+    Diamond::LU<double> lu(z);
+    if (!lu.IsSingular() || lu.Determinant() != 0) return std::make_pair(false, 0);
+    try {
+        lu.Solve(Diamond::I<double>(4));
+        return std::make_pair(false, 0);
+    } catch (std::invalid_argument &) {}
+    // rounding may leave a tiny pivot, the determinant is still negligible against the Hadamard bound
+    double bound = 1;
+    for (size_t i = 0; i < N; i++) {
+        double norm = 0;
+        for (size_t j = 0; j < N; j++) norm += a[i][j] * a[i][j];
+        bound *= std::sqrt(norm);
+    }
+    if (std::fabs(Diamond::Determinant(a)) > 1e-8 * bound) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> choleskyFactorChecker() {
+    for (size_t n : {1, 5, 64, 65, N}) {
+        Diamond::Matrix<double> a = randomSPD(n);
+        Diamond::Cholesky<double> ch(a);
+        const Diamond::Matrix<double> &l = ch.L();
+        for (size_t i = 0; i < n; i++) {
+            if (l[i][i] <= 0) return std::make_pair(false, 0);
+            for (size_t j = i + 1; j < n; j++) {
+                if (l[i][j] != 0) return std::make_pair(false, 0);
+            }
+        }
+        if (!close(l * Diamond::Transpose(l), a)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> choleskySolveChecker() {
+    Diamond::Matrix<double> a = randomSPD(N);
+    Diamond::Matrix<double> x = randomMatrix(N, 7);
+    Diamond::Cholesky<double> ch(a);
+    if (!close(ch.Solve(a * x), x)) return std::make_pair(false, 0);
+    if (!close(a * ch.Inverse(), Diamond::I<double>(N))) return std::make_pair(false, 0);
+    Diamond::Matrix<double> s = randomSPD(N / 3);
+    double d1 = Diamond::Cholesky<double>(s).Determinant(), d2 = Diamond::Determinant(s);
+    if (std::fabs(d1 - d2) > 1e-8 * std::fabs(d2)) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> errorChecker() {
+    int caught = 0;
+    try { Diamond::LU<double> lu(Diamond::Matrix<double>(3, 4, 1)); } catch (std::invalid_argument &) { caught++; }
+    try { Diamond::Cholesky<double> ch(Diamond::Matrix<double>(4, 3, 1)); } catch (std::invalid_argument &) { caught++; }
+    try { Diamond::Solve(randomMatrix(4, 4), randomMatrix(3, 1)); } catch (std::invalid_argument &) { caught++; }
+    try { Diamond::Cholesky<double> ch(-Diamond::I<double>(3)); } catch (std::invalid_argument &) { caught++; }
+    try { Diamond::Cholesky<double> ch(randomMatrix(N, N)); } catch (std::invalid_argument &) { caught++; }
+    return std::make_pair(caught == 5, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("LU Series -> PA = LU testing...", luFactorChecker),
+    std::make_pair("LU Series -> Solve testing...", luSolveChecker),
+    std::make_pair("LU Series -> Determinant testing...", determinantChecker),
+    std::make_pair("LU Series -> Inverse testing...", inverseChecker),
+    std::make_pair("LU Series -> singular matrix testing...", singularChecker),
+    std::make_pair("Cholesky Series -> A = LL^T testing...", choleskyFactorChecker),
+    std::make_pair("Cholesky Series -> Solve, Inverse, Determinant testing...", choleskySolveChecker),
+    std::make_pair("Robustness Series -> invalid input testing...", errorChecker),
+};
+
+std::pair<bool, double> gaussTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED), b = randomMatrix(N_SPEED, 1);
+    timer.init();
+    Diamond::Matrix<double> x = gaussSolve(a, b);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> luTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED), b = randomMatrix(N_SPEED, 1);
+    timer.init();
+    Diamond::Matrix<double> x = Diamond::Solve(a, b);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> choleskyTimer() {
+    Diamond::Matrix<double> a = randomSPD(N_SPEED), b = randomMatrix(N_SPEED, 1);
+    timer.init();
+    Diamond::Matrix<double> x = Diamond::Cholesky<double>(a).Solve(b);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> inverseTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED);
+    timer.init();
+    Diamond::Matrix<double> x = Diamond::Inverse(a);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+#ifdef __BENCHMARK
+static CheckerPair TEST_B[] = {
+    std::make_pair("Gauss-Jordan elimination solve", gaussTimer),
+    std::make_pair("blocked LU solve", luTimer),
+    std::make_pair("blocked Cholesky solve", choleskyTimer),
+    std::make_pair("LU Inverse", inverseTimer),
+};
+#endif
+
+#define __CORRECT_TEST
+#ifdef __BENCHMARK
+#define __SPEED_TEST
+#else
+#define __OFFICAL
+#endif
+
+int main() {
+#ifndef __OFFICAL
+    puts("Matrix Decomposition CheckTool");
+#else
+    puts("Matrix Decomposition CheckTool Offical Version");
+#endif
+    puts("");
+#ifdef __CORRECT_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#ifdef __SPEED_TEST
+    puts("");
+#endif
+#endif
+
+#ifdef __SPEED_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone B: Decomposition speed Testing...");
+        printf("Test Size: %d x %d Matrix\n", N_SPEED, N_SPEED);
+        int n = sizeof(TEST_B) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_B[i].first);
+            std::pair<bool, double> result = TEST_B[i].second();
+#ifndef __OFFICAL
+            printf("%.3f\n", result.second);
+#else
+            puts("PASSED");
+#endif
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#endif
+    return 0;
+}
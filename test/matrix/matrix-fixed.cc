@@ -0,0 +1,249 @@
+#include "class-matrix.hpp"
+#include "class-fixed-matrix.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <type_traits>
+#include <vector>
+#include <utility>
+
+static const int N = 1000;
+static const int N_SPEED = 200000;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+class Timer{
+private:
+    long dfnStart, dfnEnd;
+
+public:
+    void init() {
+        dfnEnd = dfnStart = clock();
+    }
+    void stop() {
+        dfnEnd = clock();
+    }
+    double getTime() {
+        return 1.0 * (dfnEnd - dfnStart) / CLOCKS_PER_SEC;
+    }
+
+};
+
+Timer timer;
+
+template<size_t R, size_t C>
+Diamond::FixedMatrix<double, R, C> randomFixed() {
+    Diamond::FixedMatrix<double, R, C> a;
+    for (size_t i = 0; i < R; i++) {
+        for (size_t j = 0; j < C; j++) {
+            a[i][j] = rand() % 19 - 9;
+        }
+    }
+    return a;
+}
+
+template<size_t R, size_t C>
+bool sameAs(const Diamond::FixedMatrix<double, R, C> &a, const Diamond::Matrix<double> &b) {
+    if (b.RowSize() != R || b.ColSize() != C) return false;
+    for (size_t i = 0; i < R; i++) {
+        for (size_t j = 0; j < C; j++) {
+            if (a[i][j] != b[i][j]) return false;
+        }
+    }
+    return true;
+}
+
+std::pair<bool, double> constructChecker() {
+    Diamond::FixedMatrix<double, 2, 3> z, f(2.5), l{1, 2, 3, 4};
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            if (z[i][j] != 0 || f[i][j] != 2.5) return std::make_pair(false, 0);
+            if (l[i][j] != (i * 3 + j < 4 ? i * 3 + j + 1 : 0)) return std::make_pair(false, 0);
+        }
+    }
+    if (Diamond::FixedMatrix<double, 2, 3>::RowSize() != 2 || l.ColSize() != 3) return std::make_pair(false, 0);
+    static_assert(sizeof(Diamond::FixedMatrix<double, 4, 4>) == 16 * sizeof(double), "fixed matrix must not own heap memory");
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> conversionChecker() {
+    for (int t = 0; t < N; t++) {
+        Diamond::FixedMatrix<double, 3, 4> a = randomFixed<3, 4>();
+        Diamond::Matrix<double> d(a);
+        if (!sameAs(a, d) || !sameAs(a, a.ToMatrix())) return std::make_pair(false, 0);
+        if (!(Diamond::FixedMatrix<double, 3, 4>(d) == a)) return std::make_pair(false, 0);
+        Diamond::Matrix<double> big(5, 6, 0);
+        big.SubMatrix(1, 2, 3, 4) = a;
+        if (!(Diamond::FixedMatrix<double, 3, 4>(big.SubMatrix(1, 2, 3, 4)) == a)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> arithmeticChecker() {
+    for (int t = 0; t < N; t++) {
+        Diamond::FixedMatrix<double, 3, 3> a = randomFixed<3, 3>(), b = randomFixed<3, 3>();
+        Diamond::Matrix<double> da(a), db(b);
+        if (!sameAs(a + b, da + db) || !sameAs(a - b, da - db) || !sameAs(-a, -da)) return std::make_pair(false, 0);
+        if (!sameAs(a * 3.0, da * 3.0) || !sameAs(3.0 * a, 3.0 * da) || !sameAs(a / 2.0, da / 2.0)) return std::make_pair(false, 0);
+        if (!sameAs(Diamond::Transpose(a), Diamond::Transpose(da))) return std::make_pair(false, 0);
+        if ((a == b) != (da == db) || !(a == a)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> multiplyChecker() {
+    for (int t = 0; t < N; t++) {
+        Diamond::FixedMatrix<double, 3, 3> a3 = randomFixed<3, 3>(), b3 = randomFixed<3, 3>();
+        Diamond::FixedMatrix<double, 4, 4> a4 = randomFixed<4, 4>(), b4 = randomFixed<4, 4>();
+        Diamond::FixedMatrix<double, 2, 5> a25 = randomFixed<2, 5>();
+        Diamond::FixedMatrix<double, 5, 3> b53 = randomFixed<5, 3>();
+        if (!sameAs(a3 * b3, Diamond::Matrix<double>(a3) * Diamond::Matrix<double>(b3))) return std::make_pair(false, 0);
+        if (!sameAs(a4 * b4, Diamond::Matrix<double>(a4) * Diamond::Matrix<double>(b4))) return std::make_pair(false, 0);
+        if (!sameAs(a25 * b53, Diamond::Matrix<double>(a25) * Diamond::Matrix<double>(b53))) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> overloadChecker() {
+    Diamond::FixedMatrix<double, 3, 3> a = randomFixed<3, 3>();
+    Diamond::Matrix<double> d(a);
+    // fixed op fixed stays fixed, fixed op dynamic goes through the dynamic path
+    static_assert(std::is_same<decltype(a * a), Diamond::FixedMatrix<double, 3, 3>>::value, "fixed * fixed");
+    static_assert(std::is_same<decltype(a * 2.0), Diamond::FixedMatrix<double, 3, 3>>::value, "fixed * scalar");
+    static_assert(std::is_same<decltype(Diamond::Transpose(a)), Diamond::FixedMatrix<double, 3, 3>>::value, "transpose");
+    static_assert(std::is_same<decltype(a * d), Diamond::Matrix<double>>::value, "fixed * dynamic");
+    static_assert(std::is_same<decltype(d + a), Diamond::Matrix<double>>::value, "dynamic + fixed");
+    if (!(a * d == d * d) || !(d + a == d + d) || !(a == d)) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> powChecker() {
+    Diamond::FixedMatrix<double, 4, 4> a = randomFixed<4, 4>() / 4.0;
+    Diamond::Matrix<double> d(a);
+    for (size_t e = 0; e < 8; e++) {
+        size_t e1 = e, e2 = e;
+        if (!sameAs(Diamond::Pow(a, e1), Diamond::Pow(d, e2))) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> errorChecker() {
+    Diamond::Matrix<double> d(3, 4);
+    int caught = 0;
+    try { Diamond::FixedMatrix<double, 4, 3> f(d); } catch (std::invalid_argument &) { caught++; }
+    try { Diamond::FixedMatrix<double, 1, 2> f{1, 2, 3}; } catch (std::invalid_argument &) { caught++; }
+    try { d * randomFixed<3, 3>(); } catch (std::invalid_argument &) { caught++; }
+    return std::make_pair(caught == 3, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Basic Series -> construction testing...", constructChecker),
+    std::make_pair("Basic Series -> conversion with Matrix testing...", conversionChecker),
+    std::make_pair("Operator Series -> element-wise operators testing...", arithmeticChecker),
+    std::make_pair("Operator Series -> multiplication testing...", multiplyChecker),
+    std::make_pair("Operator Series -> mixing with Matrix testing...", overloadChecker),
+    std::make_pair("Operator Series -> Pow testing...", powChecker),
+    std::make_pair("Robustness Series -> mismatched sizes testing...", errorChecker),
+};
+
+template<size_t S>
+std::pair<bool, double> dynamicBatchTimer() {
+    std::vector<Diamond::Matrix<double>> a, b, c;
+    for (int i = 0; i < N_SPEED; i++) {
+        a.push_back(Diamond::Matrix<double>(randomFixed<S, S>()));
+        b.push_back(Diamond::Matrix<double>(randomFixed<S, S>()));
+    }
+    c.reserve(N_SPEED);
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        c.push_back(a[i] * b[i]);
+    }
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+template<size_t S>
+std::pair<bool, double> fixedBatchTimer() {
+    std::vector<Diamond::FixedMatrix<double, S, S>> a, b, c;
+    for (int i = 0; i < N_SPEED; i++) {
+        a.push_back(randomFixed<S, S>());
+        b.push_back(randomFixed<S, S>());
+    }
+    c.reserve(N_SPEED);
+    timer.init();
+    for (int i = 0; i < N_SPEED; i++) {
+        c.push_back(a[i] * b[i]);
+    }
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+#ifdef __BENCHMARK
+static CheckerPair TEST_B[] = {
+    std::make_pair("Matrix 3x3 batch multiplication", dynamicBatchTimer<3>),
+    std::make_pair("FixedMatrix 3x3 batch multiplication", fixedBatchTimer<3>),
+    std::make_pair("Matrix 4x4 batch multiplication", dynamicBatchTimer<4>),
+    std::make_pair("FixedMatrix 4x4 batch multiplication", fixedBatchTimer<4>),
+};
+#endif
+
+#define __CORRECT_TEST
+#ifdef __BENCHMARK
+#define __SPEED_TEST
+#else
+#define __OFFICAL
+#endif
+
+int main() {
+#ifndef __OFFICAL
+    puts("Fixed Matrix CheckTool");
+#else
+    puts("Fixed Matrix CheckTool Offical Version");
+#endif
+    puts("");
+#ifdef __CORRECT_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#ifdef __SPEED_TEST
+    puts("");
+#endif
+#endif
+
+#ifdef __SPEED_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone B: Operation speed individually Testing...");
+        printf("Test Size: %d Product(s)\n", N_SPEED);
+        int n = sizeof(TEST_B) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_B[i].first);
+            std::pair<bool, double> result = TEST_B[i].second();
+#ifndef __OFFICAL
+            printf("%.3f\n", result.second);
+#else
+            puts("PASSED");
+#endif
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#endif
+    return 0;
+}
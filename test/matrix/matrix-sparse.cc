@@ -0,0 +1,279 @@
+#include "class-matrix.hpp"
+#include "class-sparse-matrix.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <utility>
+#include <vector>
+
+static const int N = 60;
+static const int N_SPEED = 400;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+class Timer{
+private:
+    long dfnStart, dfnEnd;
+
+public:
+    void init() {
+        dfnEnd = dfnStart = clock();
+    }
+    void stop() {
+        dfnEnd = clock();
+    }
+    double getTime() {
+        return 1.0 * (dfnEnd - dfnStart) / CLOCKS_PER_SEC;
+    }
+
+};
+
+Timer timer;
+
+// integer valued doubles keep every comparison exact
+Diamond::Matrix<double> randomMatrix(size_t n, size_t m, double density) {
+    Diamond::Matrix<double> a(n, m, 0);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < m; j++) {
+            if (rand() < density * RAND_MAX) {
+                a[i][j] = rand() % 19 - 9;
+            }
+        }
+    }
+    return a;
+}
+
+std::pair<bool, double> conversionChecker() {
+    for (double density : {0.0, 0.01, 0.2, 1.0}) {
+        Diamond::Matrix<double> a = randomMatrix(N, N + 7, density);
+        Diamond::SparseMatrix<double> s(a);
+        size_t nnz = 0;
+        for (size_t i = 0; i < a.RowSize(); i++) {
+            for (size_t j = 0; j < a.ColSize(); j++) {
+                if (a[i][j] != 0) nnz++;
+                if (s(i, j) != a[i][j]) return std::make_pair(false, 0);
+            }
+        }
+        if (s.NonZeros() != nnz || !(s.ToDense() == a)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> tripletChecker() {
+    std::vector<Diamond::SparseEntry<double>> entries;
+    Diamond::Matrix<double> a(N, N, 0);
+    for (int t = 0; t < 3 * N; t++) {
+        size_t i = rand() % N, j = rand() % N;
+        double v = rand() % 19 - 9;
+        entries.push_back(Diamond::SparseEntry<double>(i, j, v));
+        a[i][j] += v;
+    }
+    Diamond::SparseMatrix<double> s(N, N, entries);
+    if (!(s.ToDense() == a)) return std::make_pair(false, 0);
+    try {
+        entries.push_back(Diamond::SparseEntry<double>(N, 0, 1));
+        Diamond::SparseMatrix<double> t(N, N, entries);
+        return std::make_pair(false, 0);
+    } catch (std::out_of_range &) {}
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> transposeChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N / 2, 0.1);
+    Diamond::SparseMatrix<double> s(a);
+    if (!(Diamond::Transpose(s).ToDense() == Diamond::Transpose(a))) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> sparseDenseChecker() {
+    for (double density : {0.005, 0.05, 0.5}) {
+        Diamond::Matrix<double> a = randomMatrix(N, N + 3, density);
+        Diamond::Matrix<double> b = randomMatrix(N + 3, N - 5, 0.7);
+        if (!(Diamond::SparseMatrix<double>(a) * b == a * b)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> denseSparseChecker() {
+    for (double density : {0.005, 0.05, 0.5}) {
+        Diamond::Matrix<double> a = randomMatrix(N - 5, N, 0.7);
+        Diamond::Matrix<double> b = randomMatrix(N, N + 3, density);
+        if (!(a * Diamond::SparseMatrix<double>(b) == a * b)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> sparseSparseChecker() {
+    for (double density : {0.005, 0.05, 0.5}) {
+        Diamond::Matrix<double> a = randomMatrix(N, N + 3, density);
+        Diamond::Matrix<double> b = randomMatrix(N + 3, N - 5, density);
+        Diamond::SparseMatrix<double> c = Diamond::SparseMatrix<double>(a) * Diamond::SparseMatrix<double>(b);
+        if (!(c.ToDense() == a * b)) return std::make_pair(false, 0);
+        if (c.NonZeros() != Diamond::SparseMatrix<double>(a * b).NonZeros()) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> powChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N / 2, N / 2, 0.05);
+    for (size_t e = 0; e < 6; e++) {
+        size_t b1 = e, b2 = e;
+        Diamond::SparseMatrix<double> s = Diamond::Pow(Diamond::SparseMatrix<double>(a), b1);
+        if (!(s.ToDense() == Diamond::Pow(a, b2))) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> errorSizeChecker() {
+    Diamond::SparseMatrix<double> a(3, 4), b(3, 4);
+    Diamond::Matrix<double> c(3, 4);
+    int caught = 0;
+    try { a * b; } catch (std::invalid_argument &) { caught++; }
+    try { a * c; } catch (std::invalid_argument &) { caught++; }
+    try { c * a; } catch (std::invalid_argument &) { caught++; }
+    try { size_t e = 2; Diamond::Pow(a, e); } catch (std::invalid_argument &) { caught++; }
+    return std::make_pair(caught == 4, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("Conversion Series -> dense <-> sparse testing...", conversionChecker),
+    std::make_pair("Conversion Series -> triplet construction testing...", tripletChecker),
+    std::make_pair("Conversion Series -> transpose testing...", transposeChecker),
+    std::make_pair("Multiplication Series -> sparse * dense testing...", sparseDenseChecker),
+    std::make_pair("Multiplication Series -> dense * sparse testing...", denseSparseChecker),
+    std::make_pair("Multiplication Series -> sparse * sparse testing...", sparseSparseChecker),
+    std::make_pair("Multiplication Series -> Pow testing...", powChecker),
+    std::make_pair("Robustness Series -> mismatched sizes testing...", errorSizeChecker),
+};
+
+static const double DENSITIES[] = {0.001, 0.01, 0.1};
+static int densityId = 0;
+
+std::pair<bool, double> denseTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED, DENSITIES[densityId]);
+    Diamond::Matrix<double> b = randomMatrix(N_SPEED, N_SPEED, 1.0);
+    timer.init();
+    Diamond::Matrix<double> c = a * b;
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> sparseDenseTimer() {
+    Diamond::SparseMatrix<double> a(randomMatrix(N_SPEED, N_SPEED, DENSITIES[densityId]));
+    Diamond::Matrix<double> b = randomMatrix(N_SPEED, N_SPEED, 1.0);
+    timer.init();
+    Diamond::Matrix<double> c = a * b;
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> denseSquareTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED, DENSITIES[densityId]);
+    timer.init();
+    Diamond::Matrix<double> c = a * a;
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> sparseSquareTimer() {
+    Diamond::SparseMatrix<double> a(randomMatrix(N_SPEED, N_SPEED, DENSITIES[densityId]));
+    timer.init();
+    Diamond::SparseMatrix<double> c = a * a;
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> densePowTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED, DENSITIES[densityId]) / 8.0;
+    size_t e = 4;
+    timer.init();
+    Diamond::Matrix<double> c = Diamond::Pow(a, e);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> sparsePowTimer() {
+    Diamond::SparseMatrix<double> a(randomMatrix(N_SPEED, N_SPEED, DENSITIES[densityId]) / 8.0);
+    size_t e = 4;
+    timer.init();
+    Diamond::SparseMatrix<double> c = Diamond::Pow(a, e);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+#ifdef __BENCHMARK
+static CheckerPair TEST_B[] = {
+    std::make_pair("dense * dense", denseTimer),
+    std::make_pair("sparse * dense", sparseDenseTimer),
+    std::make_pair("dense A * A", denseSquareTimer),
+    std::make_pair("sparse A * A", sparseSquareTimer),
+    std::make_pair("dense Pow(A, 4)", densePowTimer),
+    std::make_pair("sparse Pow(A, 4)", sparsePowTimer),
+};
+#endif
+
+#define __CORRECT_TEST
+#ifdef __BENCHMARK
+#define __SPEED_TEST
+#else
+#define __OFFICAL
+#endif
+
+int main() {
+#ifndef __OFFICAL
+    puts("Sparse Matrix CheckTool");
+#else
+    puts("Sparse Matrix CheckTool Offical Version");
+#endif
+    puts("");
+#ifdef __CORRECT_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#ifdef __SPEED_TEST
+    puts("");
+#endif
+#endif
+
+#ifdef __SPEED_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone B: Sparse against dense speed Testing...");
+        printf("Test Size: %d x %d Matrix\n", N_SPEED, N_SPEED);
+        int n = sizeof(TEST_B) / sizeof(CheckerPair);
+        int d = sizeof(DENSITIES) / sizeof(double);
+        for (densityId = 0; densityId < d; densityId++) {
+            for (int i = 0; i < n; i++) {
+                char title[64];
+                sprintf(title, "%s, density %g", TEST_B[i].first, DENSITIES[densityId]);
+                printf("Test %d: %-59s", densityId * n + i + 1, title);
+                std::pair<bool, double> result = TEST_B[i].second();
+#ifndef __OFFICAL
+                printf("%.3f\n", result.second);
+#else
+                puts("PASSED");
+#endif
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#endif
+    return 0;
+}
@@ -0,0 +1,349 @@
+#include "class-matrix.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <utility>
+
+static const int N = 70;
+static const int N_SPEED = 384;
+static const int TILE = 64;
+
+typedef std::pair<const char *, std::pair<bool, double> (*)()> CheckerPair;
+
+class Timer{
+private:
+    long dfnStart, dfnEnd;
+
+public:
+    void init() {
+        dfnEnd = dfnStart = clock();
+    }
+    void stop() {
+        dfnEnd = clock();
+    }
+    double getTime() {
+        return 1.0 * (dfnEnd - dfnStart) / CLOCKS_PER_SEC;
+    }
+
+};
+
+Timer timer;
+
+Diamond::Matrix<double> randomMatrix(size_t n, size_t m) {
+    Diamond::Matrix<double> a(n, m);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < m; j++) {
+            a[i][j] = rand() % 19 - 9;
+        }
+    }
+    return a;
+}
+
+Diamond::Matrix<double> naiveMultiply(const Diamond::Matrix<double> &a, const Diamond::Matrix<double> &b) {
+    Diamond::Matrix<double> c(a.RowSize(), b.ColSize(), 0);
+    for (size_t i = 0; i < a.RowSize(); i++) {
+        for (size_t j = 0; j < b.ColSize(); j++) {
+            for (size_t k = 0; k < a.ColSize(); k++) {
+                c[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+    return c;
+}
+
+// copy a block out element by element, the way it was done before views
+Diamond::Matrix<double> copyBlock(const Diamond::Matrix<double> &a, size_t r, size_t c, size_t n, size_t m) {
+    Diamond::Matrix<double> res(n, m);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < m; j++) {
+            res[i][j] = a[r + i][c + j];
+        }
+    }
+    return res;
+}
+
+std::pair<bool, double> subMatrixChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N + 5);
+    Diamond::ConstMatrixView<double> v = a.SubMatrix(3, 7, 20, 30);
+    if (v.RowSize() != 20 || v.ColSize() != 30) return std::make_pair(false, 0);
+    if (!(Diamond::Matrix<double>(v) == copyBlock(a, 3, 7, 20, 30))) return std::make_pair(false, 0);
+    Diamond::ConstMatrixView<double> w = v.SubMatrix(2, 4, 5, 6);
+    if (!(w == copyBlock(a, 5, 11, 5, 6))) return std::make_pair(false, 0);
+    a[5][11] = 1000;
+    if (w[0][0] != 1000) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> rowColChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N / 2);
+    for (size_t i = 0; i < a.RowSize(); i++) {
+        Diamond::ConstMatrixView<double> r = a.Row(i);
+        if (r.RowSize() != 1 || r.ColSize() != a.ColSize()) return std::make_pair(false, 0);
+        for (size_t j = 0; j < a.ColSize(); j++) {
+            if (r[0][j] != a[i][j]) return std::make_pair(false, 0);
+        }
+    }
+    for (size_t j = 0; j < a.ColSize(); j++) {
+        Diamond::ConstMatrixView<double> c = a.Col(j);
+        if (c.RowSize() != a.RowSize() || c.ColSize() != 1) return std::make_pair(false, 0);
+        for (size_t i = 0; i < a.RowSize(); i++) {
+            if (c[i][0] != a[i][j]) return std::make_pair(false, 0);
+        }
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> transposeChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N / 3);
+    Diamond::MatrixView<double> t = a.TransposedView();
+    if (!(t == Diamond::Transpose(a))) return std::make_pair(false, 0);
+    if (!(t.TransposedView() == a)) return std::make_pair(false, 0);
+    // a block of a transposed view is the transpose of the mirrored block
+    if (!(t.SubMatrix(2, 5, 10, 20) == Diamond::Transpose(copyBlock(a, 5, 2, 20, 10)))) return std::make_pair(false, 0);
+    if (!(t.Row(4) == Diamond::Transpose(copyBlock(a, 0, 4, a.RowSize(), 1)))) return std::make_pair(false, 0);
+    t[3][8] = -1000;
+    if (a[8][3] != -1000) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> sliceChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N);
+    Diamond::ConstMatrixView<double> s = a.Slice(1, 2, 10, 7, 3, 5);
+    for (size_t i = 0; i < 10; i++) {
+        for (size_t j = 0; j < 7; j++) {
+            if (s[i][j] != a[1 + 3 * i][2 + 5 * j]) return std::make_pair(false, 0);
+        }
+    }
+    Diamond::ConstMatrixView<double> ts = a.TransposedView().Slice(4, 1, 6, 9, 2, 3).Slice(1, 1, 3, 4, 2, 2);
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            size_t r = 1 + 3 * (1 + 2 * j), c = 4 + 2 * (1 + 2 * i);
+            if (ts[i][j] != a[r][c]) return std::make_pair(false, 0);
+        }
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> assignChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N), b = randomMatrix(10, 20);
+    Diamond::Matrix<double> expect(a);
+    for (size_t i = 0; i < 10; i++) {
+        for (size_t j = 0; j < 20; j++) {
+            expect[30 + i][5 + j] = b[i][j];
+        }
+    }
+    a.SubMatrix(30, 5, 10, 20) = b;
+    if (!(a == expect)) return std::make_pair(false, 0);
+    a.Row(0) = a.Row(1);
+    a.Col(2).Fill(7);
+    for (size_t j = 0; j < a.ColSize(); j++) {
+        if (a[0][j] != a[1][j]) return std::make_pair(false, 0);
+    }
+    for (size_t i = 0; i < a.RowSize(); i++) {
+        if (a[i][2] != 7) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> operatorChecker() {
+    Diamond::Matrix<double> a = randomMatrix(N, N), b = randomMatrix(N, N);
+    Diamond::ConstMatrixView<double> va = a.SubMatrix(10, 20, 30, 40), vb = b.SubMatrix(0, 5, 30, 40);
+    Diamond::Matrix<double> ca(va), cb(vb);
+    if (!(va + vb == ca + cb) || !(va + cb == ca + cb) || !(ca + vb == ca + cb)) return std::make_pair(false, 0);
+    if (!(va - vb == ca - cb) || !(-va == -ca)) return std::make_pair(false, 0);
+    if (!(va * 2.0 == ca * 2.0) || !(2.0 * va == 2.0 * ca) || !(va / 2.0 == ca / 2.0)) return std::make_pair(false, 0);
+    if (!(va * vb.TransposedView() == ca * Diamond::Transpose(cb))) return std::make_pair(false, 0);
+    if (!(Diamond::Transpose(va) == Diamond::Transpose(ca))) return std::make_pair(false, 0);
+    std::ostringstream sa, sb;
+    sa << va;
+    sb << ca;
+    if (sa.str() != sb.str()) return std::make_pair(false, 0);
+    Diamond::Matrix<double> sq = randomMatrix(N, N);
+    size_t e1 = 3, e2 = 3;
+    if (!(Diamond::Pow(sq.SubMatrix(1, 1, 20, 20), e1) == Diamond::Pow(copyBlock(sq, 1, 1, 20, 20), e2))) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> multiplyChecker() {
+    size_t sizes[][3] = {{1, 1, 1}, {63, 65, 64}, {130, 70, 129}, {5, 200, 3}};
+    for (auto &sz : sizes) {
+        Diamond::Matrix<double> a = randomMatrix(sz[0], sz[1]), b = randomMatrix(sz[1], sz[2]);
+        if (!(a * b == naiveMultiply(a, b))) return std::make_pair(false, 0);
+        Diamond::Matrix<double> c = randomMatrix(sz[0], sz[2]), expect = c + naiveMultiply(a, b) * -2.0;
+        Diamond::MultiplyAdd(c, a, b, -2);
+        if (!(c == expect)) return std::make_pair(false, 0);
+    }
+    return std::make_pair(true, 0);
+}
+
+// C = A * B computed tile by tile through views, no block is copied out
+Diamond::Matrix<double> tiledMultiply(const Diamond::Matrix<double> &a, const Diamond::Matrix<double> &b) {
+    size_t n = a.RowSize(), m = b.ColSize(), l = a.ColSize();
+    Diamond::Matrix<double> c(n, m, 0);
+    for (size_t i = 0; i < n; i += TILE) {
+        size_t bi = std::min((size_t)TILE, n - i);
+        for (size_t j = 0; j < m; j += TILE) {
+            size_t bj = std::min((size_t)TILE, m - j);
+            for (size_t k = 0; k < l; k += TILE) {
+                size_t bk = std::min((size_t)TILE, l - k);
+                Diamond::MultiplyAdd(c.SubMatrix(i, j, bi, bj), a.SubMatrix(i, k, bi, bk), b.SubMatrix(k, j, bk, bj));
+            }
+        }
+    }
+    return c;
+}
+
+std::pair<bool, double> tiledChecker() {
+    Diamond::Matrix<double> a = randomMatrix(2 * TILE + 3, TILE + 9), b = randomMatrix(TILE + 9, 3 * TILE - 1);
+    if (!(tiledMultiply(a, b) == naiveMultiply(a, b))) return std::make_pair(false, 0);
+    return std::make_pair(true, 0);
+}
+
+std::pair<bool, double> errorChecker() {
+    Diamond::Matrix<double> a(10, 12);
+    int caught = 0;
+    try { a.SubMatrix(5, 5, 6, 2); } catch (std::out_of_range &) { caught++; }
+    try { a.Slice(0, 0, 4, 2, 4, 1); } catch (std::out_of_range &) { caught++; }
+    try { a.Slice(0, 0, 2, 2, 0, 1); } catch (std::invalid_argument &) { caught++; }
+    try { a.TransposedView().Row(11).Col(10); } catch (std::out_of_range &) { caught++; }
+    try { a.SubMatrix(0, 0, 2, 2) = a.SubMatrix(0, 0, 2, 3); } catch (std::invalid_argument &) { caught++; }
+    try { a.Row(0) * a.Row(1); } catch (std::invalid_argument &) { caught++; }
+    try { a.SubMatrix(10, 12, 0, 0); caught++; } catch (...) {}
+    return std::make_pair(caught == 7, 0);
+}
+
+static CheckerPair TEST_A[] = {
+    std::make_pair("View Series -> submatrix testing...", subMatrixChecker),
+    std::make_pair("View Series -> row and column testing...", rowColChecker),
+    std::make_pair("View Series -> transposed view testing...", transposeChecker),
+    std::make_pair("View Series -> strided slice testing...", sliceChecker),
+    std::make_pair("View Series -> assignment through views testing...", assignChecker),
+    std::make_pair("Operator Series -> operators on views testing...", operatorChecker),
+    std::make_pair("Operator Series -> blocked multiplication testing...", multiplyChecker),
+    std::make_pair("Operator Series -> tiled multiplication testing...", tiledChecker),
+    std::make_pair("Robustness Series -> invalid views testing...", errorChecker),
+};
+
+std::pair<bool, double> naiveTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED), b = randomMatrix(N_SPEED, N_SPEED);
+    timer.init();
+    Diamond::Matrix<double> c = naiveMultiply(a, b);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> multiplyTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED), b = randomMatrix(N_SPEED, N_SPEED);
+    timer.init();
+    Diamond::Matrix<double> c = a * b;
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> tiledTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED), b = randomMatrix(N_SPEED, N_SPEED);
+    timer.init();
+    Diamond::Matrix<double> c = tiledMultiply(a, b);
+    timer.stop();
+    return std::make_pair(true, timer.getTime());
+}
+
+std::pair<bool, double> copyBlockTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED);
+    double sum = 0;
+    timer.init();
+    for (size_t i = 0; i + TILE <= N_SPEED; i += TILE / 4) {
+        for (size_t j = 0; j + TILE <= N_SPEED; j += TILE / 4) {
+            Diamond::Matrix<double> block = copyBlock(a, i, j, TILE, TILE);
+            sum += block[TILE - 1][TILE - 1];
+        }
+    }
+    timer.stop();
+    return std::make_pair(sum == sum, timer.getTime());
+}
+
+std::pair<bool, double> viewBlockTimer() {
+    Diamond::Matrix<double> a = randomMatrix(N_SPEED, N_SPEED);
+    double sum = 0;
+    timer.init();
+    for (size_t i = 0; i + TILE <= N_SPEED; i += TILE / 4) {
+        for (size_t j = 0; j + TILE <= N_SPEED; j += TILE / 4) {
+            Diamond::ConstMatrixView<double> block = a.SubMatrix(i, j, TILE, TILE);
+            sum += block[TILE - 1][TILE - 1];
+        }
+    }
+    timer.stop();
+    return std::make_pair(sum == sum, timer.getTime());
+}
+
+#ifdef __BENCHMARK
+static CheckerPair TEST_B[] = {
+    std::make_pair("naive i-j-k multiplication", naiveTimer),
+    std::make_pair("operator * (blocked kernel)", multiplyTimer),
+    std::make_pair("tiled multiplication through views", tiledTimer),
+    std::make_pair("block extraction by copy", copyBlockTimer),
+    std::make_pair("block extraction by view", viewBlockTimer),
+};
+#endif
+
+#define __CORRECT_TEST
+#ifdef __BENCHMARK
+#define __SPEED_TEST
+#else
+#define __OFFICAL
+#endif
+
+int main() {
+#ifndef __OFFICAL
+    puts("Matrix View CheckTool");
+#else
+    puts("Matrix View CheckTool Offical Version");
+#endif
+    puts("");
+#ifdef __CORRECT_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone A: Correctness Testing...");
+        int n = sizeof(TEST_A) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_A[i].first);
+            std::pair<bool, double> result = TEST_A[i].second();
+            if (result.first) {
+                puts("PASSED");
+            } else {
+                puts("FAILED");
+            }
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#ifdef __SPEED_TEST
+    puts("");
+#endif
+#endif
+
+#ifdef __SPEED_TEST
+    puts("---------------------------------------------------------------------------");
+    try{
+        puts("Test Zone B: Operation speed individually Testing...");
+        printf("Test Size: %d x %d Matrix\n", N_SPEED, N_SPEED);
+        int n = sizeof(TEST_B) / sizeof(CheckerPair);
+        for (int i = 0; i < n; i++) {
+            printf("Test %d: %-59s", i + 1, TEST_B[i].first);
+            std::pair<bool, double> result = TEST_B[i].second();
+#ifndef __OFFICAL
+            printf("%.3f\n", result.second);
+#else
+            puts("PASSED");
+#endif
+        }
+    } catch(...) {
+        puts("Unknown Error Occured");
+    }
+    puts("---------------------------------------------------------------------------");
+#endif
+    return 0;
+}